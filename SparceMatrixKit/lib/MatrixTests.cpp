@@ -3,6 +3,12 @@
 #include "Complex.h"
 #include "Vector.h"
 #include "Matrix.h"
+#include "Compressed.h"
+
+#include <filesystem>
+#include <fstream>
+#include <unordered_set>
+#include <thread>
 
 TEST(Matrix_TestSuite, Matrix_0)
 {
@@ -248,4 +254,1002 @@ TEST(Matrix_TestSuite, Matrix_5)
     delete mmm;
     EXPECT_THROW(pr_mmm[1], ProxyPointerError);
 
-}
\ No newline at end of file
+}
+
+TEST(Matrix_TestSuite, Matrix_6)
+{
+    /**
+     * Умножение разреженных прямоугольных матриц [map | unordered_map]
+     */
+    Matrix<std::map, Rational_number<int64_t>> a_1(3, 2);
+    a_1[std::make_pair(1, 1)] = Rational_number<int64_t>(2);
+    a_1[std::make_pair(3, 2)] = Rational_number<int64_t>(-1);
+
+    Matrix<std::map, Rational_number<int64_t>> b_1(2, 4);
+    b_1[std::make_pair(1, 2)] = Rational_number<int64_t>(3);
+    b_1[std::make_pair(1, 4)] = Rational_number<int64_t>(5);
+    b_1[std::make_pair(2, 2)] = Rational_number<int64_t>(7);
+
+    auto c_1 = a_1 * b_1;
+    EXPECT_EQ(c_1.shape(), std::make_pair(uint64_t(3), uint64_t(4)));
+    EXPECT_EQ(c_1.getData().size(), 3);
+    EXPECT_EQ(c_1(1, 2), Rational_number<int64_t>(6));
+    EXPECT_EQ(c_1(1, 4), Rational_number<int64_t>(10));
+    EXPECT_EQ(c_1(3, 2), Rational_number<int64_t>(-7));
+    EXPECT_EQ(c_1(2, 2), Rational_number<int64_t>());
+
+    Matrix<std::unordered_map, Rational_number<int64_t>> a_2(3, 2);
+    a_2[std::make_pair(1, 1)] = Rational_number<int64_t>(2);
+    a_2[std::make_pair(3, 2)] = Rational_number<int64_t>(-1);
+
+    Matrix<std::unordered_map, Rational_number<int64_t>> b_2(2, 4);
+    b_2[std::make_pair(1, 2)] = Rational_number<int64_t>(3);
+    b_2[std::make_pair(1, 4)] = Rational_number<int64_t>(5);
+    b_2[std::make_pair(2, 2)] = Rational_number<int64_t>(7);
+
+    auto c_2 = a_2 * b_2;
+    EXPECT_EQ(c_2.shape(), std::make_pair(uint64_t(3), uint64_t(4)));
+    EXPECT_EQ(c_2.getData().size(), 3);
+    EXPECT_EQ(c_2.to_string(), c_1.to_string());
+}
+
+TEST(Matrix_TestSuite, Matrix_7)
+{
+    /**
+     * Сжатое хранение (CSR/CSC): построение из map и unordered_map, доступ, умножение
+     */
+    auto m_1 = Matrix<std::map, Complex_number<double, int32_t>>::readFromFile("input/in_matrix_3");
+    auto m_2 = Matrix<std::unordered_map, Complex_number<double, int32_t>>::readFromFile("input/in_matrix_3");
+
+    Matrix<Compressed_storage, Complex_number<double, int32_t>> c_1(m_1);
+    Matrix<Compressed_storage, Complex_number<double, int32_t>> c_2(m_2, true);
+
+    EXPECT_EQ(c_1.to_string(), m_1.to_string());
+    EXPECT_EQ(c_2.to_string(), m_1.to_string());
+    EXPECT_EQ(c_1.nonZeros(), 7);
+    EXPECT_EQ(c_1.getColumnIndices(), c_2.getColumnIndices());
+    EXPECT_EQ(c_1(4, 3), (Complex_number<double, int32_t>(99, 320)));
+    EXPECT_THROW(c_1(7, 1), MatrixIndexError);
+
+    EXPECT_FALSE(c_1.hasColumnIndex());
+    EXPECT_TRUE(c_2.hasColumnIndex());
+    EXPECT_EQ(c_2.getColumnOffsets(), std::vector<uint64_t>({0, 3, 5, 7, 7}));
+    EXPECT_EQ(c_2.getRowIndices(), std::vector<uint64_t>({2, 4, 5, 3, 5, 4, 5}));
+
+    Matrix<std::map, Rational_number<int64_t>> a(2, 3);
+    a[std::make_pair(1, 1)] = Rational_number<int64_t>(2);
+    a[std::make_pair(1, 3)] = Rational_number<int64_t>(1);
+    a[std::make_pair(2, 2)] = Rational_number<int64_t>(-3);
+
+    Matrix<std::map, Rational_number<int64_t>> b(3, 2);
+    b[std::make_pair(1, 2)] = Rational_number<int64_t>(4);
+    b[std::make_pair(2, 1)] = Rational_number<int64_t>(5);
+    b[std::make_pair(3, 2)] = Rational_number<int64_t>(6);
+
+    Matrix<Compressed_storage, Rational_number<int64_t>> c_a(a);
+    Matrix<Compressed_storage, Rational_number<int64_t>> c_b(b);
+    EXPECT_EQ((c_a * c_b).to_string(), (a * b).to_string());
+
+    Vector<Rational_number<int64_t>> v(3);
+    v[1] = Rational_number<int64_t>(1);
+    v[3] = Rational_number<int64_t>(2);
+    EXPECT_EQ((c_a * v).to_string(), "4/1 0/1 ");
+}
+
+TEST(Matrix_TestSuite, Matrix_8)
+{
+    /**
+     * Сложение и вычитание разреженных матриц, хранятся только ненулевые элементы [map | unordered_map]
+     */
+    Matrix<std::map, Rational_number<int64_t>> a_1(1000, 1000);
+    a_1[std::make_pair(1, 1)] = Rational_number<int64_t>(2);
+    a_1[std::make_pair(500, 7)] = Rational_number<int64_t>(3);
+    Matrix<std::map, Rational_number<int64_t>> b_1(1000, 1000);
+    b_1[std::make_pair(500, 7)] = Rational_number<int64_t>(4);
+    b_1[std::make_pair(1000, 1000)] = Rational_number<int64_t>(5);
+
+    auto s_1 = a_1 + b_1;
+    EXPECT_EQ(s_1.getData().size(), 3);
+    EXPECT_EQ(s_1(500, 7), Rational_number<int64_t>(7));
+    EXPECT_EQ(s_1(1000, 1000), Rational_number<int64_t>(5));
+
+    auto d_1 = a_1 - b_1;
+    EXPECT_EQ(d_1.getData().size(), 3);
+    EXPECT_EQ(d_1(500, 7), Rational_number<int64_t>(-1));
+    EXPECT_EQ(d_1(1000, 1000), Rational_number<int64_t>(-5));
+
+    Matrix<std::unordered_map, Complex_number<double>> a_2(1000, 1000, 0.5);
+    a_2[std::make_pair(1, 1)] = Complex_number<double>(2, 1);
+    a_2[std::make_pair(500, 7)] = Complex_number<double>(3);
+    Matrix<std::unordered_map, Complex_number<double>> b_2(1000, 1000);
+    b_2[std::make_pair(500, 7)] = Complex_number<double>(3);
+    b_2[std::make_pair(1000, 1000)] = Complex_number<double>(0, 5);
+
+    auto d_2 = a_2 - b_2;
+    EXPECT_EQ(d_2.getData().size(), 2);
+    EXPECT_EQ(d_2(1, 1), Complex_number<double>(2, 1));
+    EXPECT_EQ(d_2(1000, 1000), Complex_number<double>(0, -5));
+    EXPECT_EQ((a_2 + b_2)(500, 7), Complex_number<double>(6));
+}
+
+TEST(Matrix_TestSuite, Matrix_9)
+{
+    /**
+     * Транспонирование по ненулевым элементам и ленивое транспонирование [map | unordered_map | CSR]
+     */
+    Matrix<std::map, Rational_number<int64_t>> a_1(2, 3);
+    a_1[std::make_pair(1, 1)] = Rational_number<int64_t>(2);
+    a_1[std::make_pair(1, 3)] = Rational_number<int64_t>(1);
+    a_1[std::make_pair(2, 2)] = Rational_number<int64_t>(-3);
+
+    Matrix<std::map, Rational_number<int64_t>> r_1(3, 2);
+    r_1[std::make_pair(1, 1)] = Rational_number<int64_t>(2);
+    r_1[std::make_pair(3, 1)] = Rational_number<int64_t>(1);
+    r_1[std::make_pair(2, 2)] = Rational_number<int64_t>(-3);
+
+    EXPECT_EQ((~a_1).shape(), r_1.shape());
+    EXPECT_EQ((~a_1).getData(), r_1.getData());
+
+    Matrix<std::unordered_map, Rational_number<int64_t>> a_2(2, 3);
+    a_2[std::make_pair(1, 1)] = Rational_number<int64_t>(2);
+    a_2[std::make_pair(1, 3)] = Rational_number<int64_t>(1);
+    a_2[std::make_pair(2, 2)] = Rational_number<int64_t>(-3);
+    EXPECT_EQ((~a_2).to_string(), r_1.to_string());
+
+    Matrix<Compressed_storage, Rational_number<int64_t>> a_3(a_1);
+    Matrix<Compressed_storage, Rational_number<int64_t>> a_4(a_1, true);
+    EXPECT_EQ((~a_3).to_string(), r_1.to_string());
+    EXPECT_EQ((~a_4).getColumnIndices(), (~a_3).getColumnIndices());
+
+    Matrix<std::map, Rational_number<int64_t>> b_1(2, 2);
+    b_1[std::make_pair(1, 2)] = Rational_number<int64_t>(4);
+    b_1[std::make_pair(2, 1)] = Rational_number<int64_t>(5);
+    Matrix<std::unordered_map, Rational_number<int64_t>> b_2(2, 2);
+    b_2[std::make_pair(1, 2)] = Rational_number<int64_t>(4);
+    b_2[std::make_pair(2, 1)] = Rational_number<int64_t>(5);
+    Matrix<Compressed_storage, Rational_number<int64_t>> b_3(b_1);
+
+    auto expected = (~a_1 * b_1).to_string();
+    EXPECT_EQ((a_1.transposed() * b_1).to_string(), expected);
+    EXPECT_EQ((a_2.transposed() * b_2).to_string(), expected);
+    EXPECT_EQ((a_3.transposed() * b_3).to_string(), expected);
+    EXPECT_EQ((a_4.transposed() * b_3).to_string(), expected);
+    EXPECT_EQ(a_1.transposed().materialize().to_string(), r_1.to_string());
+
+    Vector<Rational_number<int64_t>> v(2);
+    v[1] = Rational_number<int64_t>(1);
+    v[2] = Rational_number<int64_t>(2);
+    EXPECT_EQ((a_1.transposed() * v).to_string(), "2/1 -6/1 1/1 ");
+    EXPECT_EQ((a_2.transposed() * v).to_string(), "2/1 -6/1 1/1 ");
+    EXPECT_EQ((a_3.transposed() * v).to_string(), "2/1 -6/1 1/1 ");
+}
+
+TEST(Matrix_TestSuite, Matrix_10)
+{
+    /**
+     * Умножение прямоугольной матрицы на вектор, запись в готовый вектор, умножение вектора на матрицу
+     */
+    Matrix<std::map, Rational_number<int64_t>> a_1(2, 3);
+    a_1[std::make_pair(1, 1)] = Rational_number<int64_t>(2);
+    a_1[std::make_pair(1, 3)] = Rational_number<int64_t>(1);
+    a_1[std::make_pair(2, 2)] = Rational_number<int64_t>(-3);
+
+    Matrix<std::unordered_map, Rational_number<int64_t>> a_2(2, 3);
+    a_2[std::make_pair(1, 1)] = Rational_number<int64_t>(2);
+    a_2[std::make_pair(1, 3)] = Rational_number<int64_t>(1);
+    a_2[std::make_pair(2, 2)] = Rational_number<int64_t>(-3);
+
+    Vector<Rational_number<int64_t>> x(3);
+    x[1] = Rational_number<int64_t>(1);
+    x[3] = Rational_number<int64_t>(2);
+
+    EXPECT_EQ((a_1 * x).to_string(), "4/1 0/1 ");
+    EXPECT_EQ((a_2 * x).to_string(), "4/1 0/1 ");
+
+    Vector<Rational_number<int64_t>> y(7);
+    y[5] = Rational_number<int64_t>(9);
+    a_1.multiply(x, y);
+    EXPECT_EQ(y.getLen(), 2);
+    EXPECT_EQ(y.getData().count(5), 0);
+    EXPECT_EQ(y.to_string(), "4/1 0/1 ");
+
+    a_2.multiply(x, y);
+    EXPECT_EQ(y.to_string(), "4/1 0/1 ");
+
+    Vector<Rational_number<int64_t>> z(2);
+    z[2] = Rational_number<int64_t>(1);
+    EXPECT_EQ((z * a_1).to_string(), "0/1 -3/1 0/1 ");
+    EXPECT_EQ((z * a_2).to_string(), "0/1 -3/1 0/1 ");
+    EXPECT_THROW(x * a_1, MatrixShapeError);
+}
+
+TEST(Matrix_TestSuite, Matrix_11)
+{
+    /**
+     * Параллельное умножение матрицы на вектор (в том числе в существующий вектор) и матриц: результат не зависит от числа потоков
+     */
+    Matrix<std::map, Rational_number<int64_t>> a_1(40, 30);
+    Matrix<std::unordered_map, Rational_number<int64_t>> a_2(40, 30);
+    Vector<Rational_number<int64_t>> x(30);
+    for (int i = 1; i <= 40; ++i)
+        for (int j = 1; j <= 30; ++j)
+            if ((i * 7 + j * 3) % 5 == 0 || (i < 4 && j % 2 == 0))
+            {
+                a_1[std::make_pair(i, j)] = Rational_number<int64_t>(i - j);
+                a_2[std::make_pair(i, j)] = Rational_number<int64_t>(i - j);
+            }
+    for (int j = 1; j <= 30; j += 3)
+        x[j] = Rational_number<int64_t>(j);
+
+    Matrix<std::map, Rational_number<int64_t>> b = ~a_1;
+    Matrix<Compressed_storage, Rational_number<int64_t>> c(a_1);
+
+    for (unsigned threads : {1u, 3u, 8u, 64u})
+    {
+        Parallel_policy policy(threads);
+        EXPECT_EQ(a_1.multiply(x, policy).to_string(), (a_1 * x).to_string());
+        EXPECT_EQ(a_2.multiply(x, policy).to_string(), (a_1 * x).to_string());
+        EXPECT_EQ(c.multiply(x, policy).to_string(), (a_1 * x).to_string());
+        EXPECT_EQ(a_1.multiply(b, policy).to_string(), (a_1 * b).to_string());
+        EXPECT_EQ(a_2.multiply(~a_2, policy).to_string(), (a_1 * b).to_string());
+        EXPECT_EQ(c.multiply(Matrix<Compressed_storage, Rational_number<int64_t>>(b), policy).to_string(), (a_1 * b).to_string());
+
+        Vector<Rational_number<int64_t>> y_1(40), y_2(a_1 * x);
+        y_2.toDense();
+        a_1.multiply(x, y_1, policy);
+        a_2.multiply(x, y_2, policy);
+        EXPECT_EQ(y_1.to_string(), (a_1 * x).to_string());
+        EXPECT_EQ(y_2.to_string(), (a_1 * x).to_string());
+    }
+    EXPECT_THROW(a_1.multiply(a_1, Parallel_policy(2)), MatrixShapeError);
+
+    EXPECT_EQ(partitionByWork({0, 4, 4, 6, 10}, 2), std::vector<uint64_t>({0, 3, 4}));
+    EXPECT_EQ(partitionByWork({0, 0, 0}, 4), std::vector<uint64_t>({0, 2}));
+}
+
+TEST(Matrix_TestSuite, Matrix_12)
+{
+    /**
+     * Точное произведение матриц с числителями и знаменателями, не помещающимися в int64_t
+     */
+    auto a_1 = Matrix<std::map, Rational_number<int64_t>>::readFromFile("input/in_matrix_1");
+    auto a_2 = Matrix<std::map, Rational_number<Big_integer>>::readFromFile("input/in_matrix_1");
+    EXPECT_THROW(a_1 * a_1, RationalOverflowError<int64_t>);
+
+    Matrix<std::map, Rational_number<Big_integer>> b = a_2 * a_2;
+    EXPECT_EQ(b[std::make_pair(1, 1)].to_string(), "325183468618760372107059659/22932340899479809272090");
+    EXPECT_EQ(a_2.multiply(a_2, Parallel_policy(4)).to_string(), b.to_string());
+}
+
+TEST(Matrix_TestSuite, Matrix_13)
+{
+    /**
+     * Чтение с файла со статистикой: комментарии в конце строк, количество элементов и размер файла
+     */
+    Read_stats stats;
+    auto m_1 = Matrix<std::map, Rational_number<int64_t>>::readFromFile("input/in_matrix_1", &stats);
+    EXPECT_EQ(stats.entries, 2420);
+    EXPECT_EQ(stats.bytes, 37966);
+    EXPECT_GE(stats.throughput(), 0);
+    EXPECT_EQ(m_1.at(48, 1), Rational_number<int64_t>(179, 551));
+    EXPECT_EQ(m_1.at(32, 1), Rational_number<int64_t>(3));
+
+    auto m_2 = Matrix<std::unordered_map, Rational_number<int64_t>>::readFromFile("input/in_matrix_1");
+    EXPECT_EQ(m_2.to_string(), m_1.to_string());
+
+    std::string filename = "input/in_vector_1";
+    auto v = Vector<Complex_number<double, double>>::readFromFile(filename, &stats);
+    EXPECT_EQ(stats.entries, 6);
+    EXPECT_EQ(v[7], (Complex_number<double, double>(39, 777)));
+    EXPECT_EQ(v[17], (Complex_number<double, double>(729, 975)));
+
+    EXPECT_THROW((Matrix<std::map, Rational_number<int64_t>>::readFromFile("input/not_exists")), MatrixReadFromFileError);
+}
+
+TEST(Matrix_TestSuite, Matrix_14)
+{
+    /**
+     * Параллельное чтение с файла: результат совпадает с последовательным при любом числе потоков
+     */
+    auto m_1 = Matrix<std::map, Rational_number<int64_t>>::readFromFile("input/in_matrix_1");
+    auto m_2 = Matrix<std::map, Complex_number<double, int32_t>>::readFromFile("input/in_matrix_3");
+    Matrix<Compressed_storage, Rational_number<int64_t>> c_1(m_1);
+
+    for (unsigned threads : {1u, 2u, 5u, 64u})
+    {
+        Parallel_policy policy(threads);
+        Read_stats stats;
+        EXPECT_EQ((Matrix<std::map, Rational_number<int64_t>>::readFromFile("input/in_matrix_1", policy, &stats)).to_string(), m_1.to_string());
+        EXPECT_EQ(stats.entries, 2420);
+        EXPECT_EQ((Matrix<std::unordered_map, Rational_number<int64_t>>::readFromFile("input/in_matrix_1", policy)).to_string(), m_1.to_string());
+        EXPECT_EQ((Matrix<std::map, Complex_number<double, int32_t>>::readFromFile("input/in_matrix_3", policy)).to_string(), m_2.to_string());
+
+        auto c_2 = Matrix<Compressed_storage, Rational_number<int64_t>>::readFromFile("input/in_matrix_1", policy);
+        EXPECT_EQ(c_2.getRowOffsets(), c_1.getRowOffsets());
+        EXPECT_EQ(c_2.getColumnIndices(), c_1.getColumnIndices());
+        EXPECT_EQ(c_2.to_string(), c_1.to_string());
+    }
+    EXPECT_THROW((Matrix<std::map, Rational_number<int8_t>>::readFromFile("input/in_matrix_1", Parallel_policy(4))), RationalOverflowError<int64_t>);
+    EXPECT_THROW((Matrix<Compressed_storage, Rational_number<int64_t>>::readFromFile("input/in_vector_2")), MatrixReadFromFileError);
+
+    const char text[] = "1 1 <1>\n2 2 <2>\n3 3 <3>\n";
+    std::vector<const char *> bounds = splitLines(text, text + sizeof(text) - 1, 8);
+    EXPECT_EQ(bounds.front(), text);
+    EXPECT_EQ(bounds.back(), text + sizeof(text) - 1);
+    for (size_t p = 1; p + 1 < bounds.size(); ++p)
+        EXPECT_EQ(bounds[p][-1], '\n');
+}
+
+TEST(Matrix_TestSuite, Matrix_15)
+{
+    /**
+     * Двоичный формат: запись, чтение в каждый контейнер и отображение в память без разбора
+     */
+    std::string path = (std::filesystem::temp_directory_path() / "smk_matrix_15.bin").string();
+    auto m_1 = Matrix<std::map, Rational_number<int64_t>>::readFromFile("input/in_matrix_1");
+    m_1.writeToBinaryFile(std::string(path));
+
+    EXPECT_EQ((Matrix<std::map, Rational_number<int64_t>>::readFromBinaryFile(std::string(path)).to_string()), m_1.to_string());
+    EXPECT_EQ((Matrix<std::unordered_map, Rational_number<int64_t>>::readFromBinaryFile(std::string(path)).to_string()), m_1.to_string());
+
+    Matrix<Compressed_storage, Rational_number<int64_t>> c_1(m_1);
+    auto c_2 = Matrix<Compressed_storage, Rational_number<int64_t>>::readFromBinaryFile(std::string(path));
+    EXPECT_EQ(c_2.getRowOffsets(), c_1.getRowOffsets());
+    EXPECT_EQ(c_2.getColumnIndices(), c_1.getColumnIndices());
+
+    auto view = Matrix<Mapped_storage, Rational_number<int64_t>>::readFromBinaryFile(std::string(path));
+    EXPECT_EQ(view.shape(), m_1.shape());
+    EXPECT_EQ(view.nonZeros(), m_1.getData().size());
+    EXPECT_EQ(view.at(48, 1), Rational_number<int64_t>(179, 551));
+    EXPECT_EQ(view.at(1, 1), Rational_number<int64_t>());
+    EXPECT_THROW(view(0, 1), MatrixIndexError);
+    EXPECT_EQ(view.to_string(), m_1.to_string());
+
+    Vector<Rational_number<int64_t>> x(100);
+    for (int j = 1; j <= 100; j += 7)
+        x[j] = Rational_number<int64_t>(j, 3);
+    EXPECT_EQ((view * x).to_string(), (m_1 * x).to_string());
+
+    Matrix<std::unordered_map, Complex_number<double, int32_t>> m_2 = Matrix<std::unordered_map, Complex_number<double, int32_t>>::readFromFile("input/in_matrix_3");
+    m_2.writeToBinaryFile(std::string(path));
+    EXPECT_EQ((Matrix<std::map, Complex_number<double, int32_t>>::readFromBinaryFile(std::string(path)).to_string()), m_2.to_string());
+    EXPECT_THROW((Matrix<std::map, Complex_number<double, double>>::readFromBinaryFile(std::string(path))), MatrixReadFromFileError);
+    EXPECT_THROW((Matrix<Mapped_storage, Rational_number<int64_t>>::readFromBinaryFile(std::string(path))), MatrixReadFromFileError);
+    EXPECT_THROW((Matrix<Mapped_storage, Rational_number<int64_t>>::readFromBinaryFile("input/in_matrix_1")), MatrixReadFromFileError);
+
+    std::string vector_path = (std::filesystem::temp_directory_path() / "smk_vector_15.bin").string();
+    x.writeToBinaryFile(vector_path);
+    EXPECT_EQ(Vector<Rational_number<int64_t>>::readFromBinaryFile(vector_path).to_string(), x.to_string());
+    EXPECT_THROW(Vector<Rational_number<int64_t>>::readFromBinaryFile(path), VectorReadFromFileError);
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(vector_path);
+}
+
+TEST(Matrix_TestSuite, Matrix_16)
+{
+    /**
+     * Потоковая запись в текстовом формате: только ненулевые элементы, чтение обратно дает ту же матрицу
+     */
+    Matrix<std::map, Rational_number<int64_t>> a(2, 3);
+    a[std::make_pair(1, 2)] = Rational_number<int64_t>(1, 2);
+    a[std::make_pair(2, 3)] = Rational_number<int64_t>(-5);
+    std::ostringstream out_1;
+    a.writeToFile(out_1);
+    EXPECT_EQ(out_1.str(), "matrix rational 2 3\n1 2 <1 / 2>\n2 3 <-5>\n");
+
+    std::ostringstream out_2;
+    Matrix<Compressed_storage, Rational_number<int64_t>>(a).writeToFile(out_2);
+    EXPECT_EQ(out_2.str(), out_1.str());
+
+    Matrix<std::unordered_map, Complex_number<double, double>> b(1, 2);
+    b[std::make_pair(1, 1)] = Complex_number<double, double>(1.5, -2);
+    b[std::make_pair(1, 2)] = Complex_number<double, double>(0.1, 0);
+    std::ostringstream out_3;
+    b.writeToFile(out_3);
+    EXPECT_NE(out_3.str().find("matrix complex float float 1 2\n"), std::string::npos);
+    EXPECT_NE(out_3.str().find("1 1 (1.5 , -2)\n"), std::string::npos);
+    EXPECT_NE(out_3.str().find("1 2 (0.1)\n"), std::string::npos);
+
+    std::string path = (std::filesystem::temp_directory_path() / "smk_matrix_16.txt").string();
+    auto m_1 = Matrix<std::map, Rational_number<int64_t>>::readFromFile("input/in_matrix_1");
+    m_1.writeToFile(std::string(path));
+    EXPECT_EQ((Matrix<std::map, Rational_number<int64_t>>::readFromFile(std::string(path))).to_string(), m_1.to_string());
+
+    auto m_2 = Matrix<std::unordered_map, Complex_number<double, int32_t>>::readFromFile("input/in_matrix_3");
+    m_2.writeToFile(std::string(path));
+    EXPECT_EQ((Matrix<std::unordered_map, Complex_number<double, int32_t>>::readFromFile(std::string(path))).to_string(), m_2.to_string());
+
+    std::string vector_in = "input/in_vector_1";
+    auto v = Vector<Complex_number<double, double>>::readFromFile(vector_in);
+    v.writeToFile(path);
+    EXPECT_EQ((Vector<Complex_number<double, double>>::readFromFile(path).to_string()), v.to_string());
+
+    EXPECT_THROW(a.writeToFile(std::string("/nonexistent_dir/matrix.txt")), MatrixWriteToFileError);
+    std::filesystem::remove(path);
+}
+
+TEST(Matrix_TestSuite, Matrix_17)
+{
+    /**
+     * Построение из координатных массивов: повторы суммируются, суммы меньше eps не хранятся [map | unordered_map | CSR]
+     */
+    std::vector<uint64_t> rows{2, 1, 2, 3, 1, 3};
+    std::vector<uint64_t> columns{2, 3, 2, 1, 3, 1};
+    std::vector<Rational_number<int64_t>> values{Rational_number<int64_t>(1, 2), Rational_number<int64_t>(4), Rational_number<int64_t>(1, 3),
+                                                 Rational_number<int64_t>(7), Rational_number<int64_t>(-4), Rational_number<int64_t>()};
+
+    Matrix<std::map, Rational_number<int64_t>> expected(3, 3);
+    expected[std::make_pair(2, 2)] = Rational_number<int64_t>(5, 6);
+    expected[std::make_pair(3, 1)] = Rational_number<int64_t>(7);
+
+    Matrix<std::map, Rational_number<int64_t>> m_1(3, 3, rows, columns, values);
+    Matrix<std::unordered_map, Rational_number<int64_t>> m_2(3, 3, rows, columns, values);
+    Matrix<Compressed_storage, Rational_number<int64_t>> m_3(3, 3, rows, columns, values, 1e-9);
+    EXPECT_EQ(m_1.to_string(), expected.to_string());
+    EXPECT_EQ(m_2.to_string(), expected.to_string());
+    EXPECT_EQ(m_3.to_string(), expected.to_string());
+    EXPECT_EQ(m_3.nonZeros(), 2);
+    EXPECT_EQ((Matrix<Compressed_storage, Rational_number<int64_t>>(3, 3, rows, columns, values)).nonZeros(), 3);
+
+    std::vector<Complex_number<double, double>> complex_values{Complex_number<double, double>(1, 1), Complex_number<double, double>(0.001, 0)};
+    std::vector<uint64_t> complex_rows{1, 2}, complex_columns{1, 1};
+    Matrix<std::map, Complex_number<double, double>> m_4(2, 1, complex_rows, complex_columns, complex_values, 0.01);
+    Matrix<std::map, Complex_number<double, double>> expected_complex(2, 1, 0.01);
+    expected_complex[std::make_pair(1, 1)] = Complex_number<double, double>(1, 1);
+    EXPECT_EQ(m_4.to_string(), expected_complex.to_string());
+
+    std::vector<uint64_t> bad_rows{1, 4};
+    EXPECT_THROW((Matrix<std::map, Rational_number<int64_t>>(3, 3, bad_rows, std::vector<uint64_t>{1, 1}, std::vector<Rational_number<int64_t>>(2))), MatrixIndexError);
+    EXPECT_THROW((Matrix<Compressed_storage, Rational_number<int64_t>>(3, 3, rows, std::vector<uint64_t>{1}, values)), MatrixShapeError);
+}
+
+TEST(Matrix_TestSuite, Matrix_18)
+{
+    /**
+     * Хэш координат различает диагонали в младших битах; хэш-таблица с открытой адресацией
+     */
+    std::unordered_set<uint64_t> buckets;
+    for (uint64_t i = 1; i <= 1024; ++i)
+        buckets.insert(PairHash{}(std::make_pair(i, i)) & 1023);
+    EXPECT_GT(buckets.size(), 512);
+
+    Flat_hash_map<std::pair<uint64_t, uint64_t>, Rational_number<int64_t>, PairHash> map;
+    for (uint64_t i = 1; i <= 1000; ++i)
+        map[std::make_pair(i, i % 7 + 1)] += Rational_number<int64_t>(int64_t(i));
+    EXPECT_EQ(map.size(), 1000);
+    EXPECT_FALSE(map.emplace(std::make_pair(5, 6), Rational_number<int64_t>(1)).second);
+    EXPECT_EQ(map.find(std::make_pair(5, 6))->second, Rational_number<int64_t>(5));
+    EXPECT_TRUE(map.find(std::make_pair(5, 5)) == map.end());
+    EXPECT_EQ(map.count(std::make_pair(1000, 7)), 1);
+
+    int64_t sum = 0;
+    for (auto &entry : map)
+        sum += entry.first.first;
+    EXPECT_EQ(sum, 500500);
+
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_TRUE(map.begin() == map.end());
+}
+
+TEST(Matrix_TestSuite, Matrix_19)
+{
+    /**
+     * Упакованный ключ: порядок как у пары (строка, столбец), проверка диапазона координат
+     */
+    Matrix_packed_key a(std::make_pair(2, 7)), b(std::make_pair(3, 1)), c(std::make_pair(uint64_t(3), uint64_t(UINT32_MAX)));
+    EXPECT_EQ(a.packed(), (uint64_t(2) << 32) | 7);
+    EXPECT_EQ(a.first, 2);
+    EXPECT_EQ(a.second, 7);
+    EXPECT_TRUE(a < b);
+    EXPECT_TRUE(b < c);
+    EXPECT_FALSE(c < b);
+    EXPECT_TRUE(a == Matrix_packed_key(std::make_pair(2, 7)));
+    EXPECT_TRUE(a != b);
+    EXPECT_NE(PairHash{}(a), PairHash{}(b));
+
+    EXPECT_THROW(Matrix_packed_key(std::make_pair(uint64_t(1) << 32, uint64_t(1))), MatrixIndexError);
+    EXPECT_THROW(Matrix_packed_key(std::make_pair(uint64_t(1), uint64_t(1) << 40)), MatrixIndexError);
+
+    std::map<Matrix_packed_key, Rational_number<int64_t>> ordered;
+    ordered[std::make_pair(2, 1)] = Rational_number<int64_t>(1);
+    ordered[std::make_pair(1, 5)] = Rational_number<int64_t>(2);
+    ordered[std::make_pair(1, 2)] = Rational_number<int64_t>(3);
+    std::vector<uint64_t> columns;
+    for (auto &entry : ordered)
+        columns.push_back(entry.first.second);
+    EXPECT_EQ(columns, (std::vector<uint64_t>{2, 5, 1}));
+
+    if (std::is_same_v<Matrix_key, Matrix_packed_key>)
+        EXPECT_THROW((Matrix<std::map, Rational_number<int64_t>>(uint64_t(1) << 33, 2)), MatrixShapeError);
+    else
+        EXPECT_NO_THROW((Matrix<std::map, Rational_number<int64_t>>(uint64_t(1) << 33, 2)));
+}
+
+TEST(Matrix_TestSuite, Matrix_20)
+{
+    /**
+     * zeros и ones не хранят элементы: ones задается значением fill и участвует в операциях без материализации
+     */
+    using R = Rational_number<int64_t>;
+    auto zeros = Matrix<std::map, R>::zeros(100000, 100000);
+    auto ones = Matrix<std::unordered_map, R>::ones(100000, 100000);
+    EXPECT_EQ(zeros.getData().size(), 0);
+    EXPECT_EQ(ones.getData().size(), 0);
+    EXPECT_EQ(ones(7, 99999), R(1));
+    EXPECT_EQ(zeros(7, 99999), R());
+
+    Vector<R> x(100000);
+    x[3] = R(2);
+    x[50000] = R(1, 2);
+    Vector<R> y = ones * x;
+    EXPECT_EQ(y[1], R(5, 2));
+    EXPECT_EQ(y[100000], R(5, 2));
+
+    ones.set(1, 3, R());
+    EXPECT_EQ(ones.getData().size(), 1);
+    y = ones * x;
+    EXPECT_EQ(y[1], R(1, 2));
+    EXPECT_EQ(y[2], R(5, 2));
+    ones.set(3, 4, R());
+    EXPECT_EQ((ones.multiplyTransposed(x))[3], R(5, 2));
+    EXPECT_EQ((ones.multiplyTransposed(x))[4], R(1, 2));
+
+    auto a = Matrix<std::map, R>::full(2, 3, R(2));
+    a[std::make_pair(1, 2)] += R(1);
+    Matrix<std::map, R> b(2, 3);
+    b[std::make_pair(2, 1)] = R(-1);
+    Matrix<std::map, R> expected(2, 3);
+    for (uint64_t i = 1; i <= 2; ++i)
+        for (uint64_t j = 1; j <= 3; ++j)
+            expected[std::make_pair(i, j)] = R(2);
+    expected[std::make_pair(1, 2)] = R(3);
+    expected[std::make_pair(2, 1)] = R(1);
+    auto sum = a + b;
+    EXPECT_EQ(sum.to_string(), expected.to_string());
+    EXPECT_EQ(sum.getData().size(), 2);
+    EXPECT_EQ((-sum).to_string(), (-expected).to_string());
+    EXPECT_EQ((~sum).to_string(), (~expected).to_string());
+    EXPECT_EQ((sum * ~sum).to_string(), (expected * ~expected).to_string());
+    EXPECT_EQ((Matrix<Compressed_storage, R>(sum)).to_string(), expected.to_string());
+
+    // fill записывается в заголовок, в файл попадают только хранимые элементы
+    std::ostringstream out;
+    sum.writeToFile(out);
+    EXPECT_EQ(out.str(), "matrix rational 2 3 <2>\n1 2 <3>\n2 1 <1>\n");
+}
+
+TEST(Matrix_TestSuite, Matrix_21)
+{
+    /**
+     * Строки и столбцы без перебора всех позиций; индекс столбцов обновляется после изменения матрицы [map | unordered_map]
+     */
+    using R = Rational_number<int64_t>;
+    Matrix<std::map, R> m_1(4, 5);
+    m_1[std::make_pair(2, 5)] = R(1, 2);
+    m_1[std::make_pair(2, 1)] = R(3);
+    m_1[std::make_pair(4, 1)] = R(-1);
+    Matrix<std::unordered_map, R> m_2(4, 5);
+    m_2[std::make_pair(2, 5)] = R(1, 2);
+    m_2[std::make_pair(2, 1)] = R(3);
+    m_2[std::make_pair(4, 1)] = R(-1);
+
+    Vector<R> row(5), column(4);
+    row[1] = R(3);
+    row[5] = R(1, 2);
+    column[2] = R(3);
+    column[4] = R(-1);
+    EXPECT_EQ(m_1.getRow(2), row);
+    EXPECT_EQ(m_2.getRow(2), row);
+    EXPECT_EQ(m_1.getColumn(1), column);
+    EXPECT_EQ(m_2.getColumn(1), column);
+    EXPECT_EQ(m_1[Matrix_row_coord(2)].to_string(), "3/1 0/1 0/1 0/1 1/2 ");
+    EXPECT_EQ(m_2[Matrix_column_coord(1)].to_string(), "0/1\n3/1\n0/1\n-1/1\n");
+
+    m_1.set(3, 1, R(7));
+    m_2[std::make_pair(3, 1)] = R(7);
+    column[3] = R(7);
+    EXPECT_EQ(m_1.getColumn(1), column);
+    EXPECT_EQ(m_2[Matrix_column_coord(1)].create_vector(), column);
+    EXPECT_EQ(m_2.getColumn(3), Vector<R>(4));
+    EXPECT_THROW(m_1.getRow(5), MatrixIndexError);
+    EXPECT_THROW(m_2.getColumn(0), MatrixIndexError);
+
+    auto ones = Matrix<std::map, R>::ones(2, 3);
+    ones.set(1, 2, R(5));
+    EXPECT_EQ(ones[Matrix_row_coord(1)].to_string(), "1/1 5/1 1/1 ");
+    EXPECT_EQ(ones.getColumn(2).to_string(), "5/1 1/1 ");
+}
+
+TEST(Matrix_TestSuite, Matrix_22)
+{
+    /**
+     * Копия разделяет хранилище с исходной матрицей до первого изменения [map | unordered_map]
+     */
+    using R = Rational_number<int64_t>;
+    Matrix<std::map, R> m_1(3, 4);
+    m_1.set(1, 2, R(1, 2));
+    m_1.set(3, 4, R(5));
+    Matrix<std::unordered_map, R> m_2(3, 4);
+    m_2.set(1, 2, R(1, 2));
+    m_2.set(3, 4, R(5));
+
+    Matrix<std::map, R> c_1(m_1);
+    Matrix<std::unordered_map, R> c_2 = m_2;
+    EXPECT_EQ(&c_1.getData(), &m_1.getData());
+    EXPECT_EQ(&c_2.getData(), &m_2.getData());
+    EXPECT_EQ(c_1.shape(), std::make_pair(uint64_t(3), uint64_t(4)));
+    EXPECT_EQ(c_2.shape(), std::make_pair(uint64_t(3), uint64_t(4)));
+
+    c_1.set(2, 2, R(7));
+    c_2[std::make_pair(1, 2)] = R(-1);
+    EXPECT_NE(&c_1.getData(), &m_1.getData());
+    EXPECT_NE(&c_2.getData(), &m_2.getData());
+    EXPECT_EQ(m_1.getData().size(), 2);
+    EXPECT_EQ(c_1(2, 2), R(7));
+    EXPECT_EQ(m_2(1, 2), R(1, 2));
+    EXPECT_EQ(c_2(1, 2), R(-1));
+
+    Matrix<std::map, R> a_1;
+    a_1 = c_1;
+    EXPECT_EQ(&a_1.getData(), &c_1.getData());
+    a_1 = -a_1;
+    EXPECT_EQ(c_1(3, 4), R(5));
+    EXPECT_EQ(a_1(3, 4), R(-5));
+}
+
+TEST(Matrix_TestSuite, Matrix_23)
+{
+    /**
+     * Составные операторы += -= *= и умножение на число изменяют матрицу на месте [map | unordered_map]
+     */
+    using R = Rational_number<int64_t>;
+    Matrix<std::map, R> m_1(3, 3, 1e-9);
+    m_1.set(1, 1, R(1));
+    m_1.set(2, 3, R(2));
+    Matrix<std::unordered_map, R> m_2(3, 3, 1e-9);
+    m_2.set(1, 1, R(1));
+    m_2.set(2, 3, R(2));
+    Matrix<std::map, R> d_1(3, 3);
+    d_1.set(1, 1, R(-1));
+    d_1.set(3, 2, R(1, 2));
+    Matrix<std::unordered_map, R> d_2(3, 3);
+    d_2.set(1, 1, R(-1));
+    d_2.set(3, 2, R(1, 2));
+
+    auto expected = (m_1 + d_1).to_string();
+    m_1 += d_1;
+    m_2 += d_2;
+    EXPECT_EQ(m_1.to_string(), expected);
+    EXPECT_EQ(m_2.to_string(), expected);
+    EXPECT_EQ(m_1.getData().size(), 2);
+    EXPECT_EQ(m_2.getData().size(), 2);
+
+    m_1 -= m_1;
+    m_2 *= R();
+    EXPECT_EQ(m_1.getData().size(), 0);
+    EXPECT_EQ(m_2.getData().size(), 0);
+
+    m_1 -= Matrix<std::map, R>::ones(3, 3);
+    m_1 *= R(2);
+    m_2 += d_2 * R(4);
+    EXPECT_EQ(m_1(2, 2), R(-2));
+    EXPECT_EQ(m_1.getData().size(), 0);
+    EXPECT_EQ(m_2(3, 2), R(2));
+    EXPECT_EQ(m_2(1, 1), R(-4));
+    EXPECT_EQ(d_2(1, 1), R(-1));
+
+    Matrix<std::unordered_map, R> i_2(3, 3);
+    for (uint64_t i = 1; i <= 3; ++i)
+        i_2.set(i, i, R(1));
+    m_2 *= i_2;
+    EXPECT_EQ(m_2(3, 2), R(2));
+    EXPECT_THROW((m_2 += Matrix<std::unordered_map, R>(2, 3)), MatrixShapeError);
+}
+
+TEST(Matrix_TestSuite, Matrix_24)
+{
+    /**
+     * Блоки, строки и столбцы как представления без копирования: обход, умножение на вектор,
+     * сложение и умножение блоков, удаление исходной матрицы [map | unordered_map]
+     */
+    using R = Rational_number<int64_t>;
+    Matrix<std::map, R> m_1(4, 5);
+    Matrix<std::unordered_map, R> m_2(4, 5, 1e-9);
+    for (uint64_t i = 1; i <= 4; ++i)
+        for (uint64_t j = 1; j <= 5; ++j)
+            if ((i + j) % 2 == 0)
+            {
+                m_1.set(i, j, R(int64_t(10 * i + j)));
+                m_2.set(i, j, R(int64_t(10 * i + j)));
+            }
+
+    auto b_1 = m_1[Matrix_coords(2, 2, 3, 4)];
+    auto b_2 = m_2[Matrix_coords(2, 2, 3, 4)];
+    EXPECT_EQ(b_1.shape(), std::make_pair(uint64_t(2), uint64_t(3)));
+    EXPECT_EQ(b_1.to_string(), b_2.to_string());
+    EXPECT_EQ(b_1.at(1, 1), R(22));
+    EXPECT_EQ(b_2.at(2, 2), R(33));
+
+    std::vector<std::pair<uint64_t, uint64_t>> visited;
+    b_1.forEach([&visited](uint64_t row, uint64_t column, const R &)
+                { visited.emplace_back(row, column); });
+    std::vector<std::pair<uint64_t, uint64_t>> expected = {{1, 1}, {1, 3}, {2, 2}};
+    EXPECT_EQ(visited, expected);
+    visited.clear();
+    b_2.forEach([&visited](uint64_t row, uint64_t column, const R &)
+                { visited.emplace_back(row, column); });
+    EXPECT_EQ(visited, expected);
+
+    Vector<R> x(3);
+    x[1] = R(1);
+    x[2] = R(2);
+    x[3] = R(3);
+    Vector<R> y_1 = b_1 * x;
+    Vector<R> y_2 = b_2 * x;
+    EXPECT_EQ(y_1, b_1.materialize() * x);
+    EXPECT_EQ(y_2, y_1);
+    EXPECT_EQ(y_1[1], R(22 + 3 * 24));
+    EXPECT_EQ(y_1[2], R(2 * 33));
+    EXPECT_THROW(b_1 * Vector<R>(2), MatrixShapeError);
+
+    auto sum = b_1 + m_1[Matrix_coords(1, 1, 2, 3)];
+    EXPECT_EQ(sum(1, 1), R(22 + 11));
+    EXPECT_EQ(sum(2, 2), R(33 + 22));
+    EXPECT_EQ((b_2 - b_2).getData().size(), 0);
+    auto product = m_2[Matrix_column_coord(2)] * m_2[Matrix_row_coord(2)];
+    EXPECT_EQ(product.shape(), std::make_pair(uint64_t(4), uint64_t(5)));
+    EXPECT_EQ(product(4, 4), R(42 * 24));
+    EXPECT_EQ(product(3, 4), R());
+    EXPECT_THROW(b_1 + m_1[Matrix_row_coord(1)], MatrixShapeError);
+
+    m_1.set(2, 2, R(-1));
+    EXPECT_EQ(b_1.at(1, 1), R(-1));
+
+    auto m_3 = new Matrix<std::map, R>(m_1);
+    auto b_3 = (*m_3)[Matrix_coords(1, 1, 2, 2)];
+    delete m_3;
+    EXPECT_THROW(b_3.at(1, 1), ProxyPointerError);
+    EXPECT_THROW(Vector<R>(b_3 * Vector<R>(2)), ProxyPointerError);
+    EXPECT_EQ(b_1.at(1, 1), R(-1));
+}
+
+TEST(Matrix_TestSuite, Matrix_25)
+{
+    /**
+     * Одновременное чтение столбцов и строк одной матрицы из нескольких потоков (индекс строится один раз) [map | unordered_map]
+     */
+    using R = Rational_number<int64_t>;
+    Matrix<std::map, R> m_1(200, 200);
+    Matrix<std::unordered_map, R> m_2(200, 200);
+    for (uint64_t i = 1; i <= 200; ++i)
+        for (uint64_t j = i % 7 + 1; j <= 200; j += 7)
+        {
+            m_1.set(i, j, R(int64_t(i + j)));
+            m_2.set(i, j, R(int64_t(i + j)));
+        }
+
+    for (int round = 0; round < 3; ++round)
+    {
+        std::vector<std::string> columns(8), rows(8);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 8; ++t)
+            threads.emplace_back([&, t]
+                                 {
+                columns[t] = m_1.getColumn(5 + t % 2).to_string() + m_2.getColumn(5 + t % 2).to_string();
+                rows[t] = m_2.getRow(9 + t % 2).to_string(); });
+        for (auto &thread : threads)
+            thread.join();
+
+        for (int t = 0; t < 8; ++t)
+        {
+            EXPECT_EQ(columns[t], m_1.getColumn(5 + t % 2).to_string() + m_1.getColumn(5 + t % 2).to_string());
+            EXPECT_EQ(rows[t], m_1.getRow(9 + t % 2).to_string());
+        }
+        m_1.set(1, 5, R(int64_t(round + 1)));
+        m_2.set(1, 5, R(int64_t(round + 1)));
+    }
+}
+
+TEST(Matrix_TestSuite, Matrix_26)
+{
+    /**
+     * Двоичный формат: файлы с координатами вне матрицы или с нарушенным порядком элементов
+     * отвергаются при открытии [map | unordered_map | csr | mapped]
+     */
+    using R = Rational_number<int64_t>;
+    std::string path = (std::filesystem::temp_directory_path() / "smk_matrix_26.bin").string();
+    Matrix<std::map, R> m(4, 5);
+    m.set(1, 2, R(1));
+    m.set(2, 5, R(2));
+    m.set(4, 1, R(3));
+
+    // Массив строк лежит сразу за заголовком, за ним - массив столбцов
+    auto corrupt = [&](uint64_t position, uint64_t value)
+    {
+        m.writeToBinaryFile(std::string(path));
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(sizeof(Binary_header) + position * sizeof(uint64_t));
+        file.write(reinterpret_cast<const char *>(&value), sizeof(value));
+    };
+    auto expectRejected = [&]()
+    {
+        EXPECT_THROW((Matrix<std::map, R>::readFromBinaryFile(std::string(path))), MatrixReadFromFileError);
+        EXPECT_THROW((Matrix<std::unordered_map, R>::readFromBinaryFile(std::string(path))), MatrixReadFromFileError);
+        EXPECT_THROW((Matrix<Compressed_storage, R>::readFromBinaryFile(std::string(path))), MatrixReadFromFileError);
+        EXPECT_THROW((Matrix<Mapped_storage, R>::readFromBinaryFile(std::string(path))), MatrixReadFromFileError);
+    };
+
+    corrupt(3 + 1, 6); // столбец 6 > 5
+    expectRejected();
+    corrupt(3 + 2, 0); // столбец 0
+    expectRejected();
+    corrupt(1, 5); // строки 1, 5, 4
+    expectRejected();
+    corrupt(1, 1); // (1, 2), (1, 5), (4, 1): строки упорядочены, сохраняется
+    EXPECT_EQ((Matrix<Compressed_storage, R>::readFromBinaryFile(std::string(path)).at(1, 5)), R(2));
+    corrupt(2, 1); // строки 1, 2, 1
+    expectRejected();
+    corrupt(3 + 2, 2); // (1, 2), (2, 5), (4, 2): порядок не нарушен
+    EXPECT_EQ((Matrix<Mapped_storage, R>::readFromBinaryFile(std::string(path)).at(4, 2)), R(3));
+
+    std::filesystem::remove(path);
+}
+
+TEST(Matrix_TestSuite, Matrix_27)
+{
+    /**
+     * Произведения матриц с ненулевым fill, умножение блока на вектор и текстовая запись без материализации
+     * совпадают с явным представлением [map | unordered_map]
+     */
+    using R = Rational_number<int64_t>;
+    auto square = Matrix<std::map, R>::ones(100000, 100000) * Matrix<std::map, R>::ones(100000, 100000);
+    EXPECT_EQ(square.getData().size(), 0);
+    EXPECT_EQ(square(5, 7), R(100000));
+
+    auto ones = Matrix<std::unordered_map, R>::ones(100000, 3);
+    Matrix<std::unordered_map, R> sparse(2, 100000);
+    sparse.set(2, 50000, R(1, 2));
+    auto product = sparse * ones;
+    EXPECT_EQ(product.getData().size(), 3);
+    EXPECT_EQ(product(2, 3), R(1, 2));
+    EXPECT_EQ(product(1, 1), R());
+
+    auto check = [](auto a, auto b)
+    {
+        a.set(1, 2, R(3));
+        a.set(3, 1, R(-1, 2));
+        a.set(2, 2, R());
+        b.set(2, 3, R(5));
+        b.set(1, 1, R(1, 3));
+        EXPECT_EQ((a * b).to_string(), (a.materialized() * b.materialized()).to_string());
+        EXPECT_EQ((a * b).getFill(), a.getFill() * b.getFill() * R(3));
+        EXPECT_EQ(a.multiplyTransposed(a).to_string(), (~a.materialized() * a.materialized()).to_string());
+        EXPECT_EQ((a * b.materialized()).to_string(), (a.materialized() * b.materialized()).to_string());
+
+        Vector<R> x(2);
+        x[1] = R(2);
+        x[2] = R(-3);
+        auto block = a[Matrix_coords(2, 1, 3, 2)];
+        Vector<R> y = block * x;
+        EXPECT_EQ(y, Vector<R>(block.materialize().materialized() * x));
+
+        std::string path = (std::filesystem::temp_directory_path() / "smk_matrix_27.txt").string();
+        a.writeToFile(std::string(path));
+        auto restored = decltype(a)::readFromFile(std::string(path));
+        EXPECT_EQ(restored.getFill(), a.getFill());
+        EXPECT_EQ(restored.getData().size(), a.getData().size());
+        EXPECT_EQ(restored.to_string(), a.to_string());
+        EXPECT_EQ(decltype(a)::readFromFile(std::string(path), Parallel_policy(4)).to_string(), a.to_string());
+        if (a.hasFill())
+        {
+            EXPECT_THROW((Matrix<Compressed_storage, R>::readFromFile(std::string(path))), MatrixReadFromFileError);
+            EXPECT_THROW(a.writeToBinaryFile(std::string(path)), MatrixWriteToFileError);
+        }
+        std::filesystem::remove(path);
+    };
+    check(Matrix<std::map, R>::full(3, 3, R(2)), Matrix<std::map, R>::full(3, 3, R(-1, 4)));
+    check(Matrix<std::unordered_map, R>::full(3, 3, R(2)), Matrix<std::unordered_map, R>(3, 3));
+    check(Matrix<std::map, R>(3, 3), Matrix<std::map, R>::full(3, 3, R(7)));
+}
+
+TEST(Matrix_TestSuite, Matrix_28)
+{
+    /**
+     * Ссылка, полученная через operator[], не изменяет копии матрицы, сделанные после ее получения;
+     * копии без выданных ссылок по-прежнему разделяют элементы [map | unordered_map]
+     */
+    using R = Rational_number<int64_t>;
+    auto check = [](auto m)
+    {
+        m.set(1, 1, R(1));
+        auto shared = m;
+        EXPECT_EQ(&shared.getData(), &m.getData());
+
+        auto &element = m[std::make_pair(1, 1)];
+        auto copy = m;
+        auto assigned = shared;
+        assigned = m;
+        element = R(5);
+        EXPECT_EQ(m(1, 1), R(5));
+        EXPECT_EQ(copy(1, 1), R(1));
+        EXPECT_EQ(assigned(1, 1), R(1));
+        EXPECT_EQ(shared(1, 1), R(1));
+
+        auto moved = std::move(m);
+        element = R(7);
+        EXPECT_EQ(moved(1, 1), R(7));
+        EXPECT_EQ(copy(1, 1), R(1));
+    };
+    check(Matrix<std::map, R>(2, 2));
+    check(Matrix<std::unordered_map, R>(2, 2));
+}
+
+TEST(Matrix_TestSuite, Matrix_29)
+{
+    /**
+     * Ленивое транспонирование хранит слабую ссылку: после удаления исходной матрицы бросается
+     * ProxyPointerError, копия матрицы не перенимает представления оригинала [map | unordered_map | csr]
+     */
+    using R = Rational_number<int64_t>;
+    auto check = [](auto *m)
+    {
+        using M = std::remove_pointer_t<decltype(m)>;
+        auto view = m->transposed();
+        EXPECT_EQ(view.shape(), std::make_pair(uint64_t(3), uint64_t(2)));
+        EXPECT_EQ(view.at(3, 1), R(4));
+
+        M copy(*m);
+        auto copy_view = copy.transposed();
+        delete m;
+        EXPECT_THROW(view.at(3, 1), ProxyPointerError);
+        EXPECT_THROW(view.shape(), ProxyPointerError);
+        EXPECT_THROW(view.materialize(), ProxyPointerError);
+        EXPECT_EQ(copy_view.at(3, 1), R(4));
+        EXPECT_EQ(copy_view.materialize().to_string(), (~copy).to_string());
+    };
+    Matrix<std::map, R> m(2, 3);
+    m.set(1, 3, R(4));
+    m.set(2, 1, R(-1));
+    check(new Matrix<std::map, R>(m));
+    auto hashed = new Matrix<std::unordered_map, R>(2, 3);
+    hashed->set(1, 3, R(4));
+    check(hashed);
+    check(new Matrix<Compressed_storage, R>(m));
+}
+
+TEST(Matrix_TestSuite, Matrix_30)
+{
+    /**
+     * Параллельное и последовательное произведения суммируют элементы строки в одном порядке,
+     * поэтому для чисел с плавающей точкой результаты совпадают поразрядно [unordered_map]
+     */
+    using C = Complex_number<double, double>;
+    Matrix<std::unordered_map, C> a(60, 60), b(60, 60);
+    uint64_t state = 12345;
+    auto next = [&state]()
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return state >> 33;
+    };
+    for (int k = 0; k < 1500; ++k)
+    {
+        double scale = next() % 2 ? 1e16 : 1e-3;
+        a.set(next() % 60 + 1, next() % 60 + 1, C(scale * (double(next() % 2001) - 1000.0) / 7.0, 0.1));
+        b.set(next() % 60 + 1, next() % 60 + 1, C(double(next() % 2001) / 3.0 - 333.0, -0.3));
+    }
+
+    auto serial = a * b;
+    for (unsigned threads : {1u, 2u, 3u, 8u})
+    {
+        auto parallel = a.multiply(b, Parallel_policy(threads));
+        ASSERT_EQ(parallel.getData().size(), serial.getData().size());
+        for (auto &entry : serial.getData())
+        {
+            const C &value = parallel.at(entry.first.first, entry.first.second);
+            EXPECT_EQ(value.getReal(), entry.second.getReal());
+            EXPECT_EQ(value.getImag(), entry.second.getImag());
+        }
+    }
+}
@@ -14,9 +14,9 @@ TEST(Rational_numberTestSuite, Rational_number_0)
 
     EXPECT_EQ(a.to_string(), "0/1");
     EXPECT_EQ(b.to_string(), "123/1");
-    EXPECT_EQ(c.to_string(), "312412/1231234");
-    EXPECT_EQ(d.to_string(), "412321/432423");
-    EXPECT_EQ(e.to_string(), "-123123/21412455");
+    EXPECT_EQ(c.to_string(), "156206/615617");
+    EXPECT_EQ(d.to_string(), "17927/18801");
+    EXPECT_EQ(e.to_string(), "-1001/174085");
 }
 
 TEST(Rational_numberTestSuite, Rational_number_1)
@@ -77,7 +77,7 @@ TEST(Rational_numberTestSuite, Rational_number_3)
      */
     first += 2 + first++ / 5;
     first.make_canonical();
-    EXPECT_EQ(first.to_string(), "1358/25");
+    EXPECT_EQ(first.to_string(), "1353/25");
 }
 
 TEST(Rational_numberTestSuite, Rational_number_4)
@@ -142,3 +142,174 @@ TEST(Rational_numberTestSuite, Rational_number_6)
     EXPECT_THROW(5 / first, RationalZeroDivisionError<int64_t>);
     EXPECT_THROW(second / 0, RationalZeroDivisionError<int64_t>);
 }
+
+TEST(Rational_numberTestSuite, Rational_number_7)
+{
+    /**
+     * Несократимый вид и отсутствие ложных переполнений в цепочке операций
+     */
+    Rational_number<int64_t> a("-6/-4");
+    EXPECT_EQ(a.to_string(), "3/2");
+    EXPECT_EQ((a - a).to_string(), "0/1");
+    EXPECT_EQ((a * Rational_number<int64_t>("4/9")).to_string(), "2/3");
+    EXPECT_EQ((a / Rational_number<int64_t>("-3/8")).to_string(), "-4/1");
+    EXPECT_EQ((a * 4).to_string(), "6/1");
+    EXPECT_EQ((a / -9).to_string(), "-1/6");
+
+    // sum(1 / (k (k + 1))) = n / (n + 1): без сокращения знаменатель равен произведению всех множителей
+    Rational_number<int64_t> sum;
+    for (int64_t k = 1; k <= 40; ++k)
+        sum += Rational_number<int64_t>(1, k * (k + 1));
+    EXPECT_EQ(sum.to_string(), "40/41");
+
+    Rational_number<int16_t> small;
+    for (int64_t k = 1; k <= 100; ++k)
+        small += Rational_number<int16_t>(1, k * (k + 1));
+    EXPECT_EQ(small.to_string(), "100/101");
+    EXPECT_THROW(Rational_number<int8_t>(1, 100) * Rational_number<int8_t>(1, 3), RationalOverflowError<int64_t>);
+}
+
+TEST(Rational_numberTestSuite, Rational_number_8)
+{
+    /**
+     * Арифметика с проверкой переполнения, в том числе для int64_t
+     */
+    int64_t result = 0;
+    EXPECT_FALSE(addOverflow<int64_t>(INT64_MAX - 1, 1, result));
+    EXPECT_EQ(result, INT64_MAX);
+    EXPECT_TRUE(addOverflow<int64_t>(INT64_MAX, 1, result));
+    EXPECT_TRUE(subOverflow<int64_t>(INT64_MIN, 1, result));
+    EXPECT_TRUE(mulOverflow<int64_t>(INT64_MAX / 2 + 1, 2, result));
+
+    int8_t small = 0;
+    EXPECT_FALSE(mulOverflow<int8_t>(-16, 8, small));
+    EXPECT_EQ(small, -128);
+    EXPECT_TRUE(mulOverflow<int8_t>(16, 8, small));
+    EXPECT_TRUE(checkOverFlow<int8_t>(128));
+    EXPECT_FALSE(checkOverFlow<int8_t>(-128));
+
+    Rational_number<int64_t> big(INT64_MAX - 1, 3);
+    EXPECT_THROW(big * 5, RationalOverflowError<int64_t>);
+    EXPECT_THROW(Rational_number<int64_t>(INT64_MAX) + Rational_number<int64_t>(1, 2), RationalOverflowError<int64_t>);
+    EXPECT_THROW(Rational_number<int64_t>(1, INT64_MAX) / Rational_number<int64_t>(INT64_MAX - 1), RationalOverflowError<int64_t>);
+    EXPECT_EQ(big * Rational_number<int64_t>(3, INT64_MAX - 1), Rational_number<int64_t>(1));
+}
+
+TEST(Rational_numberTestSuite, Rational_number_9)
+{
+    /**
+     * Big_integer: компактное представление, переход в длинное и обратно
+     */
+    Big_integer a(INT64_MAX);
+    EXPECT_TRUE(a.isSmall());
+    Big_integer b = a + 1;
+    EXPECT_FALSE(b.isSmall());
+    EXPECT_EQ(b.to_string(), "9223372036854775808");
+    EXPECT_TRUE((b - 1).isSmall());
+    EXPECT_EQ(b - 1, a);
+
+    Big_integer c = Big_integer::fromUnsigned(UINT64_MAX) + 1;
+    EXPECT_EQ(c.to_string(), "18446744073709551616");
+    EXPECT_EQ((c * c).to_string(), "340282366920938463463374607431768211456");
+    EXPECT_EQ((c * c) / c, c);
+    EXPECT_EQ((c * c + 7) % c, Big_integer(7));
+    EXPECT_EQ((-c * c) / (c + 1), Big_integer("-18446744073709551615"));
+    EXPECT_EQ(binaryGcd(c * 9, c * 6), c * 3);
+    EXPECT_EQ(c.bitLength(), 65);
+    EXPECT_DOUBLE_EQ(static_cast<double>(c), 18446744073709551616.0);
+    EXPECT_THROW(c / 0, std::logic_error);
+    EXPECT_THROW(Big_integer("12a"), std::invalid_argument);
+}
+
+TEST(Rational_numberTestSuite, Rational_number_10)
+{
+    /**
+     * Rational_number<Big_integer>: значения, не помещающиеся в int64_t
+     */
+    Rational_number<Big_integer> a(INT64_MAX, 3);
+    Rational_number<Big_integer> b = a * a * 9;
+    EXPECT_EQ(b.to_string(), "85070591730234615847396907784232501249/1");
+    EXPECT_EQ(b / (a * 3), Rational_number<Big_integer>(INT64_MAX));
+    EXPECT_EQ((Rational_number<Big_integer>(INT64_MAX) + Rational_number<Big_integer>(1, 2)).to_string(), "18446744073709551615/2");
+    EXPECT_DOUBLE_EQ(static_cast<double>(Rational_number<Big_integer>(INT64_MAX) * 4), 4.0 * INT64_MAX);
+    EXPECT_EQ(Rational_number<Big_integer>("2 / -4").to_string(), "-1/2");
+
+    Rational_number<Big_integer> sum;
+    for (int64_t k = 1; k <= 100; ++k)
+        sum += Rational_number<Big_integer>(1, k);
+    EXPECT_EQ(sum.to_string(), "14466636279520351160221518043104131447711/2788815009188499086581352357412492142272");
+}
+
+TEST(Rational_numberTestSuite, Rational_number_11)
+{
+    /**
+     * Разбор из диапазона символов без выделения памяти (и с переходом к конструктору из строки)
+     */
+    auto parse = [](const char *str)
+    { return Rational_number<int64_t>::fromChars(str, str + std::strlen(str)); };
+    EXPECT_EQ(parse(" 341 / 578 ").to_string(), "341/578");
+    EXPECT_EQ(parse("324/108").to_string(), "3/1");
+    EXPECT_EQ(parse("-7 / -14").to_string(), "1/2");
+    EXPECT_EQ(parse("+5").to_string(), "5/1");
+    EXPECT_THROW(parse("1 / 0"), RationalZeroDivisionError<int64_t>);
+    EXPECT_THROW(parse("abc"), RationalOverflowError<int64_t>);
+    EXPECT_THROW(Rational_number<int8_t>::fromChars("128", "128" + 3), RationalOverflowError<int64_t>);
+
+    const char *big = "123456789012345678901234567890 / 10";
+    EXPECT_EQ(Rational_number<Big_integer>::fromChars(big, big + std::strlen(big)).to_string(), "12345678901234567890123456789/1");
+
+    const char *complex = " 1.5 , -2 ";
+    EXPECT_EQ((Complex_number<double, double>::fromChars(complex, complex + std::strlen(complex))), (Complex_number<double, double>(1.5, -2)));
+    EXPECT_EQ((Complex_number<int, int>::fromChars("82", "82" + 2)).to_string(), "82+0i");
+}
+
+TEST(Rational_numberTestSuite, Rational_number_12)
+{
+    /**
+     * Сравнение и инкремент без переполнения: перекрестные произведения не помещаются в int64_t
+     */
+    using R = Rational_number<int64_t>;
+    R big(INT64_C(4611686018427387903));
+    EXPECT_FALSE(big < R(1, 3));
+    EXPECT_TRUE(R(1, 3) < big);
+    EXPECT_TRUE(big > R(1, 3));
+    EXPECT_TRUE(R(-INT64_MAX, 3) < R(1, INT64_MAX));
+
+    R a(INT64_MAX - 2, INT64_MAX - 1);
+    R b(INT64_MAX - 1, INT64_MAX);
+    EXPECT_TRUE(a < b);
+    EXPECT_TRUE(a <= b);
+    EXPECT_FALSE(a >= b);
+    EXPECT_TRUE(-a > -b);
+    EXPECT_TRUE(b <= b);
+    EXPECT_FALSE(R(INT64_MAX, INT64_MAX - 1) > R(INT64_MAX - 1, INT64_MAX - 2));
+
+    R c(INT64_MAX - 2);
+    R old = c++;
+    EXPECT_EQ(old, R(INT64_MAX - 2));
+    EXPECT_EQ(c, R(INT64_MAX - 1));
+    EXPECT_EQ(++c, R(INT64_MAX));
+    EXPECT_THROW(++c, RationalOverflowError<int64_t>);
+    EXPECT_THROW(c++, RationalOverflowError<int64_t>);
+    EXPECT_EQ(c, R(INT64_MAX));
+
+    R d(1, 2);
+    EXPECT_EQ((d++).to_string(), "1/2");
+    EXPECT_EQ(d.to_string(), "3/2");
+}
+
+TEST(Rational_numberTestSuite, Rational_number_13)
+{
+    /**
+     * Приведение к положительному знаменателю: смена знака после сокращения, переполнение - исключение
+     */
+    using R = Rational_number<int64_t>;
+    EXPECT_EQ(R(INT64_MIN, -2), R(INT64_C(4611686018427387904)));
+    EXPECT_EQ(R(INT64_MIN, INT64_MIN), R(1));
+    EXPECT_THROW(R(INT64_MIN, -1), RationalOverflowError<int64_t>);
+    EXPECT_THROW(R(1, INT64_MIN), RationalOverflowError<int64_t>);
+    EXPECT_EQ(Rational_number<int8_t>(-128, -2), Rational_number<int8_t>(64));
+    EXPECT_THROW(Rational_number<int8_t>(-128, -1), RationalOverflowError<int64_t>);
+    EXPECT_EQ(R(-6, -4).to_string(), "3/2");
+    EXPECT_EQ(R(6, -4).to_string(), "-3/2");
+}
@@ -0,0 +1,105 @@
+#include "gtest/gtest.h"
+#include "Rational.h"
+#include "Vector.h"
+#include "Matrix.h"
+#include "Compressed.h"
+#include "Solvers.h"
+
+TEST(Solvers_TestSuite, Solvers_0)
+{
+    /**
+     * Метод сопряженных градиентов: вещественная положительно определенная матрица [map | csr],
+     * переиспользование буферов и ограничение количества итераций
+     */
+    using C = Complex_number<>;
+    const int n = 50;
+    Matrix<std::map, C> a(n, n);
+    Vector<C> b(n);
+    for (int i = 1; i <= n; ++i)
+    {
+        a.set(i, i, C(2, 0));
+        if (i > 1)
+            a.set(i, i - 1, C(-1, 0));
+        if (i < n)
+            a.set(i, i + 1, C(-1, 0));
+        b[i] = C(1, 0);
+    }
+
+    Vector<C> x_1(n);
+    Solver_workspace<C> workspace;
+    Solver_stats stats = solveCG(a, b, x_1, Solver_options(), &workspace);
+    EXPECT_TRUE(stats.converged);
+    EXPECT_LE(stats.iterations, n);
+    EXPECT_EQ(stats.products, stats.iterations + 1);
+    EXPECT_LT(Vector<C>(a * x_1 - b).nrm2(), 1e-8);
+    // x_i = i (n + 1 - i) / 2
+    EXPECT_NEAR(x_1(10).getReal(), 10 * 41 / 2.0, 1e-7);
+
+    Matrix<Compressed_storage, C> c(a);
+    Vector<C> x_2;
+    stats = solveCG(c, b, x_2, Solver_options(), &workspace);
+    EXPECT_TRUE(stats.converged);
+    EXPECT_LT((x_2 - x_1).eval().nrm2(), 1e-8);
+
+    Solver_options options;
+    options.max_iterations = 3;
+    Vector<C> x_3(n);
+    stats = solveCG(a, b, x_3, options);
+    EXPECT_FALSE(stats.converged);
+    EXPECT_EQ(stats.iterations, 3);
+    EXPECT_GT(stats.residual, options.tolerance);
+
+    EXPECT_THROW(solveCG(a, Vector<C>(n - 1), x_3), MatrixShapeError);
+}
+
+TEST(Solvers_TestSuite, Solvers_1)
+{
+    /**
+     * BiCGSTAB и GMRES с перезапуском: несимметричная комплексная матрица [map | unordered_map]
+     */
+    using C = Complex_number<>;
+    const int n = 40;
+    Matrix<std::unordered_map, C> a(n, n);
+    Vector<C> b(n);
+    for (int i = 1; i <= n; ++i)
+    {
+        a.set(i, i, C(4, 1));
+        if (i > 1)
+            a.set(i, i - 1, C(-1, 0.5));
+        if (i < n)
+            a.set(i, i + 1, C(-2, 0));
+        if (i + 5 <= n)
+            a.set(i, i + 5, C(0.5, -0.5));
+        b[i] = C(i % 3, 1);
+    }
+
+    Vector<C> x_1(n);
+    Solver_stats stats = solveBiCGSTAB(a, b, x_1);
+    EXPECT_TRUE(stats.converged);
+    EXPECT_LT(Vector<C>(a * x_1 - b).nrm2() / b.nrm2(), 1e-9);
+
+    Solver_options options;
+    options.restart = 5;
+    Vector<C> x_2(n);
+    stats = solveGMRES(a, b, x_2, options);
+    EXPECT_TRUE(stats.converged);
+    EXPECT_GT(stats.iterations, options.restart);
+    EXPECT_LT(Vector<C>(a * x_2 - b).nrm2() / b.nrm2(), 1e-9);
+    EXPECT_LT((x_2 - x_1).eval().nrm2(), 1e-8);
+
+    Matrix<std::map, C> a_map(n, n);
+    for (int i = 1; i <= n; ++i)
+        for (int j = 1; j <= n; ++j)
+            if (!(a(i, j) == C()))
+                a_map.set(i, j, a(i, j));
+    Vector<C> x_3(x_2);
+    stats = solveGMRES(a_map, b, x_3);
+    EXPECT_TRUE(stats.converged);
+    EXPECT_LE(stats.iterations, 1);
+
+    Vector<C> x_4(n);
+    stats = solveGMRES(a, Vector<C>(n), x_4);
+    EXPECT_TRUE(stats.converged);
+    EXPECT_EQ(stats.iterations, 0);
+    EXPECT_EQ(x_4.nrm2(), 0);
+}
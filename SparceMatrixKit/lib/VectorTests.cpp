@@ -2,6 +2,9 @@
 #include "Rational.h"
 #include "Vector.h"
 #include "Matrix.h"
+#include "Compressed.h"
+#include <filesystem>
+#include <fstream>
 
 TEST(Vector_TestSuite, Vector_0)
 {
@@ -18,13 +21,13 @@ TEST(Vector_TestSuite, Vector_0)
 
     EXPECT_EQ(
         (v_1 + v_2).to_string(),
-        "27/18 38/24 ");
+        "3/2 19/12 ");
     EXPECT_EQ(
         (v_1 - v_2).to_string(),
-        "-3/18 2/24 ");
+        "-1/6 1/12 ");
     EXPECT_EQ(
         (v_1 * 3).to_string(),
-        "6/3 15/6 ");
+        "2/1 5/2 ");
     EXPECT_EQ(
         (v_1 / Complex_number<>("1, 2")).to_string(),
         "0.000000+0.000000i 0.000000+0.000000i ");
@@ -56,3 +59,237 @@ TEST(Vector_TestSuite, Vector_2)
     v_1[2] = Rational_number<int64_t>("5/6");
     EXPECT_ANY_THROW(v_1 / Rational_number<int64_t>());
 }
+
+TEST(Vector_TestSuite, Vector_3)
+{
+    /**
+     * Плотное хранение: явный и автоматический переход, совместимость с разреженным вектором и матрицами
+     */
+    Vector<Rational_number<int64_t>> v_1(6);
+    v_1[2] = Rational_number<int64_t>(3);
+    v_1[5] = Rational_number<int64_t>(-1);
+    EXPECT_FALSE(v_1.isDense());
+
+    Vector<Rational_number<int64_t>> v_2(v_1);
+    v_2.toDense();
+    EXPECT_TRUE(v_2.isDense());
+    EXPECT_TRUE(v_2.getData().empty());
+    EXPECT_EQ(v_2.getValues().size(), 6);
+    EXPECT_EQ(v_2.to_string(), v_1.to_string());
+    EXPECT_TRUE(v_1 == v_2);
+    EXPECT_EQ((v_1 + v_2).to_string(), "0/1 6/1 0/1 0/1 -2/1 0/1 ");
+    EXPECT_TRUE((v_1 + v_2).isDense());
+    EXPECT_THROW(v_2[7], std::logic_error);
+
+    v_1[1] = Rational_number<int64_t>(1);
+    EXPECT_FALSE(v_1.isDense());
+    v_1[3] = Rational_number<int64_t>(1);
+    EXPECT_FALSE(v_1.isDense());
+    v_1.scal(Rational_number<int64_t>(1));
+    EXPECT_TRUE(v_1.isDense());
+
+    v_2.toSparse();
+    EXPECT_FALSE(v_2.isDense());
+    EXPECT_EQ(v_2.getData().size(), 2);
+
+    Matrix<std::map, Rational_number<int64_t>> m(3, 6);
+    m[std::make_pair(1, 2)] = Rational_number<int64_t>(2);
+    m[std::make_pair(3, 5)] = Rational_number<int64_t>(1);
+    Matrix<Compressed_storage, Rational_number<int64_t>> c(m);
+
+    Vector<Rational_number<int64_t>> y(3);
+    y.toDense();
+    m.multiply(v_2, y);
+    EXPECT_TRUE(y.isDense());
+    EXPECT_EQ(y.to_string(), "6/1 0/1 -1/1 ");
+    c.multiply(v_1, y);
+    EXPECT_EQ(y.to_string(), "6/1 0/1 -1/1 ");
+
+    Vector<Rational_number<int64_t>> z(6);
+    z.toDense();
+    m.multiplyTransposed(y, z);
+    EXPECT_EQ(z.to_string(), "0/1 12/1 0/1 0/1 -1/1 0/1 ");
+    EXPECT_EQ((y * c).to_string(), z.to_string());
+}
+
+TEST(Vector_TestSuite, Vector_4)
+{
+    /**
+     * BLAS-1: dot, nrm2, axpy, scal для разреженных и плотных векторов
+     */
+    Vector<Rational_number<int64_t>> v_1(8);
+    v_1[2] = Rational_number<int64_t>(3);
+    v_1[5] = Rational_number<int64_t>(4);
+
+    Vector<Rational_number<int64_t>> v_2(8);
+    v_2[5] = Rational_number<int64_t>(2);
+    v_2[7] = Rational_number<int64_t>(1);
+
+    Vector<Rational_number<int64_t>> v_3(v_2);
+    v_3.toDense();
+
+    EXPECT_EQ(v_1.dot(v_2), Rational_number<int64_t>(8));
+    EXPECT_EQ(v_1.dot(v_3), Rational_number<int64_t>(8));
+    EXPECT_EQ(v_3.dot(v_1), Rational_number<int64_t>(8));
+    EXPECT_DOUBLE_EQ(v_1.nrm2(), 5);
+    EXPECT_THROW(v_1.dot(Vector<Rational_number<int64_t>>(3)), std::logic_error);
+
+    Vector<Rational_number<int64_t>> v_4(v_1);
+    v_4.axpy(Rational_number<int64_t>(-2), v_2);
+    EXPECT_FALSE(v_4.isDense());
+    EXPECT_EQ(v_4.to_string(), "0/1 3/1 0/1 0/1 0/1 0/1 -2/1 0/1 ");
+    v_1.axpy(Rational_number<int64_t>(-2), v_3);
+    EXPECT_TRUE(v_1.isDense());
+    EXPECT_EQ(v_1.to_string(), v_4.to_string());
+
+    v_3.scal(Rational_number<int64_t>(3));
+    v_2.scal(Rational_number<int64_t>(3));
+    EXPECT_EQ(v_3.to_string(), v_2.to_string());
+
+    Vector<Complex_number<double, double>> c_1(5), c_2(5);
+    for (int i = 1; i <= 5; ++i)
+    {
+        c_1[i] = Complex_number<double, double>(i, 1 - i);
+        c_2[i] = Complex_number<double, double>(2, i);
+    }
+    EXPECT_FALSE(c_1.isDense());
+    c_1.toDense();
+
+    // conj(i + (1 - i)j) * (2 + ij): re = sum(3i - i^2), im = sum(i^2 + 2i - 2)
+    EXPECT_EQ(c_1.dot(c_2), (Complex_number<double, double>(-10, 75)));
+    EXPECT_DOUBLE_EQ(c_1.nrm2(), std::sqrt(85));
+
+    c_1.axpy(Complex_number<double, double>(0, 1), c_2);
+    EXPECT_EQ(c_1.at(3), (Complex_number<double, double>()));
+    c_1.scal(Complex_number<double, double>(1, 1));
+    EXPECT_EQ(c_1.at(5), (Complex_number<double, double>(2, -2)));
+}
+
+TEST(Vector_TestSuite, Vector_5)
+{
+    /**
+     * Отложенные выражения: A * x + B * y - z, умножение на число, присваивание в операнд
+     */
+    using R = Rational_number<int64_t>;
+    Matrix<std::map, R> a(3, 4);
+    a[std::make_pair(1, 1)] = R(2);
+    a[std::make_pair(3, 4)] = R(1, 2);
+    Matrix<std::unordered_map, R> b(3, 2);
+    b[std::make_pair(2, 1)] = R(-1);
+    b[std::make_pair(3, 2)] = R(3);
+    Matrix<Compressed_storage, R> c(a);
+
+    Vector<R> x(4), y(2), z(3);
+    x[1] = R(1);
+    x[4] = R(4);
+    y[1] = R(5);
+    y[2] = R(1);
+    z[3] = R(5);
+
+    Vector<R> w = a * x + b * y - z;
+    EXPECT_EQ(w.to_string(), "2/1 -5/1 0/1 ");
+    EXPECT_EQ(w.getLen(), 3);
+    EXPECT_EQ((c * x - z * R(2) + -(b * y)).to_string(), "2/1 5/1 -11/1 ");
+
+    z = z * R(2) - a * x;
+    EXPECT_EQ(z.to_string(), "-2/1 0/1 8/1 ");
+    z.toDense();
+    z = z + z;
+    EXPECT_TRUE(z.isDense());
+    EXPECT_EQ(z.to_string(), "-4/1 0/1 16/1 ");
+
+    EXPECT_THROW(w = x + y, std::logic_error);
+    EXPECT_THROW(a * y, MatrixShapeError);
+}
+
+TEST(Vector_TestSuite, Vector_6)
+{
+    /**
+     * Ссылки, полученные operator[], остаются действительными при заполнении вектора;
+     * переход в плотный режим выполняется только массовыми операциями и toDense()
+     */
+    using R = Rational_number<int64_t>;
+    Vector<R> v(4);
+    R &r_1 = v[1];
+    R &r_2 = v[2];
+    R &r_3 = v[3];
+    r_1 = R(7);
+    r_2 = R(8);
+    r_3 = R(9);
+    v.set(4, R(10));
+    EXPECT_FALSE(v.isDense());
+    EXPECT_EQ(v(1), R(7));
+    EXPECT_EQ(v(3), R(9));
+
+    Vector<R> w = v * R(2);
+    EXPECT_TRUE(w.isDense());
+    EXPECT_EQ(w(4), R(20));
+
+    EXPECT_THROW(v.set(5, R(1)), std::logic_error);
+    EXPECT_THROW(v.set(0, R(1)), std::logic_error);
+    EXPECT_THROW(w.set(5, R(1)), std::logic_error);
+    v.toDense();
+    EXPECT_EQ(v(2), R(8));
+}
+
+TEST(Vector_TestSuite, Vector_7)
+{
+    /**
+     * Чтение с файла с отсутствующим или неполным заголовком: пустой файл, только комментарии,
+     * заголовок без типа, нечисловая и отрицательная длина
+     */
+    std::string path = (std::filesystem::temp_directory_path() / "smk_vector_7.txt").string();
+    std::ofstream(path) << "";
+    EXPECT_THROW(Vector<Rational_number<int64_t>>::readFromFile(path), VectorReadFromFileError);
+
+    std::ofstream(path) << "# vector rational 3\n#\n";
+    EXPECT_THROW(Vector<Rational_number<int64_t>>::readFromFile(path), VectorReadFromFileError);
+
+    std::ofstream(path) << "vector\n";
+    EXPECT_THROW(Vector<Rational_number<int64_t>>::readFromFile(path), VectorReadFromFileError);
+
+    std::ofstream(path) << "vector rational abc\n";
+    EXPECT_THROW(Vector<Rational_number<int64_t>>::readFromFile(path), VectorReadFromFileError);
+
+    std::ofstream(path) << "vector rational -3\n";
+    EXPECT_THROW(Vector<Rational_number<int64_t>>::readFromFile(path), VectorReadFromFileError);
+
+    std::ofstream(path) << "vector rational 3\n2 <5>\n";
+    EXPECT_EQ(Vector<Rational_number<int64_t>>::readFromFile(path).to_string(), "0/1 5/1 0/1 ");
+    std::filesystem::remove(path);
+}
+
+TEST(Vector_TestSuite, Vector_8)
+{
+    /**
+     * Временные матрица и вектор произведения хранятся в выражении: его можно сохранить в auto-переменную
+     * и вычислить позже [map | unordered_map | csr | proxy]
+     */
+    using R = Rational_number<int64_t>;
+    Matrix<std::map, R> a(2, 3);
+    a.set(1, 1, R(2));
+    a.set(2, 3, R(-1));
+    auto vector = [](R first, R last)
+    {
+        Vector<R> v(3);
+        v[1] = first;
+        v[3] = last;
+        return v;
+    };
+    Vector<R> x = vector(R(1), R(4));
+
+    auto y_1 = a * vector(R(1), R(4));
+    auto y_2 = Matrix<std::unordered_map, R>(2, 3) * vector(R(1), R(1));
+    auto y_3 = Matrix<Compressed_storage, R>(a) * vector(R(3), R(1));
+    auto y_4 = (a + a) * x;
+    auto y_5 = a[Matrix_coords(1, 1, 2, 3)] * vector(R(1), R(4));
+    auto y_6 = a * vector(R(1), R(4)) + (a + a) * x;
+    Vector<R> other = vector(R(7), R(7));
+
+    EXPECT_EQ(Vector<R>(y_1).to_string(), "2/1 -4/1 ");
+    EXPECT_EQ(Vector<R>(y_2).to_string(), "0/1 0/1 ");
+    EXPECT_EQ(Vector<R>(y_3).to_string(), "6/1 -1/1 ");
+    EXPECT_EQ(Vector<R>(y_4).to_string(), "4/1 -8/1 ");
+    EXPECT_EQ(Vector<R>(y_5).to_string(), "2/1 -4/1 ");
+    EXPECT_EQ(Vector<R>(y_6).to_string(), "6/1 -12/1 ");
+}
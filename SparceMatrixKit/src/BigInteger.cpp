@@ -0,0 +1,402 @@
+#include "BigInteger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using Magnitude = std::vector<uint32_t>;
+
+static const uint64_t LIMB_BASE = uint64_t(1) << 32;
+
+static void trim(Magnitude &a)
+{
+    while (!a.empty() && a.back() == 0)
+        a.pop_back();
+}
+
+static Magnitude fromUint64(uint64_t value)
+{
+    Magnitude result;
+    while (value != 0)
+    {
+        result.push_back(static_cast<uint32_t>(value));
+        value >>= 32;
+    }
+    return result;
+}
+
+static int compareMagnitudes(const Magnitude &a, const Magnitude &b)
+{
+    if (a.size() != b.size())
+        return a.size() < b.size() ? -1 : 1;
+    for (size_t i = a.size(); i-- > 0;)
+        if (a[i] != b[i])
+            return a[i] < b[i] ? -1 : 1;
+    return 0;
+}
+
+static Magnitude addMagnitudes(const Magnitude &a, const Magnitude &b)
+{
+    const Magnitude &longer = a.size() >= b.size() ? a : b;
+    const Magnitude &shorter = a.size() >= b.size() ? b : a;
+
+    Magnitude result(longer.size() + 1, 0);
+    uint64_t carry = 0;
+    for (size_t i = 0; i < longer.size(); ++i)
+    {
+        uint64_t sum = uint64_t(longer[i]) + (i < shorter.size() ? shorter[i] : 0) + carry;
+        result[i] = static_cast<uint32_t>(sum);
+        carry = sum >> 32;
+    }
+    result[longer.size()] = static_cast<uint32_t>(carry);
+    trim(result);
+    return result;
+}
+
+// a >= b
+static Magnitude subtractMagnitudes(const Magnitude &a, const Magnitude &b)
+{
+    Magnitude result(a.size(), 0);
+    int64_t borrow = 0;
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        int64_t difference = int64_t(a[i]) - (i < b.size() ? b[i] : 0) - borrow;
+        borrow = difference < 0 ? 1 : 0;
+        result[i] = static_cast<uint32_t>(difference + (borrow ? int64_t(LIMB_BASE) : 0));
+    }
+    trim(result);
+    return result;
+}
+
+static Magnitude multiplyMagnitudes(const Magnitude &a, const Magnitude &b)
+{
+    if (a.empty() || b.empty())
+        return Magnitude();
+
+    Magnitude result(a.size() + b.size(), 0);
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < b.size(); ++j)
+        {
+            uint64_t current = uint64_t(a[i]) * b[j] + result[i + j] + carry;
+            result[i + j] = static_cast<uint32_t>(current);
+            carry = current >> 32;
+        }
+        result[i + b.size()] = static_cast<uint32_t>(carry);
+    }
+    trim(result);
+    return result;
+}
+
+// a /= divisor, возвращает остаток
+static uint32_t divideBySmall(Magnitude &a, uint32_t divisor)
+{
+    uint64_t remainder = 0;
+    for (size_t i = a.size(); i-- > 0;)
+    {
+        uint64_t current = (remainder << 32) | a[i];
+        a[i] = static_cast<uint32_t>(current / divisor);
+        remainder = current % divisor;
+    }
+    trim(a);
+    return static_cast<uint32_t>(remainder);
+}
+
+// Деление столбиком (Кнут, алгоритм D), |b| >= 2 разрядов, a >= b
+static void divideMagnitudes(const Magnitude &a, const Magnitude &b, Magnitude &quotient, Magnitude &remainder)
+{
+    size_t n = b.size();
+    size_t m = a.size() - n;
+    int shift = std::countl_zero(b.back());
+
+    Magnitude divisor(n), dividend(a.size() + 1);
+    for (size_t i = n; i-- > 0;)
+        divisor[i] = static_cast<uint32_t>((uint64_t(b[i]) << shift) | (i > 0 ? uint64_t(b[i - 1]) >> (32 - shift) : 0));
+    dividend[a.size()] = static_cast<uint32_t>(uint64_t(a.back()) >> (32 - shift));
+    for (size_t i = a.size(); i-- > 0;)
+        dividend[i] = static_cast<uint32_t>((uint64_t(a[i]) << shift) | (i > 0 ? uint64_t(a[i - 1]) >> (32 - shift) : 0));
+
+    quotient.assign(m + 1, 0);
+    for (size_t j = m + 1; j-- > 0;)
+    {
+        uint64_t numerator = (uint64_t(dividend[j + n]) << 32) | dividend[j + n - 1];
+        uint64_t estimate = numerator / divisor[n - 1];
+        uint64_t rest = numerator % divisor[n - 1];
+        while (estimate >= LIMB_BASE || estimate * divisor[n - 2] > ((rest << 32) | dividend[j + n - 2]))
+        {
+            --estimate;
+            rest += divisor[n - 1];
+            if (rest >= LIMB_BASE)
+                break;
+        }
+
+        int64_t borrow = 0, current;
+        for (size_t i = 0; i < n; ++i)
+        {
+            uint64_t product = estimate * divisor[i];
+            current = int64_t(dividend[i + j]) - borrow - int64_t(product & 0xFFFFFFFF);
+            dividend[i + j] = static_cast<uint32_t>(current);
+            borrow = int64_t(product >> 32) - (current >> 32);
+        }
+        current = int64_t(dividend[j + n]) - borrow;
+        dividend[j + n] = static_cast<uint32_t>(current);
+
+        if (current < 0)
+        {
+            // Оценка оказалась на единицу больше: возвращаем делитель
+            --estimate;
+            uint64_t carry = 0;
+            for (size_t i = 0; i < n; ++i)
+            {
+                uint64_t sum = uint64_t(dividend[i + j]) + divisor[i] + carry;
+                dividend[i + j] = static_cast<uint32_t>(sum);
+                carry = sum >> 32;
+            }
+            dividend[j + n] = static_cast<uint32_t>(dividend[j + n] + carry);
+        }
+        quotient[j] = static_cast<uint32_t>(estimate);
+    }
+    trim(quotient);
+
+    remainder.assign(n, 0);
+    for (size_t i = 0; i < n; ++i)
+        remainder[i] = static_cast<uint32_t>((uint64_t(dividend[i]) >> shift) | (shift > 0 ? uint64_t(dividend[i + 1]) << (32 - shift) : 0));
+    trim(remainder);
+}
+
+// Старшие (не более 64) бита модуля: value ~ top * 2^exponent
+static uint64_t topBits(const Magnitude &a, uint64_t bits, int64_t &exponent)
+{
+    exponent = bits > 64 ? static_cast<int64_t>(bits - 64) : 0;
+    size_t offset = exponent / 32;
+    int shift = exponent % 32;
+
+    uint64_t result = 0;
+    for (size_t i = 0; i < 3 && offset + i < a.size(); ++i)
+    {
+        uint64_t limb = a[offset + i];
+        int position = static_cast<int>(32 * i) - shift;
+        if (position >= 0 && position < 64)
+            result |= limb << position;
+        else if (position < 0)
+            result |= limb >> -position;
+    }
+    return result;
+}
+
+Big_integer Big_integer::fromMagnitude(bool negative, std::vector<uint32_t> magnitude)
+{
+    trim(magnitude);
+    Big_integer result;
+    if (magnitude.size() <= 2)
+    {
+        uint64_t value = (magnitude.size() > 0 ? magnitude[0] : 0) | (magnitude.size() > 1 ? uint64_t(magnitude[1]) << 32 : 0);
+        uint64_t limit = uint64_t(std::numeric_limits<int64_t>::max()) + (negative ? 1 : 0);
+        if (value <= limit)
+        {
+            result.small = negative ? static_cast<int64_t>(uint64_t(0) - value) : static_cast<int64_t>(value);
+            return result;
+        }
+    }
+    result.negative = negative;
+    result.limbs = std::move(magnitude);
+    return result;
+}
+
+Big_integer Big_integer::fromUnsigned(uint64_t value)
+{
+    return fromMagnitude(false, fromUint64(value));
+}
+
+std::vector<uint32_t> Big_integer::magnitude() const
+{
+    if (!isSmall())
+        return limbs;
+    return fromUint64(small < 0 ? uint64_t(0) - uint64_t(small) : uint64_t(small));
+}
+
+bool Big_integer::isNegative() const
+{
+    return isSmall() ? small < 0 : negative;
+}
+
+Big_integer::Big_integer(const std::string &str)
+{
+    size_t begin = str.find_first_not_of(" \t\r\n");
+    size_t end = str.find_last_not_of(" \t\r\n");
+    if (begin == std::string::npos)
+        throw std::invalid_argument("Big_integer: empty string");
+
+    bool is_negative = false;
+    if (str[begin] == '+' || str[begin] == '-')
+    {
+        is_negative = str[begin] == '-';
+        ++begin;
+    }
+    if (begin > end)
+        throw std::invalid_argument("Big_integer: no digits in '" + str + "'");
+
+    Magnitude result;
+    for (size_t i = begin; i <= end;)
+    {
+        // По 9 десятичных цифр за шаг: result = result * 10^k + chunk
+        uint32_t chunk = 0, scale = 1;
+        for (size_t k = 0; k < 9 && i <= end; ++k, ++i)
+        {
+            if (str[i] < '0' || str[i] > '9')
+                throw std::invalid_argument("Big_integer: invalid digit in '" + str + "'");
+            chunk = chunk * 10 + (str[i] - '0');
+            scale *= 10;
+        }
+
+        uint64_t carry = chunk;
+        for (auto &limb : result)
+        {
+            uint64_t current = uint64_t(limb) * scale + carry;
+            limb = static_cast<uint32_t>(current);
+            carry = current >> 32;
+        }
+        if (carry != 0)
+            result.push_back(static_cast<uint32_t>(carry));
+    }
+    *this = fromMagnitude(is_negative, std::move(result));
+}
+
+uint64_t Big_integer::bitLength() const
+{
+    if (isSmall())
+    {
+        uint64_t value = small < 0 ? uint64_t(0) - uint64_t(small) : uint64_t(small);
+        return 64 - std::countl_zero(value);
+    }
+    return 32 * limbs.size() - std::countl_zero(limbs.back());
+}
+
+Big_integer Big_integer::addSlow(const Big_integer &a, const Big_integer &b, bool subtract)
+{
+    bool sign_a = a.isNegative();
+    bool sign_b = b.isNegative() != subtract;
+    Magnitude magnitude_a = a.magnitude(), magnitude_b = b.magnitude();
+
+    if (sign_a == sign_b)
+        return fromMagnitude(sign_a, addMagnitudes(magnitude_a, magnitude_b));
+
+    if (compareMagnitudes(magnitude_a, magnitude_b) >= 0)
+        return fromMagnitude(sign_a, subtractMagnitudes(magnitude_a, magnitude_b));
+    return fromMagnitude(sign_b, subtractMagnitudes(magnitude_b, magnitude_a));
+}
+
+Big_integer Big_integer::mulSlow(const Big_integer &a, const Big_integer &b)
+{
+    return fromMagnitude(a.isNegative() != b.isNegative(), multiplyMagnitudes(a.magnitude(), b.magnitude()));
+}
+
+void Big_integer::divModSlow(const Big_integer &a, const Big_integer &b, Big_integer *quotient, Big_integer *remainder)
+{
+    Magnitude magnitude_a = a.magnitude(), magnitude_b = b.magnitude();
+    if (magnitude_b.empty())
+        throw std::logic_error("Cant devide by zero");
+
+    Magnitude result, rest;
+    if (compareMagnitudes(magnitude_a, magnitude_b) < 0)
+        rest = magnitude_a;
+    else if (magnitude_b.size() == 1)
+    {
+        result = magnitude_a;
+        rest = fromUint64(divideBySmall(result, magnitude_b[0]));
+    }
+    else
+        divideMagnitudes(magnitude_a, magnitude_b, result, rest);
+
+    if (quotient != nullptr)
+        *quotient = fromMagnitude(a.isNegative() != b.isNegative(), std::move(result));
+    if (remainder != nullptr)
+        *remainder = fromMagnitude(a.isNegative(), std::move(rest));
+}
+
+int Big_integer::compare(const Big_integer &other) const
+{
+    if (isSmall() && other.isSmall())
+        return small < other.small ? -1 : (small > other.small ? 1 : 0);
+
+    bool sign = isNegative();
+    if (sign != other.isNegative())
+        return sign ? -1 : 1;
+
+    int result = compareMagnitudes(magnitude(), other.magnitude());
+    return sign ? -result : result;
+}
+
+Big_integer::operator double() const
+{
+    if (isSmall())
+        return static_cast<double>(small);
+
+    double result = 0;
+    for (size_t i = limbs.size(); i-- > 0;)
+        result = result * double(LIMB_BASE) + limbs[i];
+    return negative ? -result : result;
+}
+
+Big_integer::operator int64_t() const
+{
+    if (isSmall())
+        return small;
+    return negative ? std::numeric_limits<int64_t>::min() : std::numeric_limits<int64_t>::max();
+}
+
+std::string Big_integer::to_string() const
+{
+    if (isSmall())
+        return std::to_string(small);
+
+    Magnitude rest = limbs;
+    std::vector<uint32_t> chunks;
+    while (!rest.empty())
+        chunks.push_back(divideBySmall(rest, 1000000000));
+
+    std::string result = negative ? "-" : "";
+    result += std::to_string(chunks.back());
+    for (size_t i = chunks.size() - 1; i-- > 0;)
+    {
+        std::string chunk = std::to_string(chunks[i]);
+        result += std::string(9 - chunk.size(), '0') + chunk;
+    }
+    return result;
+}
+
+Big_integer binaryGcd(const Big_integer &a, const Big_integer &b)
+{
+    if (a.isSmall() && b.isSmall())
+    {
+        uint64_t u = a.small < 0 ? uint64_t(0) - uint64_t(a.small) : uint64_t(a.small);
+        uint64_t v = b.small < 0 ? uint64_t(0) - uint64_t(b.small) : uint64_t(b.small);
+        return Big_integer::fromUnsigned(binaryGcd<uint64_t>(u, v));
+    }
+
+    // Алгоритм Евклида, пока одно из чисел длинное
+    Big_integer x = Big_integer::fromMagnitude(false, a.magnitude());
+    Big_integer y = Big_integer::fromMagnitude(false, b.magnitude());
+    while (y != Big_integer())
+    {
+        if (x.isSmall() && y.isSmall())
+            return binaryGcd(x, y);
+        Big_integer rest = x % y;
+        x = std::move(y);
+        y = std::move(rest);
+    }
+    return x;
+}
+
+double ratioToDouble(const Big_integer &numerator, const Big_integer &denominator)
+{
+    if (numerator.isSmall() && denominator.isSmall())
+        return static_cast<double>(numerator.small) / static_cast<double>(denominator.small);
+
+    int64_t exponent_1, exponent_2;
+    double top_1 = static_cast<double>(topBits(numerator.magnitude(), numerator.bitLength(), exponent_1));
+    double top_2 = static_cast<double>(topBits(denominator.magnitude(), denominator.bitLength(), exponent_2));
+    double result = std::ldexp(top_1 / top_2, static_cast<int>(exponent_1 - exponent_2));
+    return numerator.isNegative() != denominator.isNegative() ? -result : result;
+}
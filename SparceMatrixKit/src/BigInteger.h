@@ -0,0 +1,285 @@
+#pragma once
+
+#include <iostream>
+#include "stdint.h"
+#include <string>
+#include <vector>
+#include <limits>
+
+#include "Other.h"
+
+/**
+ * @brief Знаковое целое произвольной точности
+ *
+ * Значения, помещающиеся в int64_t, хранятся в поле small без выделения памяти, и операции над ними
+ * выполняются встроенной арифметикой с проверкой переполнения. При переполнении значение переходит
+ * в представление модулем из 32-битных разрядов (младшие разряды первыми) и знаком; результат,
+ * снова помещающийся в int64_t, возвращается в компактное представление.
+ * Деление и остаток, как и для встроенных типов, округляют частное к нулю.
+ */
+class Big_integer
+{
+    int64_t small = 0;           /**< Значение в компактном представлении (если limbs пуст) */
+    bool negative = false;       /**< Знак в длинном представлении */
+    std::vector<uint32_t> limbs; /**< Модуль в длинном представлении (пуст в компактном) */
+
+    static Big_integer fromMagnitude(bool negative, std::vector<uint32_t> magnitude);
+    std::vector<uint32_t> magnitude() const;
+    bool isNegative() const;
+
+    static Big_integer addSlow(const Big_integer &a, const Big_integer &b, bool subtract);
+    static Big_integer mulSlow(const Big_integer &a, const Big_integer &b);
+    static void divModSlow(const Big_integer &a, const Big_integer &b, Big_integer *quotient, Big_integer *remainder);
+
+public:
+    /**
+     * @brief Конструктор по умолчанию (ноль)
+     *
+     */
+    Big_integer() = default;
+
+    /**
+     * @brief Конструктор из встроенного целого
+     *
+     * @param[in] value значение
+     */
+    Big_integer(int64_t value) : small(value) {}
+
+    /**
+     * @brief Создание числа из беззнакового 64-битного целого
+     *
+     * @param[in] value значение
+     * @return число
+     */
+    static Big_integer fromUnsigned(uint64_t value);
+
+    /**
+     * @brief Конструктор из десятичной записи вида '[+-]digits' (пробелы по краям допускаются)
+     *
+     * @param[in] str строка
+     * @throws std::invalid_argument если строка не является целым числом
+     */
+    explicit Big_integer(const std::string &str);
+
+    /**
+     * @brief Проверка компактного представления
+     *
+     * @return true, если значение помещается в int64_t и хранится без выделения памяти
+     */
+    bool isSmall() const
+    {
+        return limbs.empty();
+    }
+
+    /**
+     * @brief Количество значащих бит модуля
+     *
+     * @return количество бит (0 для нуля)
+     */
+    uint64_t bitLength() const;
+
+    Big_integer operator+(const Big_integer &other) const
+    {
+        int64_t result;
+        if (isSmall() && other.isSmall() && !addOverflow(small, other.small, result))
+            return Big_integer(result);
+        return addSlow(*this, other, false);
+    }
+
+    Big_integer operator-(const Big_integer &other) const
+    {
+        int64_t result;
+        if (isSmall() && other.isSmall() && !subOverflow(small, other.small, result))
+            return Big_integer(result);
+        return addSlow(*this, other, true);
+    }
+
+    Big_integer operator*(const Big_integer &other) const
+    {
+        int64_t result;
+        if (isSmall() && other.isSmall() && !mulOverflow(small, other.small, result))
+            return Big_integer(result);
+        return mulSlow(*this, other);
+    }
+
+    /**
+     * @brief Деление с округлением к нулю
+     *
+     * @throws std::logic_error при делении на ноль
+     */
+    Big_integer operator/(const Big_integer &other) const
+    {
+        if (isSmall() && other.isSmall() && other.small != 0 && !(small == std::numeric_limits<int64_t>::min() && other.small == -1))
+            return Big_integer(small / other.small);
+
+        Big_integer quotient;
+        divModSlow(*this, other, &quotient, nullptr);
+        return quotient;
+    }
+
+    /**
+     * @brief Остаток от деления (знак совпадает со знаком делимого)
+     *
+     * @throws std::logic_error при делении на ноль
+     */
+    Big_integer operator%(const Big_integer &other) const
+    {
+        if (isSmall() && other.isSmall() && other.small != 0)
+            return Big_integer(other.small == -1 ? 0 : small % other.small);
+
+        Big_integer remainder;
+        divModSlow(*this, other, nullptr, &remainder);
+        return remainder;
+    }
+
+    Big_integer operator-() const
+    {
+        return Big_integer(0) - *this;
+    }
+
+    Big_integer &operator+=(const Big_integer &other)
+    {
+        return *this = *this + other;
+    }
+
+    Big_integer &operator-=(const Big_integer &other)
+    {
+        return *this = *this - other;
+    }
+
+    Big_integer &operator*=(const Big_integer &other)
+    {
+        return *this = *this * other;
+    }
+
+    Big_integer &operator/=(const Big_integer &other)
+    {
+        return *this = *this / other;
+    }
+
+    Big_integer &operator%=(const Big_integer &other)
+    {
+        return *this = *this % other;
+    }
+
+    /**
+     * @brief Сравнение двух чисел
+     *
+     * @param[in] other число
+     * @return отрицательное, ноль или положительное значение
+     */
+    int compare(const Big_integer &other) const;
+
+    friend bool operator==(const Big_integer &a, const Big_integer &b)
+    {
+        if (a.isSmall() && b.isSmall())
+            return a.small == b.small;
+        return a.compare(b) == 0;
+    }
+
+    friend bool operator!=(const Big_integer &a, const Big_integer &b)
+    {
+        return !(a == b);
+    }
+
+    friend bool operator<(const Big_integer &a, const Big_integer &b)
+    {
+        if (a.isSmall() && b.isSmall())
+            return a.small < b.small;
+        return a.compare(b) < 0;
+    }
+
+    friend bool operator<=(const Big_integer &a, const Big_integer &b)
+    {
+        return !(b < a);
+    }
+
+    friend bool operator>(const Big_integer &a, const Big_integer &b)
+    {
+        return b < a;
+    }
+
+    friend bool operator>=(const Big_integer &a, const Big_integer &b)
+    {
+        return !(a < b);
+    }
+
+    /**
+     * @brief Преобразование к double (с округлением, для очень больших значений - бесконечность)
+     *
+     */
+    explicit operator double() const;
+
+    /**
+     * @brief Преобразование к int64_t с насыщением
+     *
+     */
+    explicit operator int64_t() const;
+
+    /**
+     * @brief Десятичная запись числа
+     *
+     * @return строка
+     */
+    std::string to_string() const;
+
+    friend std::ostream &operator<<(std::ostream &out, const Big_integer &value)
+    {
+        return out << value.to_string();
+    }
+
+    friend Big_integer binaryGcd(const Big_integer &a, const Big_integer &b);
+    friend double ratioToDouble(const Big_integer &numerator, const Big_integer &denominator);
+};
+
+/**
+ * @brief Наибольший общий делитель модулей (бинарный алгоритм для компактных значений, алгоритм Евклида для длинных)
+ *
+ * @param[in] a первое число
+ * @param[in] b второе число
+ * @return НОД(|a|, |b|)
+ */
+Big_integer binaryGcd(const Big_integer &a, const Big_integer &b);
+
+/**
+ * @brief Частное numerator / denominator в виде double без переполнения промежуточных значений
+ *
+ * @param[in] numerator делимое
+ * @param[in] denominator делитель
+ * @return частное
+ */
+double ratioToDouble(const Big_integer &numerator, const Big_integer &denominator);
+
+/*
+    Арифметика Big_integer не переполняется: функции проверки из Other.h всегда возвращают false
+*/
+
+inline bool addOverflow(const Big_integer &a, const Big_integer &b, Big_integer &result)
+{
+    result = a + b;
+    return false;
+}
+
+inline bool subOverflow(const Big_integer &a, const Big_integer &b, Big_integer &result)
+{
+    result = a - b;
+    return false;
+}
+
+inline bool mulOverflow(const Big_integer &a, const Big_integer &b, Big_integer &result)
+{
+    result = a * b;
+    return false;
+}
+
+template <>
+struct std::numeric_limits<Big_integer>
+{
+    static constexpr bool is_specialized = true;
+    static constexpr bool is_signed = true;
+    static constexpr bool is_integer = true;
+    static constexpr bool is_exact = true;
+    static constexpr bool is_bounded = false;
+    static constexpr bool is_modulo = false;
+    static constexpr int radix = 2;
+};
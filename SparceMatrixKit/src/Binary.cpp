@@ -0,0 +1,15 @@
+#include "Binary.h"
+
+#include <fstream>
+
+bool writeBinaryFile(const std::string &filename, const Binary_header &header, const std::vector<std::pair<const void *, uint64_t>> &blocks)
+{
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+        return false;
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    for (auto &block : blocks)
+        file.write(static_cast<const char *>(block.first), static_cast<std::streamsize>(block.second));
+    return static_cast<bool>(file.flush());
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <iostream>
+#include "stdint.h"
+#include <string>
+#include <vector>
+#include <cstring>
+#include <type_traits>
+
+#include "Reader.h"
+
+/*
+    Двоичный формат матриц и векторов:
+        заголовок Binary_header (80 байт),
+        массивы координат (uint64_t[nnz] на каждую координату: строки, затем столбцы; у вектора - только индексы),
+        массив значений (T[nnz] в представлении памяти).
+    Элементы упорядочены по координатам (строка, столбец). Числа записываются в порядке байт машины,
+    поэтому файл переносим только между машинами с одинаковым порядком байт.
+*/
+
+/**
+ * @brief Заголовок двоичного файла матрицы или вектора
+ *
+ */
+struct Binary_header
+{
+    char magic[4];       /**< Сигнатура "SMKB" */
+    uint16_t version;    /**< Версия формата */
+    uint16_t dimensions; /**< Количество координат: 2 - матрица, 1 - вектор */
+    char type[16];       /**< T::type() */
+    char first[8];       /**< T::getTypeNames().first */
+    char second[8];      /**< T::getTypeNames().second */
+    uint32_t value_size; /**< sizeof(T) */
+    uint32_t reserved;   /**< Не используется (ноль) */
+    uint64_t rows;       /**< Количество строк (длина вектора) */
+    uint64_t columns;    /**< Количество столбцов (1 у вектора) */
+    double eps;          /**< eps матрицы или вектора */
+    uint64_t non_zeros;  /**< Количество записанных элементов */
+};
+
+static_assert(sizeof(Binary_header) == 80, "Binary_header layout must not contain padding");
+
+/**
+ * @brief Заполнение заголовка двоичного файла
+ *
+ * @tparam T тип элементов
+ * @param[in] dimensions количество координат (2 - матрица, 1 - вектор)
+ * @param[in] rows количество строк (длина вектора)
+ * @param[in] columns количество столбцов
+ * @param[in] eps eps
+ * @param[in] non_zeros количество элементов
+ * @return заголовок
+ */
+template <typename T>
+Binary_header makeBinaryHeader(uint16_t dimensions, uint64_t rows, uint64_t columns, double eps, uint64_t non_zeros)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Binary format requires trivially copyable elements");
+
+    Binary_header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "SMKB", 4);
+    header.version = 1;
+    header.dimensions = dimensions;
+    std::strncpy(header.type, T::type(), sizeof(header.type) - 1);
+    std::strncpy(header.first, T::getTypeNames().first, sizeof(header.first) - 1);
+    std::strncpy(header.second, T::getTypeNames().second, sizeof(header.second) - 1);
+    header.value_size = sizeof(T);
+    header.rows = rows;
+    header.columns = columns;
+    header.eps = eps;
+    header.non_zeros = non_zeros;
+    return header;
+}
+
+/**
+ * @brief Проверка двоичного файла: сигнатура, тип элементов, количество координат и размер
+ *
+ * @tparam T ожидаемый тип элементов
+ * @param[in] file отображенный в память файл
+ * @param[in] dimensions ожидаемое количество координат
+ * @return указатель на заголовок или nullptr, если файл не подходит
+ */
+template <typename T>
+const Binary_header *checkBinaryFile(const Mapped_file &file, uint16_t dimensions)
+{
+    if (!file.is_open() || file.size() < sizeof(Binary_header))
+        return nullptr;
+
+    const Binary_header *header = reinterpret_cast<const Binary_header *>(file.data());
+    Binary_header expected = makeBinaryHeader<T>(dimensions, 0, 0, 0, 0);
+    if (std::memcmp(header->magic, expected.magic, 4) != 0 || header->version != expected.version ||
+        header->dimensions != dimensions || header->value_size != sizeof(T) ||
+        std::strncmp(header->type, expected.type, sizeof(header->type)) != 0 ||
+        std::strncmp(header->first, expected.first, sizeof(header->first)) != 0 ||
+        std::strncmp(header->second, expected.second, sizeof(header->second)) != 0)
+        return nullptr;
+
+    uint64_t required = sizeof(Binary_header) + header->non_zeros * (dimensions * sizeof(uint64_t) + sizeof(T));
+    if (header->non_zeros > file.size() || file.size() < required)
+        return nullptr;
+    return header;
+}
+
+/**
+ * @brief Запись двоичного файла: заголовок, затем блоки данных подряд
+ *
+ * @param[in] filename имя файла
+ * @param[in] header заголовок
+ * @param[in] blocks блоки данных (указатель, размер в байтах)
+ * @return false, если запись не удалась
+ */
+bool writeBinaryFile(const std::string &filename, const Binary_header &header, const std::vector<std::pair<const void *, uint64_t>> &blocks);
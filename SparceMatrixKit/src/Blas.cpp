@@ -0,0 +1,181 @@
+#include "Blas.h"
+
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using Complex_double = Complex_number<double, double>;
+
+// Комплексное число рассматривается как пара (re, im) подряд идущих double
+static_assert(sizeof(Complex_double) == 2 * sizeof(double) && std::is_standard_layout<Complex_double>::value,
+              "Complex_number<double, double> must be two packed doubles");
+
+static const double *asDoubles(const Complex_double *x)
+{
+    return reinterpret_cast<const double *>(x);
+}
+
+static double *asDoubles(Complex_double *x)
+{
+    return reinterpret_cast<double *>(x);
+}
+
+#if defined(__SSE2__)
+
+/**
+ * @brief Перестановка половин регистра: (a, b) -> (b, a)
+ */
+static inline __m128d swapHalves(__m128d value)
+{
+    return _mm_shuffle_pd(value, value, 1);
+}
+
+/**
+ * @brief Сумма половин регистра
+ */
+static inline double sumHalves(__m128d value)
+{
+    return _mm_cvtsd_f64(_mm_add_sd(value, _mm_unpackhi_pd(value, value)));
+}
+
+/**
+ * @brief Разность половин регистра (нижняя минус верхняя)
+ */
+static inline double differenceHalves(__m128d value)
+{
+    return _mm_cvtsd_f64(_mm_sub_sd(value, _mm_unpackhi_pd(value, value)));
+}
+
+Complex_double denseDot(const Complex_double *x, const Complex_double *y, size_t n)
+{
+    const double *a = asDoubles(x);
+    const double *b = asDoubles(y);
+
+    // direct = (xr * yr, xi * yi), cross = (xr * yi, xi * yr); две независимые цепочки сложений
+    __m128d direct_0 = _mm_setzero_pd(), direct_1 = _mm_setzero_pd();
+    __m128d cross_0 = _mm_setzero_pd(), cross_1 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 1 < n; i += 2)
+    {
+        __m128d x_0 = _mm_loadu_pd(a + 2 * i), y_0 = _mm_loadu_pd(b + 2 * i);
+        __m128d x_1 = _mm_loadu_pd(a + 2 * i + 2), y_1 = _mm_loadu_pd(b + 2 * i + 2);
+        direct_0 = _mm_add_pd(direct_0, _mm_mul_pd(x_0, y_0));
+        cross_0 = _mm_add_pd(cross_0, _mm_mul_pd(x_0, swapHalves(y_0)));
+        direct_1 = _mm_add_pd(direct_1, _mm_mul_pd(x_1, y_1));
+        cross_1 = _mm_add_pd(cross_1, _mm_mul_pd(x_1, swapHalves(y_1)));
+    }
+    if (i < n)
+    {
+        __m128d x_0 = _mm_loadu_pd(a + 2 * i), y_0 = _mm_loadu_pd(b + 2 * i);
+        direct_0 = _mm_add_pd(direct_0, _mm_mul_pd(x_0, y_0));
+        cross_0 = _mm_add_pd(cross_0, _mm_mul_pd(x_0, swapHalves(y_0)));
+    }
+
+    // conj(x) * y = (xr * yr + xi * yi) + i (xr * yi - xi * yr)
+    return Complex_double(sumHalves(_mm_add_pd(direct_0, direct_1)), differenceHalves(_mm_add_pd(cross_0, cross_1)));
+}
+
+double denseSquaredNorm(const Complex_double *x, size_t n)
+{
+    const double *a = asDoubles(x);
+
+    __m128d sum_0 = _mm_setzero_pd(), sum_1 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 1 < n; i += 2)
+    {
+        __m128d x_0 = _mm_loadu_pd(a + 2 * i), x_1 = _mm_loadu_pd(a + 2 * i + 2);
+        sum_0 = _mm_add_pd(sum_0, _mm_mul_pd(x_0, x_0));
+        sum_1 = _mm_add_pd(sum_1, _mm_mul_pd(x_1, x_1));
+    }
+    if (i < n)
+    {
+        __m128d x_0 = _mm_loadu_pd(a + 2 * i);
+        sum_0 = _mm_add_pd(sum_0, _mm_mul_pd(x_0, x_0));
+    }
+    return sumHalves(_mm_add_pd(sum_0, sum_1));
+}
+
+void denseAxpy(const Complex_double &alpha, const Complex_double *x, Complex_double *y, size_t n)
+{
+    const double *a = asDoubles(x);
+    double *b = asDoubles(y);
+
+    // alpha * x = (ar, ar) * (xr, xi) + (-ai, ai) * (xi, xr)
+    __m128d alpha_re = _mm_set1_pd(alpha.getReal());
+    __m128d alpha_im = _mm_set_pd(alpha.getImag(), -alpha.getImag());
+    for (size_t i = 0; i < n; ++i)
+    {
+        __m128d value = _mm_loadu_pd(a + 2 * i);
+        __m128d product = _mm_add_pd(_mm_mul_pd(alpha_re, value), _mm_mul_pd(alpha_im, swapHalves(value)));
+        _mm_storeu_pd(b + 2 * i, _mm_add_pd(_mm_loadu_pd(b + 2 * i), product));
+    }
+}
+
+void denseScal(const Complex_double &alpha, Complex_double *x, size_t n)
+{
+    double *a = asDoubles(x);
+
+    __m128d alpha_re = _mm_set1_pd(alpha.getReal());
+    __m128d alpha_im = _mm_set_pd(alpha.getImag(), -alpha.getImag());
+    for (size_t i = 0; i < n; ++i)
+    {
+        __m128d value = _mm_loadu_pd(a + 2 * i);
+        _mm_storeu_pd(a + 2 * i, _mm_add_pd(_mm_mul_pd(alpha_re, value), _mm_mul_pd(alpha_im, swapHalves(value))));
+    }
+}
+
+#else
+
+Complex_double denseDot(const Complex_double *x, const Complex_double *y, size_t n)
+{
+    const double *a = asDoubles(x);
+    const double *b = asDoubles(y);
+
+    double re = 0, im = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        re += a[2 * i] * b[2 * i] + a[2 * i + 1] * b[2 * i + 1];
+        im += a[2 * i] * b[2 * i + 1] - a[2 * i + 1] * b[2 * i];
+    }
+    return Complex_double(re, im);
+}
+
+double denseSquaredNorm(const Complex_double *x, size_t n)
+{
+    const double *a = asDoubles(x);
+
+    double sum = 0;
+    for (size_t i = 0; i < 2 * n; ++i)
+        sum += a[i] * a[i];
+    return sum;
+}
+
+void denseAxpy(const Complex_double &alpha, const Complex_double *x, Complex_double *y, size_t n)
+{
+    const double *a = asDoubles(x);
+    double *b = asDoubles(y);
+
+    double re = alpha.getReal(), im = alpha.getImag();
+    for (size_t i = 0; i < n; ++i)
+    {
+        b[2 * i] += re * a[2 * i] - im * a[2 * i + 1];
+        b[2 * i + 1] += re * a[2 * i + 1] + im * a[2 * i];
+    }
+}
+
+void denseScal(const Complex_double &alpha, Complex_double *x, size_t n)
+{
+    double *a = asDoubles(x);
+
+    double re = alpha.getReal(), im = alpha.getImag();
+    for (size_t i = 0; i < n; ++i)
+    {
+        double value_re = a[2 * i];
+        a[2 * i] = re * value_re - im * a[2 * i + 1];
+        a[2 * i + 1] = re * a[2 * i + 1] + im * value_re;
+    }
+}
+
+#endif
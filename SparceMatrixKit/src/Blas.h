@@ -0,0 +1,91 @@
+#pragma once
+
+#include <iostream>
+#include "stdint.h"
+#include <cstddef>
+
+#include "Rational.h"
+#include "Complex.h"
+
+/*
+    Ядра BLAS-1 над непрерывными массивами (плотный режим Vector).
+    Шаблонные версии работают для любого типа элементов; для Complex_number<double, double>
+    есть перегрузки с векторными инструкциями (SSE2), реализованные в Blas.cpp.
+*/
+
+/**
+ * @brief Скалярное произведение sum(conj(x[i]) * y[i])
+ *
+ * @tparam T тип элементов
+ * @param[in] x первый массив
+ * @param[in] y второй массив
+ * @param[in] n количество элементов
+ * @return скалярное произведение
+ */
+template <typename T>
+T denseDot(const T *x, const T *y, size_t n)
+{
+    T sum = T();
+    for (size_t i = 0; i < n; ++i)
+        sum += x[i].conj() * y[i];
+    return sum;
+}
+
+/**
+ * @brief Сумма квадратов модулей sum(|x[i]|^2)
+ *
+ * @tparam T тип элементов
+ * @param[in] x массив
+ * @param[in] n количество элементов
+ * @return сумма квадратов модулей
+ */
+template <typename T>
+double denseSquaredNorm(const T *x, size_t n)
+{
+    double sum = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        double value = x[i].abs();
+        sum += value * value;
+    }
+    return sum;
+}
+
+/**
+ * @brief y[i] += alpha * x[i]
+ *
+ * @tparam T тип элементов
+ * @param[in] alpha множитель
+ * @param[in] x прибавляемый массив
+ * @param[in, out] y изменяемый массив
+ * @param[in] n количество элементов
+ */
+template <typename T>
+void denseAxpy(const T &alpha, const T *x, T *y, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        y[i] += alpha * x[i];
+}
+
+/**
+ * @brief x[i] *= alpha
+ *
+ * @tparam T тип элементов
+ * @param[in] alpha множитель
+ * @param[in, out] x изменяемый массив
+ * @param[in] n количество элементов
+ */
+template <typename T>
+void denseScal(const T &alpha, T *x, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        x[i] *= alpha;
+}
+
+Complex_number<double, double> denseDot(const Complex_number<double, double> *x, const Complex_number<double, double> *y, size_t n);
+
+double denseSquaredNorm(const Complex_number<double, double> *x, size_t n);
+
+void denseAxpy(const Complex_number<double, double> &alpha, const Complex_number<double, double> *x, Complex_number<double, double> *y, size_t n);
+
+void denseScal(const Complex_number<double, double> &alpha, Complex_number<double, double> *x, size_t n);
@@ -3,6 +3,7 @@
 #include <iostream>
 #include <type_traits>
 #include <cmath>
+#include "Other.h"
 #include "Rational.h"
 
 template <typename T>
@@ -42,6 +43,33 @@ public:
         return "complex";
     }
 
+    /**
+     * @brief Разбор числа из диапазона символов вида 'n , m' или 'k' без выделения памяти
+     *
+     * Если диапазон не разбирается, используется конструктор из строки с его обработкой ошибок.
+     *
+     * @param[in] first начало диапазона
+     * @param[in] last конец диапазона
+     * @return прочитанное число
+     */
+    static Complex_number<T, U> fromChars(const char *first, const char *last)
+    {
+        T re = 0;
+        U im = 0;
+        const char *p = scanNumber(skipSpaces(first, last), last, re);
+        if (p != nullptr)
+            p = skipSpaces(p, last);
+        if (p != nullptr && p != last && *p == ',')
+        {
+            p = scanNumber(skipSpaces(p + 1, last), last, im);
+            if (p != nullptr)
+                p = skipSpaces(p, last);
+        }
+        if (p != last)
+            return Complex_number<T, U>(std::string(first, last).c_str());
+        return Complex_number<T, U>(re, im);
+    }
+
     /**
      * @brief Конструктор
      *
@@ -96,6 +124,23 @@ public:
         this->imag = im;
     }
 
+    /**
+     * @brief Запись числа в виде 'n , m' или 'k' (формат файлов readFromFile)
+     *
+     * @tparam Writer тип буферизованного потока (Text_writer)
+     * @param[in, out] writer поток
+     */
+    template <typename Writer>
+    void writeTo(Writer &writer) const
+    {
+        writer.appendNumber(this->real);
+        if (this->imag != 0)
+        {
+            writer.append(" , ", 3);
+            writer.appendNumber(this->imag);
+        }
+    }
+
     /**
      * @brief Получить действительную часть числа
      *
@@ -132,22 +177,14 @@ public:
      * @param other
      * @return Complex_number<T, U>&
      */
-    Complex_number<T, U> &operator=(const Complex_number<T, U> &other)
-    {
-        if (this != &other)
-        {
-            this->real = other.getReal();
-            this->imag = other.getImag();
-        }
-        return *this;
-    }
+    Complex_number<T, U> &operator=(const Complex_number<T, U> &other) = default;
 
     /**
      * @brief Констуктор копирования
      *
      * @param other
      */
-    Complex_number(const Complex_number &other) : real(other.getReal()), imag(other.getImag()) {}
+    Complex_number(const Complex_number &other) = default;
 
     /**
      * @brief Перегрузка оператора сложения с комплексными числами
@@ -312,6 +349,16 @@ public:
         return Complex_number<T, U>(-this->real, -this->imag);
     }
 
+    /**
+     * @brief Комплексно сопряженное число
+     *
+     * @return Complex_number<T, U>
+     */
+    Complex_number<T, U> conj() const
+    {
+        return Complex_number<T, U>(this->real, -this->imag);
+    }
+
     /**
      * @brief Перегрузка оператора умножения на комплексные числа
      *
@@ -0,0 +1,937 @@
+#pragma once
+
+#include <iostream>
+#include "stdint.h"
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include <map>
+#include <unordered_map>
+#include <chrono>
+
+#include "Matrix.h"
+#include "Parallel.h"
+#include "Reader.h"
+#include "Binary.h"
+#include "Writer.h"
+
+/**
+ * @brief Неизменяемая разреженная матрица в сжатом построчном формате (CSR)
+ *
+ * Элементы строки i (нумерация с 1) лежат в column_indices / values на отрезке
+ * [row_offsets[i - 1], row_offsets[i]) и упорядочены по номеру столбца.
+ * По запросу дополнительно строится постолбцовый индекс (CSC), который ссылается
+ * на те же значения.
+ *
+ * @tparam T тип элементов матрицы
+ */
+template <typename T>
+class Matrix<Compressed_storage, T>
+{
+protected:
+    double eps;
+    std::pair<uint64_t, uint64_t> size;
+
+    std::vector<uint64_t> row_offsets;    /**< Границы строк (rows + 1 элемент) */
+    std::vector<uint64_t> column_indices; /**< Номера столбцов ненулевых элементов */
+    std::vector<T> values;                /**< Значения ненулевых элементов */
+
+    std::vector<uint64_t> column_offsets;   /**< Границы столбцов CSC (columns + 1 элемент, пусто если индекс не построен) */
+    std::vector<uint64_t> row_indices;      /**< Номера строк элементов в порядке CSC */
+    std::vector<uint64_t> column_positions; /**< Позиции элементов CSC в массиве values */
+
+    View_anchor<Matrix<Compressed_storage, T>> anchor; /**< Указатель на себя, на который ссылается транспонирование */
+
+    /**
+     * @brief Построение постолбцового индекса сортировкой подсчетом (за O(nnz + columns))
+     *
+     * @param[out] offsets границы столбцов (columns + 1 элемент)
+     * @param[out] rows номера строк элементов в порядке CSC
+     * @param[out] positions позиции элементов CSC в массиве values
+     */
+    void buildColumnIndex(std::vector<uint64_t> &offsets, std::vector<uint64_t> &rows, std::vector<uint64_t> &positions) const
+    {
+        offsets.assign(size.second + 1, 0);
+        for (uint64_t column : column_indices)
+            ++offsets[column];
+
+        for (uint64_t j = 1; j < offsets.size(); ++j)
+            offsets[j] += offsets[j - 1];
+
+        rows.resize(values.size());
+        positions.resize(values.size());
+        std::vector<uint64_t> position(offsets.begin(), offsets.end() - 1);
+        for (uint64_t i = 1; i < size.first + 1; ++i)
+        {
+            for (uint64_t k = row_offsets[i - 1]; k < row_offsets[i]; ++k)
+            {
+                uint64_t p = position[column_indices[k] - 1]++;
+                rows[p] = i;
+                positions[p] = k;
+            }
+        }
+    }
+
+public:
+    /*
+        =========================== Конструкторы ===========================
+    */
+
+    /**
+     * @brief Конструктор по умолчанию
+     *
+     */
+    Matrix() : eps(0), size(0, 0), row_offsets(1, 0) {}
+
+    /**
+     * @brief Конструктор пустой (нулевой) матрицы
+     *
+     * @param[in] rows количество строк в матрице
+     * @param[in] columns количество столбцов в матрице
+     * @param[in] epsilon eps (по умолчанию 0)
+     */
+    Matrix(uint64_t rows, uint64_t columns, double epsilon = 0) : eps(epsilon), size(rows, columns), row_offsets(rows + 1, 0) {}
+
+    /**
+     * @brief Конструктор из координатных массивов (COO): элементы упорядочиваются одной сортировкой
+     * и укладываются в CSR за один проход.
+     * Значения с одинаковыми координатами суммируются, суммы с модулем меньше eps не хранятся.
+     *
+     * @param[in] rows количество строк в матрице
+     * @param[in] columns количество столбцов в матрице
+     * @param[in] row_indices номера строк элементов
+     * @param[in] column_indices номера столбцов элементов
+     * @param[in] values значения элементов
+     * @param[in] epsilon eps (по умолчанию 0)
+     * @throws MatrixShapeError если массивы разной длины
+     * @throws MatrixIndexError если координаты вне размеров матрицы
+     */
+    Matrix(uint64_t rows, uint64_t columns, std::span<const uint64_t> row_indices, std::span<const uint64_t> column_indices, std::span<const T> values, double epsilon = 0)
+        : eps(epsilon), size(rows, columns), row_offsets(rows + 1, 0)
+    {
+        std::vector<Matrix_entry<T>> entries = assembleTriplets(size, row_indices, column_indices, values, eps);
+        this->column_indices.reserve(entries.size());
+        this->values.reserve(entries.size());
+        for (auto &entry : entries)
+        {
+            ++row_offsets[entry.first.first];
+            this->column_indices.push_back(entry.first.second);
+            this->values.push_back(std::move(entry.second));
+        }
+        for (uint64_t i = 1; i < row_offsets.size(); ++i)
+            row_offsets[i] += row_offsets[i - 1];
+    }
+
+    /**
+     * @brief Конструктор из заполненной матрицы на std::map или std::unordered_map
+     *
+     * Элементы вне размеров матрицы и элементы меньше eps исходной матрицы пропускаются.
+     *
+     * @tparam Container контейнер исходной матрицы
+     * @param[in] other исходная матрица
+     * @param[in] with_columns построить также постолбцовый индекс (CSC)
+     */
+    template <template <class, class...> class Container>
+    explicit Matrix(const Matrix<Container, T> &other, bool with_columns = false)
+        : eps(other.getEps()), size(other.shape()), row_offsets(other.shape().first + 1, 0)
+    {
+        // Нехранимые элементы с ненулевым fill в CSR переносятся явно
+        if (other.hasFill())
+        {
+            *this = Matrix(other.materialized(), with_columns);
+            return;
+        }
+
+        const auto &source = other.getData();
+        for (auto &entry : source)
+            if (inShape(entry.first.first, entry.first.second) && entry.second.abs() >= eps)
+                ++row_offsets[entry.first.first];
+
+        for (uint64_t i = 1; i < row_offsets.size(); ++i)
+            row_offsets[i] += row_offsets[i - 1];
+
+        column_indices.resize(row_offsets.back());
+        values.resize(row_offsets.back());
+
+        std::vector<uint64_t> position(row_offsets.begin(), row_offsets.end() - 1);
+        for (auto &entry : source)
+        {
+            if (inShape(entry.first.first, entry.first.second) && entry.second.abs() >= eps)
+            {
+                uint64_t p = position[entry.first.first - 1]++;
+                column_indices[p] = entry.first.second;
+                values[p] = entry.second;
+            }
+        }
+
+        // std::map уже упорядочен по (строка, столбец), строки из хэш-таблицы нужно упорядочить
+        sortRows();
+
+        if (with_columns)
+            buildColumnIndex(column_offsets, row_indices, column_positions);
+    }
+
+    /*
+        =========================== Getter ===========================
+    */
+
+    /**
+     * @brief Получение размера матрицы
+     *
+     * @return пара (кол-во строк, кол-во столбцов)
+     */
+    const std::pair<uint64_t, uint64_t> &shape() const
+    {
+        return size;
+    }
+
+    /**
+     * @brief Получение значение eps
+     *
+     * @return eps
+     */
+    const double &getEps() const
+    {
+        return eps;
+    }
+
+    /**
+     * @brief Количество хранимых (ненулевых) элементов
+     *
+     * @return nnz
+     */
+    uint64_t nonZeros() const
+    {
+        return values.size();
+    }
+
+    /**
+     * @brief Границы строк в массивах column_indices и values
+     *
+     * @return массив из rows + 1 элемента
+     */
+    const std::vector<uint64_t> &getRowOffsets() const
+    {
+        return row_offsets;
+    }
+
+    /**
+     * @brief Номера столбцов ненулевых элементов в построчном порядке
+     *
+     * @return массив номеров столбцов
+     */
+    const std::vector<uint64_t> &getColumnIndices() const
+    {
+        return column_indices;
+    }
+
+    /**
+     * @brief Значения ненулевых элементов в построчном порядке
+     *
+     * @return массив значений
+     */
+    const std::vector<T> &getValues() const
+    {
+        return values;
+    }
+
+    /**
+     * @brief Построен ли постолбцовый индекс (CSC)
+     *
+     * @return true если индекс построен
+     */
+    bool hasColumnIndex() const
+    {
+        return !column_offsets.empty();
+    }
+
+    /**
+     * @brief Границы столбцов в постолбцовом индексе
+     *
+     * @return массив из columns + 1 элемента (пустой, если индекс не построен)
+     */
+    const std::vector<uint64_t> &getColumnOffsets() const
+    {
+        return column_offsets;
+    }
+
+    /**
+     * @brief Номера строк ненулевых элементов в постолбцовом порядке
+     *
+     * @return массив номеров строк
+     */
+    const std::vector<uint64_t> &getRowIndices() const
+    {
+        return row_indices;
+    }
+
+    /**
+     * @brief Позиции элементов постолбцового индекса в массиве значений
+     *
+     * @return массив позиций в getValues()
+     */
+    const std::vector<uint64_t> &getColumnPositions() const
+    {
+        return column_positions;
+    }
+
+    /**
+     * @brief Получение элемента по заданным координатам (двоичный поиск в строке)
+     *
+     * @param[in] row номер строки
+     * @param[in] column номер столбца
+     * @return константная ссылка на элемент по заданным координатам
+     */
+    const T &at(uint64_t row, uint64_t column) const
+    {
+        static const T zero;
+        if (row < 1 || row > size.first)
+            return zero;
+
+        auto first = column_indices.begin() + row_offsets[row - 1];
+        auto last = column_indices.begin() + row_offsets[row];
+        auto it = std::lower_bound(first, last, column);
+        if (it == last || *it != column)
+            return zero;
+        return values[it - column_indices.begin()];
+    }
+
+    /**
+     * @brief Оператор () для доступа к элементу матрицы по индексам.
+     * @param row Номер строки.
+     * @param column Номер столбца.
+     * @return Ссылка на элемент матрицы в позиции (row, column).
+     * @throws MatrixIndexError Если индексы выходят за пределы размеров матрицы.
+     */
+    const T &operator()(uint64_t row, uint64_t column) const
+    {
+        if (row < 1 || row > size.first || column < 1 || column > size.second)
+        {
+            throw MatrixIndexError("", __FILE__, __LINE__, "operator ()", size, {row, column});
+        }
+        return this->at(row, column);
+    }
+
+    /*
+        =========================== Арифметические операции ===========================
+    */
+
+    /**
+     * @brief Перегрузка оператора умножения для матриц (построчный алгоритм Gustavson).
+     * @param[in] other Матрица.
+     * @return Новая матрица, являющаяся результатом умножения.
+     */
+    Matrix<Compressed_storage, T> operator*(const Matrix<Compressed_storage, T> &other) const
+    {
+        return multiply(other, Parallel_policy(1));
+    }
+
+    /**
+     * @brief Параллельное умножение матриц.
+     * Строки делятся на части с равным числом умножений; каждая часть вычисляется отдельным потоком
+     * тем же алгоритмом, что и последовательно, поэтому результат не зависит от числа потоков.
+     * @param[in] other Матрица.
+     * @param[in] policy политика параллельного выполнения
+     * @return Новая матрица, являющаяся результатом умножения.
+     */
+    Matrix<Compressed_storage, T> multiply(const Matrix<Compressed_storage, T> &other, const Parallel_policy &policy) const
+    {
+        if (size.second != other.shape().first)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator *", size, other.shape());
+
+        Matrix<Compressed_storage, T> result(size.first, other.shape().second, eps);
+
+        // Работа строки i - количество умножений a_ik * b_kj плюс число элементов строки
+        std::vector<uint64_t> work(size.first + 1, 0);
+        for (uint64_t i = 1; i < size.first + 1; ++i)
+        {
+            work[i] = work[i - 1] + row_offsets[i] - row_offsets[i - 1];
+            for (uint64_t a = row_offsets[i - 1]; a < row_offsets[i]; ++a)
+                work[i] += other.row_offsets[column_indices[a]] - other.row_offsets[column_indices[a] - 1];
+        }
+
+        std::vector<uint64_t> bounds = partitionByWork(work, policy.threads);
+        std::vector<Matrix<Compressed_storage, T>> parts(bounds.size() - 1);
+
+        Thread_pool::shared().run(parts.size(), [&](size_t part)
+                                  { multiplyRows(other, bounds[part], bounds[part + 1], parts[part]); });
+
+        for (size_t part = 0; part < parts.size(); ++part)
+        {
+            uint64_t base = result.values.size();
+            for (uint64_t i = bounds[part] + 1; i < bounds[part + 1] + 1; ++i)
+                result.row_offsets[i] = base + parts[part].row_offsets[i - bounds[part]];
+
+            result.column_indices.insert(result.column_indices.end(), parts[part].column_indices.begin(), parts[part].column_indices.end());
+            result.values.insert(result.values.end(), std::make_move_iterator(parts[part].values.begin()), std::make_move_iterator(parts[part].values.end()));
+        }
+        return result;
+    }
+
+    /**
+     * @brief Перегрузка оператора транспонирования (сортировка подсчетом по столбцам, за O(nnz + columns)).
+     * @return Транспонированная матрица.
+     */
+    Matrix<Compressed_storage, T> operator~() const
+    {
+        Matrix<Compressed_storage, T> result(size.second, size.first, eps);
+
+        std::vector<uint64_t> positions;
+        if (hasColumnIndex())
+        {
+            result.row_offsets = column_offsets;
+            result.column_indices = row_indices;
+        }
+        else
+            buildColumnIndex(result.row_offsets, result.column_indices, positions);
+
+        const std::vector<uint64_t> &order = hasColumnIndex() ? column_positions : positions;
+        result.values.reserve(values.size());
+        for (uint64_t position : order)
+            result.values.push_back(values[position]);
+        return result;
+    }
+
+    /**
+     * @brief Транспонированное представление матрицы без копирования элементов.
+     * Представление хранит слабую ссылку на матрицу и после ее удаления бросает ProxyPointerError.
+     * @return Ленивое транспонирование.
+     */
+    Matrix_transposed<Compressed_storage, T> transposed() const
+    {
+        return Matrix_transposed<Compressed_storage, T>(anchor.get(this));
+    }
+
+    /**
+     * @brief Произведение транспонированной матрицы на матрицу (this^T * other) по постолбцовому индексу.
+     * Если индекс не был построен, строится только индекс (без копирования значений).
+     * @param[in] other Матрица.
+     * @return Новая матрица, являющаяся результатом умножения.
+     */
+    Matrix<Compressed_storage, T> multiplyTransposed(const Matrix<Compressed_storage, T> &other) const
+    {
+        if (size.first != other.shape().first)
+            throw MatrixShapeError("", __FILE__, __LINE__, "transposed operator *", std::make_pair(size.second, size.first), other.shape());
+
+        std::vector<uint64_t> offsets, rows, positions;
+        if (!hasColumnIndex())
+            buildColumnIndex(offsets, rows, positions);
+
+        const std::vector<uint64_t> &a_offsets = hasColumnIndex() ? column_offsets : offsets;
+        const std::vector<uint64_t> &a_rows = hasColumnIndex() ? row_indices : rows;
+        const std::vector<uint64_t> &a_positions = hasColumnIndex() ? column_positions : positions;
+
+        Matrix<Compressed_storage, T> result(size.second, other.shape().second, eps);
+
+        std::vector<T> accumulator(other.shape().second + 1);
+        std::vector<bool> occupied(other.shape().second + 1, false);
+        std::vector<uint64_t> columns;
+
+        for (uint64_t i = 1; i < size.second + 1; ++i)
+        {
+            for (uint64_t a = a_offsets[i - 1]; a < a_offsets[i]; ++a)
+            {
+                uint64_t k = a_rows[a];
+                const T &value = values[a_positions[a]];
+                for (uint64_t b = other.row_offsets[k - 1]; b < other.row_offsets[k]; ++b)
+                {
+                    uint64_t column = other.column_indices[b];
+                    if (occupied[column])
+                        accumulator[column] += value * other.values[b];
+                    else
+                    {
+                        occupied[column] = true;
+                        accumulator[column] = value * other.values[b];
+                        columns.push_back(column);
+                    }
+                }
+            }
+
+            std::sort(columns.begin(), columns.end());
+            for (uint64_t column : columns)
+            {
+                if (accumulator[column].abs() >= eps)
+                {
+                    result.column_indices.push_back(column);
+                    result.values.push_back(accumulator[column]);
+                }
+                occupied[column] = false;
+            }
+            columns.clear();
+            result.row_offsets[i] = result.values.size();
+        }
+        return result;
+    }
+
+    /**
+     * @brief Перегрузка оператора унарного минуса.
+     * @return Новая матрица, являющаяся результатом инверсии знака всех элементов текущей матрицы.
+     */
+    Matrix<Compressed_storage, T> operator-() const
+    {
+        Matrix<Compressed_storage, T> result(*this);
+        for (auto &value : result.values)
+            value = -value;
+        return result;
+    }
+
+    /*
+        =========================== Умножение на вектор ===========================
+    */
+
+    /**
+     * @brief Перегрузка оператора умножения матрицы на вектор (один проход по строкам).
+     * Произведение вычисляется отложенно, при присваивании вектору (см. Expression.h).
+     *
+     * @param[in] other вектор
+     * @return Выражение - произведение матрицы на вектор
+     */
+    Matrix_vector_product<Matrix<Compressed_storage, T>, T> operator*(const Vector<T> &other) const &
+    {
+        if (static_cast<uint64_t>(other.getLen()) != size.second)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator * vector", size, std::make_pair(other.getLen(), 1));
+        return makeMatrixVectorProduct<T>(*this, other);
+    }
+
+    /**
+     * @brief Умножение на временный вектор: вектор перемещается в выражение, поэтому его можно
+     * сохранить (auto y = A * Vector<T>(n))
+     *
+     * @param[in] other вектор
+     * @return Выражение, хранящее вектор
+     */
+    auto operator*(Vector<T> &&other) const &
+    {
+        if (static_cast<uint64_t>(other.getLen()) != size.second)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator * vector", size, std::make_pair(other.getLen(), 1));
+        return makeMatrixVectorProduct<T>(*this, std::move(other));
+    }
+
+    /**
+     * @brief Умножение на вектор временного объекта: матрица перемещается в выражение
+     *
+     * @param[in] other вектор
+     * @return Выражение, хранящее матрицу
+     */
+    auto operator*(const Vector<T> &other) &&
+    {
+        if (static_cast<uint64_t>(other.getLen()) != size.second)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator * vector", size, std::make_pair(other.getLen(), 1));
+        return makeMatrixVectorProduct<T>(std::move(*this), other);
+    }
+
+    /**
+     * @brief Умножение временного объекта на временный вектор: оба операнда перемещаются в выражение
+     *
+     * @param[in] other вектор
+     * @return Выражение, хранящее оба операнда
+     */
+    auto operator*(Vector<T> &&other) &&
+    {
+        if (static_cast<uint64_t>(other.getLen()) != size.second)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator * vector", size, std::make_pair(other.getLen(), 1));
+        return makeMatrixVectorProduct<T>(std::move(*this), std::move(other));
+    }
+
+    /**
+     * @brief Умножение матрицы на вектор с записью в заданный вектор.
+     * Строки результата перебираются по возрастанию, поэтому уже существующие узлы result переиспользуются.
+     *
+     * @param[in] other вектор
+     * @param[out] result вектор для записи произведения (используется его eps)
+     */
+    void multiply(const Vector<T> &other, Vector<T> &result) const
+    {
+        if (static_cast<uint64_t>(other.getLen()) != size.second)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator * vector", size, std::make_pair(other.getLen(), 1));
+
+        if (&other == &result)
+        {
+            Vector<T> copy(other);
+            multiply(copy, result);
+            return;
+        }
+
+        auto out = result.beginOrdered(size.first);
+        for (uint64_t i = 1; i < size.first + 1; ++i)
+        {
+            if (row_offsets[i - 1] == row_offsets[i])
+                continue;
+
+            T sum = T();
+            for (uint64_t k = row_offsets[i - 1]; k < row_offsets[i]; ++k)
+                sum += values[k] * other.at(column_indices[k]);
+            result.writeOrdered(out, static_cast<int>(i), sum);
+        }
+        result.endOrdered(out);
+    }
+
+    /**
+     * @brief Прибавление alpha * this * other к накопителю отложенного выражения
+     *
+     * @param[in] alpha множитель
+     * @param[in] other вектор
+     * @param[in, out] result накопитель
+     */
+    void multiplyAdd(const T &alpha, const Vector<T> &other, Vector_accumulator<T> &result) const
+    {
+        for (uint64_t i = 1; i < size.first + 1; ++i)
+        {
+            if (row_offsets[i - 1] == row_offsets[i])
+                continue;
+
+            T sum = T();
+            for (uint64_t k = row_offsets[i - 1]; k < row_offsets[i]; ++k)
+                sum += values[k] * other.at(column_indices[k]);
+            result.add(static_cast<int>(i), alpha * sum);
+        }
+    }
+
+    /**
+     * @brief Параллельное умножение матрицы на вектор.
+     *
+     * @param[in] other вектор
+     * @param[in] policy политика параллельного выполнения
+     * @return Вектор, являющийся произведением матрицы на вектор
+     */
+    Vector<T> multiply(const Vector<T> &other, const Parallel_policy &policy) const
+    {
+        Vector<T> result(size.first);
+        multiply(other, result, policy);
+        return result;
+    }
+
+    /**
+     * @brief Параллельное умножение матрицы на вектор с записью в заданный вектор.
+     * Строки делятся между потоками по числу ненулевых элементов; каждая строка суммируется
+     * в том же порядке, что и последовательно, поэтому результат не зависит от числа потоков.
+     *
+     * @param[in] other вектор
+     * @param[out] result вектор для записи произведения (используется его eps)
+     * @param[in] policy политика параллельного выполнения
+     */
+    void multiply(const Vector<T> &other, Vector<T> &result, const Parallel_policy &policy) const
+    {
+        if (static_cast<uint64_t>(other.getLen()) != size.second)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator * vector", size, std::make_pair(other.getLen(), 1));
+
+        if (&other == &result)
+        {
+            Vector<T> copy(other);
+            multiply(copy, result, policy);
+            return;
+        }
+
+        std::vector<uint64_t> bounds = partitionByWork(row_offsets, policy.threads);
+        std::vector<T> sums(size.first + 1);
+
+        Thread_pool::shared().run(bounds.size() - 1, [&](size_t part)
+                                  {
+            for (uint64_t i = bounds[part] + 1; i < bounds[part + 1] + 1; ++i)
+            {
+                T sum = T();
+                for (uint64_t k = row_offsets[i - 1]; k < row_offsets[i]; ++k)
+                    sum += values[k] * other.at(column_indices[k]);
+                sums[i] = sum;
+            } });
+
+        auto out = result.beginOrdered(size.first);
+        for (uint64_t i = 1; i < size.first + 1; ++i)
+            if (row_offsets[i - 1] != row_offsets[i])
+                result.writeOrdered(out, static_cast<int>(i), sums[i]);
+        result.endOrdered(out);
+    }
+
+    /**
+     * @brief Произведение транспонированной матрицы на вектор (this^T * other).
+     * Перебираются только ненулевые элементы other и соответствующие им строки матрицы.
+     * @param[in] other Вектор.
+     * @return Вектор, являющийся результатом умножения.
+     */
+    Vector<T> multiplyTransposed(const Vector<T> &other) const
+    {
+        Vector<T> result(size.second);
+        multiplyTransposed(other, result);
+        return result;
+    }
+
+    /**
+     * @brief Произведение транспонированной матрицы на вектор с записью в заданный вектор.
+     *
+     * @param[in] other вектор
+     * @param[out] result вектор для записи произведения (используется его eps)
+     */
+    void multiplyTransposed(const Vector<T> &other, Vector<T> &result) const
+    {
+        if (static_cast<uint64_t>(other.getLen()) != size.first)
+            throw MatrixShapeError("", __FILE__, __LINE__, "transposed operator * vector", std::make_pair(size.second, size.first), std::make_pair(other.getLen(), 1));
+
+        if (&other == &result)
+        {
+            Vector<T> copy(other);
+            multiplyTransposed(copy, result);
+            return;
+        }
+
+        result.resetValues(size.second);
+        other.forEachStored([this, &result](int index, const T &value)
+                            {
+            if (index < 1 || static_cast<uint64_t>(index) > size.first)
+                return;
+
+            for (uint64_t k = row_offsets[index - 1]; k < row_offsets[index]; ++k)
+                result.element(static_cast<int>(column_indices[k])) += values[k] * value; });
+        result.compactValues();
+    }
+
+    /*
+        =========================== Прочее ===========================
+    */
+
+    /**
+     * @brief Преобразование матрицы к строке
+     *
+     * @return Матрица приведенная к строке.
+     */
+    std::string to_string() const
+    {
+        static const T zero;
+        std::string result;
+        for (uint64_t i = 1; i < size.first + 1; ++i)
+        {
+            uint64_t k = row_offsets[i - 1];
+            for (uint64_t j = 1; j < size.second + 1; ++j)
+            {
+                if (k < row_offsets[i] && column_indices[k] == j)
+                    result += values[k++].to_string() + " ";
+                else
+                    result += zero.to_string() + " ";
+            }
+            result += "\n";
+        }
+        return result;
+    }
+
+    /*
+        =========================== Чтение с потока ===========================
+    */
+
+    /**
+     * @brief Параллельное чтение матрицы с файла сразу в сжатый формат
+     *
+     * Части файла разбираются отдельными потоками в координатные буферы, которые упорядочиваются
+     * по (строка, столбец) и укладываются в CSR без промежуточного словаря. Элементы вне размеров
+     * матрицы пропускаются, при повторе координат остается последний в файле элемент.
+     *
+     * @param[in] filename имя файла
+     * @param[in] policy политика параллельного выполнения
+     * @param[out] stats статистика чтения (размер, количество элементов, время), если не nullptr
+     * @return Прочитанная матрица
+     */
+    static Matrix<Compressed_storage, T> readFromFile(std::string &&filename, const Parallel_policy &policy = Parallel_policy(), Read_stats *stats = nullptr)
+    {
+        auto start = std::chrono::steady_clock::now();
+        Mapped_file file(filename);
+        if (!file.is_open())
+            throw MatrixReadFromFileError("", __FILE__, __LINE__);
+
+        Line_scanner scanner(file.data(), file.data() + file.size());
+        uint64_t rows, columns;
+        readMatrixHeader<T>(scanner, rows, columns);
+
+        Matrix<Compressed_storage, T> result(rows, columns);
+
+        std::vector<std::vector<Matrix_entry<T>>> chunks;
+        uint64_t entries = readMatrixEntries<T>(scanner.position(), file.data() + file.size(), result.eps, policy, chunks);
+
+        std::vector<Matrix_entry<T>> sorted = sortEntries(chunks);
+        result.column_indices.reserve(sorted.size());
+        result.values.reserve(sorted.size());
+        for (size_t k = 0; k < sorted.size(); ++k)
+        {
+            uint64_t row = sorted[k].first.first, column = sorted[k].first.second;
+            if ((k + 1 == sorted.size() || sorted[k].first != sorted[k + 1].first) && result.inShape(row, column))
+            {
+                ++result.row_offsets[row];
+                result.column_indices.push_back(column);
+                result.values.push_back(std::move(sorted[k].second));
+            }
+        }
+
+        for (uint64_t i = 1; i < result.row_offsets.size(); ++i)
+            result.row_offsets[i] += result.row_offsets[i - 1];
+
+        if (stats != nullptr)
+            *stats = Read_stats{file.size(), entries, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+        return result;
+    }
+
+    /**
+     * @brief Запись матрицы в двоичный файл (заголовок, упорядоченные координаты и значения)
+     *
+     * @param[in] filename имя файла
+     * @throws MatrixWriteToFileError если запись не удалась
+     */
+    void writeToBinaryFile(std::string &&filename) const
+    {
+        std::vector<uint64_t> rows(values.size());
+        for (uint64_t i = 1; i < size.first + 1; ++i)
+            std::fill(rows.begin() + row_offsets[i - 1], rows.begin() + row_offsets[i], i);
+
+        Binary_header header = makeBinaryHeader<T>(2, size.first, size.second, eps, values.size());
+        if (!writeBinaryFile(filename, header, {{rows.data(), rows.size() * sizeof(uint64_t)}, {column_indices.data(), column_indices.size() * sizeof(uint64_t)}, {values.data(), values.size() * sizeof(T)}}))
+            throw MatrixWriteToFileError("", __FILE__, __LINE__);
+    }
+
+    /**
+     * @brief Чтение матрицы из двоичного файла: массивы столбцов и значений копируются целиком,
+     * границы строк считаются по массиву строк (координаты проверяются при открытии отображения)
+     *
+     * @param[in] filename имя файла, записанного writeToBinaryFile
+     * @return Прочитанная матрица
+     * @throws MatrixReadFromFileError если файл не содержит матрицу типа T
+     */
+    static Matrix<Compressed_storage, T> readFromBinaryFile(std::string &&filename)
+    {
+        auto view = Matrix<Mapped_storage, T>::readFromBinaryFile(std::move(filename));
+        Matrix<Compressed_storage, T> result(view.shape().first, view.shape().second, view.getEps());
+
+        auto rows = view.getRowIndices();
+        auto columns = view.getColumnIndices();
+        auto values = view.getValues();
+        for (uint64_t row : rows)
+            ++result.row_offsets[row];
+        for (uint64_t i = 1; i < result.row_offsets.size(); ++i)
+            result.row_offsets[i] += result.row_offsets[i - 1];
+
+        result.column_indices.assign(columns.begin(), columns.end());
+        result.values.assign(values.begin(), values.end());
+        return result;
+    }
+
+    /**
+     * @brief Потоковая запись матрицы в текстовом формате readFromFile: записываются только хранимые
+     * элементы, текст формируется в буфере фиксированного размера (время O(nnz), память O(1))
+     *
+     * @param[in, out] out поток вывода
+     * @throws MatrixWriteToFileError если запись в поток не удалась
+     */
+    void writeToFile(std::ostream &out) const
+    {
+        {
+            Text_writer writer(out);
+            writeHeader<T>(writer, "matrix", {size.first, size.second});
+            for (uint64_t i = 1; i < size.first + 1; ++i)
+                for (uint64_t k = row_offsets[i - 1]; k < row_offsets[i]; ++k)
+                    writeEntry(writer, {i, column_indices[k]}, values[k]);
+        }
+        if (!out)
+            throw MatrixWriteToFileError("", __FILE__, __LINE__);
+    }
+
+    /**
+     * @brief Запись матрицы в текстовый файл (см. writeToFile(std::ostream &))
+     *
+     * @param[in] filename имя файла
+     * @throws MatrixWriteToFileError если файл не открывается или запись не удалась
+     */
+    void writeToFile(std::string &&filename) const
+    {
+        std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+            throw MatrixWriteToFileError("", __FILE__, __LINE__);
+        writeToFile(file);
+    }
+
+private:
+    /**
+     * @brief Вычисление строк (first, last] произведения this * other
+     *
+     * @param[in] other правый множитель
+     * @param[in] first строка перед первой вычисляемой строкой
+     * @param[in] last последняя вычисляемая строка
+     * @param[out] part матрица, строка r которой - строка first + r результата
+     */
+    void multiplyRows(const Matrix<Compressed_storage, T> &other, uint64_t first, uint64_t last, Matrix<Compressed_storage, T> &part) const
+    {
+        part.row_offsets.assign(last - first + 1, 0);
+
+        std::vector<T> accumulator(other.shape().second + 1);
+        std::vector<bool> occupied(other.shape().second + 1, false);
+        std::vector<uint64_t> columns;
+
+        for (uint64_t i = first + 1; i < last + 1; ++i)
+        {
+            for (uint64_t a = row_offsets[i - 1]; a < row_offsets[i]; ++a)
+            {
+                uint64_t k = column_indices[a];
+                for (uint64_t b = other.row_offsets[k - 1]; b < other.row_offsets[k]; ++b)
+                {
+                    uint64_t column = other.column_indices[b];
+                    if (occupied[column])
+                        accumulator[column] += values[a] * other.values[b];
+                    else
+                    {
+                        occupied[column] = true;
+                        accumulator[column] = values[a] * other.values[b];
+                        columns.push_back(column);
+                    }
+                }
+            }
+
+            std::sort(columns.begin(), columns.end());
+            for (uint64_t column : columns)
+            {
+                if (accumulator[column].abs() >= eps)
+                {
+                    part.column_indices.push_back(column);
+                    part.values.push_back(accumulator[column]);
+                }
+                occupied[column] = false;
+            }
+            columns.clear();
+            part.row_offsets[i - first] = part.values.size();
+        }
+    }
+
+    /**
+     * @brief Проверка, что координаты лежат в пределах матрицы
+     *
+     * @param[in] row номер строки
+     * @param[in] column номер столбца
+     * @return true если элемент принадлежит матрице
+     */
+    bool inShape(uint64_t row, uint64_t column) const
+    {
+        return 1 <= row && row <= size.first && 1 <= column && column <= size.second;
+    }
+
+    /**
+     * @brief Упорядочивание элементов каждой строки по номеру столбца
+     *
+     */
+    void sortRows()
+    {
+        std::vector<std::pair<uint64_t, T>> row;
+        for (uint64_t i = 1; i < size.first + 1; ++i)
+        {
+            uint64_t first = row_offsets[i - 1];
+            uint64_t last = row_offsets[i];
+            if (std::is_sorted(column_indices.begin() + first, column_indices.begin() + last))
+                continue;
+
+            row.clear();
+            for (uint64_t k = first; k < last; ++k)
+                row.emplace_back(column_indices[k], values[k]);
+
+            std::sort(row.begin(), row.end(), [](const auto &lhs, const auto &rhs)
+                      { return lhs.first < rhs.first; });
+
+            for (uint64_t k = first; k < last; ++k)
+            {
+                column_indices[k] = row[k - first].first;
+                values[k] = row[k - first].second;
+            }
+        }
+    }
+};
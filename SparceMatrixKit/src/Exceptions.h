@@ -283,4 +283,54 @@ private:
     const char *m_file;
     int m_line;
     mutable std::string errorMessage;
-};
\ No newline at end of file
+};
+
+class MatrixWriteToFileError : public std::exception
+{
+public:
+    MatrixWriteToFileError(
+        const std::string &message,
+        const char *file,
+        int line) : m_message(message), m_file(file), m_line(line) {}
+
+    const char *
+    what() const _GLIBCXX_TXN_SAFE_DYN _GLIBCXX_NOTHROW override
+    {
+        std::ostringstream oss;
+        oss << " Cannot write to file. " << m_file << " at line " << m_line << ": " << m_message << '\n';
+
+        errorMessage = oss.str();
+        return errorMessage.c_str();
+    }
+
+private:
+    std::string m_message;
+    const char *m_file;
+    int m_line;
+    mutable std::string errorMessage;
+};
+
+class VectorWriteToFileError : public std::exception
+{
+public:
+    VectorWriteToFileError(
+        const std::string &message,
+        const char *file,
+        int line) : m_message(message), m_file(file), m_line(line) {}
+
+    const char *
+    what() const _GLIBCXX_TXN_SAFE_DYN _GLIBCXX_NOTHROW override
+    {
+        std::ostringstream oss;
+        oss << " Cannot write to file. " << m_file << " at line " << m_line << ": " << m_message << '\n';
+
+        errorMessage = oss.str();
+        return errorMessage.c_str();
+    }
+
+private:
+    std::string m_message;
+    const char *m_file;
+    int m_line;
+    mutable std::string errorMessage;
+};
@@ -0,0 +1,364 @@
+#pragma once
+
+#include <iostream>
+#include "stdint.h"
+#include <vector>
+#include <string>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+/*
+    Отложенные выражения над векторами: A * x, u + v, u - v, u * alpha, -u.
+    Операторы не вычисляют результат, а строят дерево выражения; оно вычисляется за один проход
+    при присваивании вектору (конструктор или operator= класса Vector). Все слагаемые линейны,
+    поэтому вычисление сводится к накоплению alpha * (слагаемое) в одном Vector_accumulator:
+    промежуточные векторы не создаются, а каждый операнд просматривается один раз.
+
+    Узлы выражений хранят именованные векторы и матрицы по ссылке, поэтому выражение нужно вычислить
+    в той же инструкции, где оно построено (не сохранять его в auto-переменную дольше операндов).
+    Временные матрица и вектор произведения A * x перемещаются в узел и живут вместе с ним.
+*/
+
+template <typename T>
+class Vector;
+
+/**
+ * @brief Накопитель результата выражения: сумма вкладов (индекс, значение)
+ *
+ * Пока вкладов меньше длины вектора, они складываются в массив пар и упорядочиваются в конце,
+ * поэтому разреженное выражение не требует памяти O(len). Когда вкладов становится больше
+ * длины, накопитель переходит к плотному массиву.
+ *
+ * @tparam T тип элементов
+ */
+template <typename T>
+class Vector_accumulator
+{
+public:
+    /**
+     * @brief Конструктор
+     *
+     * @param[in] len длина вектора
+     * @param[in] dense сразу использовать плотный массив
+     */
+    Vector_accumulator(int len, bool dense) : len(len), dense(false)
+    {
+        if (dense)
+            toDense();
+    }
+
+    /**
+     * @brief Прибавление вклада к элементу
+     *
+     * @param[in] index индекс элемента (вклады вне 1..len отбрасываются)
+     * @param[in] value вклад
+     */
+    void add(int index, const T &value)
+    {
+        if (index < 1 || index > len)
+            return;
+
+        if (dense)
+        {
+            values[index - 1] += value;
+            return;
+        }
+
+        entries.emplace_back(index, value);
+        if (entries.size() > static_cast<size_t>(len))
+            toDense();
+    }
+
+    /**
+     * @brief Проверка плотного режима
+     *
+     */
+    bool isDense() const
+    {
+        return dense;
+    }
+
+    /**
+     * @brief Длина вектора
+     *
+     */
+    int getLen() const
+    {
+        return len;
+    }
+
+    /**
+     * @brief Обход сумм вкладов по возрастанию индексов (в плотном режиме - всех элементов)
+     *
+     * @param[in] visit функция, принимающая индекс и значение
+     */
+    template <typename Visitor>
+    void forEach(Visitor visit)
+    {
+        if (dense)
+        {
+            for (int i = 1; i < len + 1; ++i)
+                visit(i, values[i - 1]);
+            return;
+        }
+
+        // устойчивая сортировка сохраняет порядок сложения вкладов в элемент
+        std::stable_sort(entries.begin(), entries.end(), [](const auto &left, const auto &right)
+                         { return left.first < right.first; });
+        for (size_t k = 0; k < entries.size();)
+        {
+            int index = entries[k].first;
+            T sum = entries[k].second;
+            for (++k; k < entries.size() && entries[k].first == index; ++k)
+                sum += entries[k].second;
+            visit(index, sum);
+        }
+    }
+
+    /**
+     * @brief Плотный массив сумм (после toDense); элемент с индексом i лежит в [i - 1]
+     *
+     */
+    std::vector<T> &getValues()
+    {
+        return values;
+    }
+
+private:
+    int len;
+    bool dense;
+    std::vector<std::pair<int, T>> entries; /**< Вклады в разреженном режиме */
+    std::vector<T> values;                  /**< Суммы в плотном режиме */
+
+    void toDense()
+    {
+        values.assign(len, T());
+        for (auto &entry : entries)
+            values[entry.first - 1] += entry.second;
+        entries.clear();
+        entries.shrink_to_fit();
+        dense = true;
+    }
+};
+
+/**
+ * @brief Базовый класс отложенных векторных выражений (CRTP)
+ *
+ * Наследник реализует getLen(), isDense() (результат удобнее хранить плотно)
+ * и accumulate(accumulator, alpha), прибавляющий alpha * (значение выражения) к накопителю.
+ *
+ * @tparam Derived тип выражения
+ * @tparam T тип элементов
+ */
+template <typename Derived, typename T>
+class Vector_expression
+{
+public:
+    /**
+     * @brief Выражение как объект наследника
+     *
+     */
+    const Derived &self() const
+    {
+        return static_cast<const Derived &>(*this);
+    }
+
+    /**
+     * @brief Вычисление выражения
+     *
+     * @return вектор со значением выражения
+     */
+    Vector<T> eval() const
+    {
+        return Vector<T>(*this);
+    }
+
+    /**
+     * @brief Преобразование значения выражения к строке
+     *
+     */
+    std::string to_string() const
+    {
+        return eval().to_string();
+    }
+};
+
+/**
+ * @brief Способ хранения операнда в узле: вектор - по ссылке, вложенное выражение - по значению
+ *
+ */
+template <typename E, typename T>
+using Expression_operand = std::conditional_t<std::is_same_v<E, Vector<T>>, const Vector<T> &, E>;
+
+/**
+ * @brief Сумма или разность двух выражений
+ *
+ */
+template <typename Left, typename Right, typename T>
+class Vector_sum : public Vector_expression<Vector_sum<Left, Right, T>, T>
+{
+public:
+    /**
+     * @brief Конструктор
+     *
+     * @param[in] left первое слагаемое
+     * @param[in] right второе слагаемое
+     * @param[in] difference вычитать второе слагаемое
+     * @throws std::logic_error если длины слагаемых различны
+     */
+    Vector_sum(const Left &left, const Right &right, bool difference) : left(left), right(right), difference(difference)
+    {
+        if (left.getLen() != right.getLen())
+            throw std::logic_error("Cannot add vectors of different sizes");
+    }
+
+    int getLen() const
+    {
+        return left.getLen();
+    }
+
+    bool isDense() const
+    {
+        return left.isDense() || right.isDense();
+    }
+
+    void accumulate(Vector_accumulator<T> &result, const T &alpha) const
+    {
+        left.accumulate(result, alpha);
+        right.accumulate(result, difference ? -alpha : alpha);
+    }
+
+private:
+    Expression_operand<Left, T> left;
+    Expression_operand<Right, T> right;
+    bool difference;
+};
+
+/**
+ * @brief Выражение, умноженное на число
+ *
+ */
+template <typename E, typename T>
+class Vector_scaled : public Vector_expression<Vector_scaled<E, T>, T>
+{
+public:
+    /**
+     * @brief Конструктор
+     *
+     * @param[in] operand выражение
+     * @param[in] factor множитель
+     */
+    Vector_scaled(const E &operand, const T &factor) : operand(operand), factor(factor) {}
+
+    int getLen() const
+    {
+        return operand.getLen();
+    }
+
+    bool isDense() const
+    {
+        return operand.isDense();
+    }
+
+    void accumulate(Vector_accumulator<T> &result, const T &alpha) const
+    {
+        operand.accumulate(result, alpha * factor);
+    }
+
+private:
+    Expression_operand<E, T> operand;
+    T factor;
+};
+
+/**
+ * @brief Способ хранения операнда произведения: именованный объект - по ссылке, временный - по значению
+ *
+ * @tparam X тип аргумента, выведенный для ссылки X&& (для lvalue - ссылочный тип)
+ */
+template <typename X>
+using Product_operand = std::conditional_t<std::is_lvalue_reference_v<X>, const std::remove_reference_t<X> &, std::remove_cvref_t<X>>;
+
+/**
+ * @brief Произведение матрицы на вектор
+ *
+ * @tparam M тип матрицы (должен иметь shape() и multiplyAdd(alpha, vector, accumulator))
+ * @tparam Matrix_operand способ хранения матрицы (const M & или M)
+ * @tparam Vector_operand способ хранения вектора (const Vector<T> & или Vector<T>)
+ */
+template <typename M, typename T, typename Matrix_operand = const M &, typename Vector_operand = const Vector<T> &>
+class Matrix_vector_product : public Vector_expression<Matrix_vector_product<M, T, Matrix_operand, Vector_operand>, T>
+{
+public:
+    /**
+     * @brief Конструктор (размеры проверяет оператор умножения матрицы)
+     *
+     * @param[in] matrix матрица (временная перемещается в выражение)
+     * @param[in] vector вектор (временный перемещается в выражение)
+     */
+    template <typename Matrix_arg, typename Vector_arg>
+    Matrix_vector_product(Matrix_arg &&matrix, Vector_arg &&vector) : matrix(std::forward<Matrix_arg>(matrix)), vector(std::forward<Vector_arg>(vector)) {}
+
+    int getLen() const
+    {
+        return static_cast<int>(matrix.shape().first);
+    }
+
+    bool isDense() const
+    {
+        return false;
+    }
+
+    void accumulate(Vector_accumulator<T> &result, const T &alpha) const
+    {
+        matrix.multiplyAdd(alpha, vector, result);
+    }
+
+private:
+    Matrix_operand matrix;
+    Vector_operand vector;
+};
+
+/**
+ * @brief Построение произведения матрицы на вектор: именованные операнды хранятся по ссылке,
+ * временные перемещаются в выражение, поэтому его можно сохранить (auto y = A * Vector<T>(n))
+ *
+ * @tparam T тип элементов
+ * @param[in] matrix матрица
+ * @param[in] vector вектор
+ * @return Выражение - произведение матрицы на вектор
+ */
+template <typename T, typename Matrix_arg, typename Vector_arg>
+Matrix_vector_product<std::remove_cvref_t<Matrix_arg>, T, Product_operand<Matrix_arg>, Product_operand<Vector_arg>> makeMatrixVectorProduct(Matrix_arg &&matrix, Vector_arg &&vector)
+{
+    return Matrix_vector_product<std::remove_cvref_t<Matrix_arg>, T, Product_operand<Matrix_arg>, Product_operand<Vector_arg>>(std::forward<Matrix_arg>(matrix), std::forward<Vector_arg>(vector));
+}
+
+/*
+    =========================== Операторы ===========================
+*/
+
+template <typename Left, typename Right, typename T>
+Vector_sum<Left, Right, T> operator+(const Vector_expression<Left, T> &left, const Vector_expression<Right, T> &right)
+{
+    return Vector_sum<Left, Right, T>(left.self(), right.self(), false);
+}
+
+template <typename Left, typename Right, typename T>
+Vector_sum<Left, Right, T> operator-(const Vector_expression<Left, T> &left, const Vector_expression<Right, T> &right)
+{
+    return Vector_sum<Left, Right, T>(left.self(), right.self(), true);
+}
+
+template <typename E, typename T>
+Vector_scaled<E, T> operator*(const Vector_expression<E, T> &operand, const std::type_identity_t<T> &factor)
+{
+    return Vector_scaled<E, T>(operand.self(), factor);
+}
+
+template <typename E, typename T>
+Vector_scaled<E, T> operator-(const Vector_expression<E, T> &operand)
+{
+    return Vector_scaled<E, T>(operand.self(), -T(1));
+}
@@ -0,0 +1,373 @@
+#pragma once
+
+#include <iostream>
+#include "stdint.h"
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <functional>
+#include <algorithm>
+#include <type_traits>
+
+/**
+ * @brief Хэш-таблица с открытой адресацией (линейное пробирование) в непрерывном массиве
+ *
+ * Элементы хранятся прямо в массиве ячеек, без отдельного узла на каждый элемент, поэтому поиск
+ * обычно обходится одним промахом кэша. Повторяет ту часть интерфейса std::unordered_map, которой
+ * пользуется Matrix: find, emplace, erase, operator[], reserve, size и обход. Удаление сдвигает
+ * следующие элементы цепочки на освободившееся место (без меток удаления). Любая вставка может
+ * переразместить таблицу, а удаление - переместить элементы, поэтому обе операции делают
+ * итераторы и ссылки недействительными.
+ *
+ * @tparam Key тип ключа
+ * @tparam Value тип значения (должен иметь конструктор по умолчанию)
+ * @tparam Hash функция хэширования (младшие биты хэша должны быть хорошо перемешаны)
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class Flat_hash_map
+{
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<Key, Value>;
+    using size_type = size_t;
+
+    /**
+     * @brief Итератор по занятым ячейкам
+     *
+     * @tparam Const константный итератор
+     */
+    template <bool Const>
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Flat_hash_map::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const value_type *, value_type *>;
+        using reference = std::conditional_t<Const, const value_type &, value_type &>;
+        using Map = std::conditional_t<Const, const Flat_hash_map, Flat_hash_map>;
+
+        Iterator() = default;
+
+        /**
+         * @brief Конструктор, устанавливающий итератор на первую занятую ячейку, начиная с index
+         *
+         * @param[in] map таблица
+         * @param[in] index номер ячейки
+         */
+        Iterator(Map *map, size_t index) : map(map), index(index)
+        {
+            skip();
+        }
+
+        /**
+         * @brief Преобразование в константный итератор
+         *
+         */
+        operator Iterator<true>() const
+        {
+            return Iterator<true>(map, index);
+        }
+
+        reference operator*() const
+        {
+            return map->slots[index];
+        }
+
+        pointer operator->() const
+        {
+            return &map->slots[index];
+        }
+
+        Iterator &operator++()
+        {
+            ++index;
+            skip();
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator result = *this;
+            ++*this;
+            return result;
+        }
+
+        bool operator==(const Iterator &other) const
+        {
+            return index == other.index;
+        }
+
+        bool operator!=(const Iterator &other) const
+        {
+            return index != other.index;
+        }
+
+    private:
+        Map *map = nullptr;
+        size_t index = 0;
+
+        void skip()
+        {
+            while (index < map->used.size() && !map->used[index])
+                ++index;
+        }
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    /*
+        =========================== Конструкторы ===========================
+    */
+
+    /**
+     * @brief Конструктор по умолчанию (пустая таблица без выделенной памяти)
+     *
+     */
+    Flat_hash_map() = default;
+
+    /*
+        =========================== Getter ===========================
+    */
+
+    /**
+     * @brief Количество элементов
+     *
+     */
+    size_t size() const
+    {
+        return elements;
+    }
+
+    /**
+     * @brief Проверка на пустоту
+     *
+     */
+    bool empty() const
+    {
+        return elements == 0;
+    }
+
+    iterator begin()
+    {
+        return iterator(this, 0);
+    }
+
+    iterator end()
+    {
+        return iterator(this, used.size());
+    }
+
+    const_iterator begin() const
+    {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(this, used.size());
+    }
+
+    /*
+        =========================== Поиск и вставка ===========================
+    */
+
+    /**
+     * @brief Поиск элемента по ключу
+     *
+     * @param[in] key ключ
+     * @return итератор на элемент или end()
+     */
+    iterator find(const Key &key)
+    {
+        return iterator(this, locate(key));
+    }
+
+    /**
+     * @brief Поиск элемента по ключу
+     *
+     * @param[in] key ключ
+     * @return итератор на элемент или end()
+     */
+    const_iterator find(const Key &key) const
+    {
+        return const_iterator(this, locate(key));
+    }
+
+    /**
+     * @brief Количество элементов с ключом key (0 или 1)
+     *
+     */
+    size_t count(const Key &key) const
+    {
+        return locate(key) != used.size();
+    }
+
+    /**
+     * @brief Вставка элемента, если ключа нет в таблице
+     *
+     * @param[in] key ключ
+     * @param[in] args аргументы конструктора значения
+     * @return (итератор на элемент с ключом key, true если элемент вставлен)
+     */
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key &key, Args &&...args)
+    {
+        if ((elements + 1) * 4 > used.size() * 3)
+            rehash(used.empty() ? 16 : used.size() * 2);
+
+        size_t index = probe(key);
+        if (used[index])
+            return std::make_pair(iterator(this, index), false);
+
+        slots[index].first = key;
+        slots[index].second = Value(std::forward<Args>(args)...);
+        used[index] = 1;
+        ++elements;
+        return std::make_pair(iterator(this, index), true);
+    }
+
+    /**
+     * @brief Вставка элемента, если ключа нет в таблице
+     *
+     * @param[in] key ключ
+     * @param[in] value значение
+     * @return (итератор на элемент с ключом key, true если элемент вставлен)
+     */
+    template <typename V>
+    std::pair<iterator, bool> emplace(const Key &key, V &&value)
+    {
+        return try_emplace(key, std::forward<V>(value));
+    }
+
+    /**
+     * @brief Вставка пары (ключ, значение), если ключа нет в таблице
+     *
+     * @param[in] entry пара
+     * @return (итератор на элемент с ключом entry.first, true если элемент вставлен)
+     */
+    std::pair<iterator, bool> emplace(value_type &&entry)
+    {
+        return try_emplace(entry.first, std::move(entry.second));
+    }
+
+    /**
+     * @brief Доступ к значению по ключу со вставкой значения по умолчанию
+     *
+     * @param[in] key ключ
+     * @return ссылка на значение
+     */
+    Value &operator[](const Key &key)
+    {
+        return try_emplace(key).first->second;
+    }
+
+    /**
+     * @brief Удаление элемента по ключу
+     *
+     * @param[in] key ключ
+     * @return количество удаленных элементов (0 или 1)
+     */
+    size_t erase(const Key &key)
+    {
+        size_t hole = locate(key);
+        if (hole == used.size())
+            return 0;
+
+        // элемент переносится в дыру, если она лежит на пути пробирования от его начальной ячейки
+        size_t mask = used.size() - 1;
+        for (size_t index = (hole + 1) & mask; used[index]; index = (index + 1) & mask)
+        {
+            size_t home = hash(slots[index].first) & mask;
+            if (((index - home) & mask) >= ((index - hole) & mask))
+            {
+                slots[hole] = std::move(slots[index]);
+                hole = index;
+            }
+        }
+        slots[hole] = value_type();
+        used[hole] = 0;
+        --elements;
+        return 1;
+    }
+
+    /**
+     * @brief Резервирование места под n элементов без переразмещения
+     *
+     * @param[in] n количество элементов
+     */
+    void reserve(size_t n)
+    {
+        size_t capacity = 16;
+        while (capacity * 3 < n * 4)
+            capacity *= 2;
+        if (capacity > used.size())
+            rehash(capacity);
+    }
+
+    /**
+     * @brief Удаление всех элементов (память не освобождается)
+     *
+     */
+    void clear()
+    {
+        std::fill(used.begin(), used.end(), 0);
+        std::fill(slots.begin(), slots.end(), value_type());
+        elements = 0;
+    }
+
+private:
+    std::vector<value_type> slots; /**< Ячейки (размер - степень двойки) */
+    std::vector<uint8_t> used;     /**< Признак занятой ячейки */
+    size_t elements = 0;           /**< Количество элементов */
+    Hash hash;                     /**< Функция хэширования */
+
+    /**
+     * @brief Ячейка с ключом key или первая свободная ячейка на пути пробирования
+     *
+     */
+    size_t probe(const Key &key) const
+    {
+        size_t mask = used.size() - 1;
+        size_t index = hash(key) & mask;
+        while (used[index] && !(slots[index].first == key))
+            index = (index + 1) & mask;
+        return index;
+    }
+
+    /**
+     * @brief Ячейка с ключом key или used.size(), если ключа нет
+     *
+     */
+    size_t locate(const Key &key) const
+    {
+        if (elements == 0)
+            return used.size();
+        size_t index = probe(key);
+        return used[index] ? index : used.size();
+    }
+
+    /**
+     * @brief Переразмещение таблицы
+     *
+     * @param[in] capacity новое количество ячеек (степень двойки)
+     */
+    void rehash(size_t capacity)
+    {
+        std::vector<value_type> old_slots(capacity);
+        std::vector<uint8_t> old_used(capacity, 0);
+        old_slots.swap(slots);
+        old_used.swap(used);
+
+        for (size_t k = 0; k < old_used.size(); ++k)
+        {
+            if (!old_used[k])
+                continue;
+            size_t index = probe(old_slots[k].first);
+            slots[index] = std::move(old_slots[k]);
+            used[index] = 1;
+        }
+    }
+};
@@ -0,0 +1,285 @@
+#pragma once
+
+#include <iostream>
+#include "stdint.h"
+#include <vector>
+#include <algorithm>
+#include <memory>
+#include <span>
+
+#include "Matrix.h"
+#include "Binary.h"
+
+/**
+ * @brief Матрица только для чтения, отображенная в память из двоичного файла
+ *
+ * Массивы координат и значений не копируются и не разбираются: объект ссылается на отображение
+ * файла, которое освобождается вместе с последней копией матрицы. При открытии координаты
+ * однократно проверяются за O(nnz) (значения не читаются), поэтому элементы гарантированно лежат
+ * в пределах матрицы и строго упорядочены по (строка, столбец).
+ *
+ * @tparam T тип элементов матрицы (тривиально копируемый)
+ */
+template <typename T>
+class Matrix<Mapped_storage, T>
+{
+protected:
+    double eps;
+    std::pair<uint64_t, uint64_t> size;
+
+    std::shared_ptr<const Mapped_file> file; /**< Отображение файла */
+    const uint64_t *rows = nullptr;          /**< Номера строк элементов */
+    const uint64_t *columns = nullptr;       /**< Номера столбцов элементов */
+    const T *values = nullptr;               /**< Значения элементов */
+    uint64_t non_zeros = 0;                  /**< Количество элементов */
+
+public:
+    /*
+        =========================== Конструкторы ===========================
+    */
+
+    /**
+     * @brief Конструктор по умолчанию (пустая матрица)
+     *
+     */
+    Matrix() : eps(0), size(0, 0) {}
+
+    /**
+     * @brief Открытие двоичного файла матрицы без разбора значений
+     *
+     * @param[in] filename имя файла, записанного writeToBinaryFile
+     * @return матрица, ссылающаяся на отображение файла
+     * @throws MatrixReadFromFileError если файл не открывается, не содержит матрицу типа T,
+     * координаты элементов вне матрицы или не упорядочены по (строка, столбец)
+     */
+    static Matrix<Mapped_storage, T> readFromBinaryFile(std::string &&filename)
+    {
+        auto mapped = std::make_shared<const Mapped_file>(filename);
+        if (!mapped->is_open())
+            throw MatrixReadFromFileError("", __FILE__, __LINE__);
+
+        const Binary_header *header = checkBinaryFile<T>(*mapped, 2);
+        if (header == nullptr)
+            throw MatrixReadFromFileError("File not contains binary matrix of this type.", __FILE__, __LINE__);
+
+        Matrix<Mapped_storage, T> result;
+        result.eps = header->eps;
+        result.size = std::make_pair(header->rows, header->columns);
+        result.non_zeros = header->non_zeros;
+        result.rows = reinterpret_cast<const uint64_t *>(mapped->data() + sizeof(Binary_header));
+        result.columns = result.rows + result.non_zeros;
+        result.values = reinterpret_cast<const T *>(result.columns + result.non_zeros);
+        result.file = std::move(mapped);
+
+        // at(), умножение и преобразования в другие представления полагаются на порядок и границы координат
+        for (uint64_t k = 0; k < result.non_zeros; ++k)
+        {
+            uint64_t row = result.rows[k];
+            uint64_t column = result.columns[k];
+            if (row < 1 || row > result.size.first || column < 1 || column > result.size.second)
+                throw MatrixReadFromFileError("Element outside of matrix shape.", __FILE__, __LINE__);
+            if (k > 0 && std::make_pair(result.rows[k - 1], result.columns[k - 1]) >= std::make_pair(row, column))
+                throw MatrixReadFromFileError("Elements are not ordered by (row, column).", __FILE__, __LINE__);
+        }
+        return result;
+    }
+
+    /*
+        =========================== Getter ===========================
+    */
+
+    /**
+     * @brief Получение размера матрицы
+     *
+     * @return пара (кол-во строк, кол-во столбцов)
+     */
+    const std::pair<uint64_t, uint64_t> &shape() const
+    {
+        return size;
+    }
+
+    /**
+     * @brief Получение значение eps
+     *
+     * @return eps
+     */
+    const double &getEps() const
+    {
+        return eps;
+    }
+
+    /**
+     * @brief Количество хранимых элементов
+     *
+     * @return nnz
+     */
+    uint64_t nonZeros() const
+    {
+        return non_zeros;
+    }
+
+    /**
+     * @brief Номера строк элементов (по возрастанию)
+     *
+     */
+    std::span<const uint64_t> getRowIndices() const
+    {
+        return std::span<const uint64_t>(rows, non_zeros);
+    }
+
+    /**
+     * @brief Номера столбцов элементов (по возрастанию внутри строки)
+     *
+     */
+    std::span<const uint64_t> getColumnIndices() const
+    {
+        return std::span<const uint64_t>(columns, non_zeros);
+    }
+
+    /**
+     * @brief Значения элементов
+     *
+     */
+    std::span<const T> getValues() const
+    {
+        return std::span<const T>(values, non_zeros);
+    }
+
+    /**
+     * @brief Получение элемента по заданным координатам (двоичный поиск)
+     *
+     * @param[in] row номер строки
+     * @param[in] column номер столбца
+     * @return константная ссылка на элемент по заданным координатам
+     */
+    const T &at(uint64_t row, uint64_t column) const
+    {
+        static const T zero;
+        auto range = std::equal_range(rows, rows + non_zeros, row);
+        const uint64_t *first = columns + (range.first - rows);
+        const uint64_t *last = columns + (range.second - rows);
+        const uint64_t *it = std::lower_bound(first, last, column);
+        if (it == last || *it != column)
+            return zero;
+        return values[it - columns];
+    }
+
+    /**
+     * @brief Оператор () для доступа к элементу матрицы по индексам.
+     * @param row Номер строки.
+     * @param column Номер столбца.
+     * @return Ссылка на элемент матрицы в позиции (row, column).
+     * @throws MatrixIndexError Если индексы выходят за пределы размеров матрицы.
+     */
+    const T &operator()(uint64_t row, uint64_t column) const
+    {
+        if (row < 1 || row > size.first || column < 1 || column > size.second)
+            throw MatrixIndexError("", __FILE__, __LINE__, "operator ()", size, {row, column});
+        return this->at(row, column);
+    }
+
+    /*
+        =========================== Арифметические операции ===========================
+    */
+
+    /**
+     * @brief Перегрузка оператора умножения матрицы на вектор (один проход по элементам).
+     * Произведение вычисляется отложенно, при присваивании вектору (см. Expression.h).
+     *
+     * @param[in] other вектор
+     * @return Выражение - произведение матрицы на вектор
+     */
+    Matrix_vector_product<Matrix<Mapped_storage, T>, T> operator*(const Vector<T> &other) const &
+    {
+        if (static_cast<uint64_t>(other.getLen()) != size.second)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator * vector", size, std::make_pair(other.getLen(), 1));
+        return makeMatrixVectorProduct<T>(*this, other);
+    }
+
+    /**
+     * @brief Умножение на временный вектор: вектор перемещается в выражение, поэтому его можно
+     * сохранить (auto y = A * Vector<T>(n))
+     *
+     * @param[in] other вектор
+     * @return Выражение, хранящее вектор
+     */
+    auto operator*(Vector<T> &&other) const &
+    {
+        if (static_cast<uint64_t>(other.getLen()) != size.second)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator * vector", size, std::make_pair(other.getLen(), 1));
+        return makeMatrixVectorProduct<T>(*this, std::move(other));
+    }
+
+    /**
+     * @brief Умножение на вектор временного объекта: матрица перемещается в выражение
+     *
+     * @param[in] other вектор
+     * @return Выражение, хранящее матрицу
+     */
+    auto operator*(const Vector<T> &other) &&
+    {
+        if (static_cast<uint64_t>(other.getLen()) != size.second)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator * vector", size, std::make_pair(other.getLen(), 1));
+        return makeMatrixVectorProduct<T>(std::move(*this), other);
+    }
+
+    /**
+     * @brief Умножение временного объекта на временный вектор: оба операнда перемещаются в выражение
+     *
+     * @param[in] other вектор
+     * @return Выражение, хранящее оба операнда
+     */
+    auto operator*(Vector<T> &&other) &&
+    {
+        if (static_cast<uint64_t>(other.getLen()) != size.second)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator * vector", size, std::make_pair(other.getLen(), 1));
+        return makeMatrixVectorProduct<T>(std::move(*this), std::move(other));
+    }
+
+    /**
+     * @brief Прибавление alpha * this * other к накопителю отложенного выражения
+     *
+     * @param[in] alpha множитель
+     * @param[in] other вектор
+     * @param[in, out] result накопитель
+     */
+    void multiplyAdd(const T &alpha, const Vector<T> &other, Vector_accumulator<T> &result) const
+    {
+        for (uint64_t k = 0; k < non_zeros;)
+        {
+            uint64_t row = rows[k];
+            T sum = T();
+            for (; k < non_zeros && rows[k] == row; ++k)
+                sum += values[k] * other.at(columns[k]);
+            result.add(static_cast<int>(row), alpha * sum);
+        }
+    }
+
+    /*
+        =========================== Прочее ===========================
+    */
+
+    /**
+     * @brief Преобразование матрицы к строке
+     *
+     * @return Матрица приведенная к строке.
+     */
+    std::string to_string() const
+    {
+        static const T zero;
+        std::string result;
+        uint64_t k = 0;
+        for (uint64_t i = 1; i < size.first + 1; ++i)
+        {
+            for (uint64_t j = 1; j < size.second + 1; ++j)
+            {
+                if (k < non_zeros && rows[k] == i && columns[k] == j)
+                    result += values[k++].to_string() + " ";
+                else
+                    result += zero.to_string() + " ";
+            }
+            result += "\n";
+        }
+        return result;
+    }
+};
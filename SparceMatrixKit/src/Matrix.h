@@ -5,20 +5,125 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
+#include <algorithm>
+#include <functional>
 #include <sstream>
 #include <type_traits>
 #include <cmath>
 #include <map>
 #include <unordered_map>
+#include <iterator>
+#include <chrono>
+#include <span>
+#include <memory>
+#include <atomic>
+#include <mutex>
 
 #include "Vector.h"
+#include "Parallel.h"
+#include "Reader.h"
+#include "Binary.h"
+#include "Writer.h"
+#include "FlatMap.h"
+#include "SharedStorage.h"
+#include "Expression.h"
 
 template <typename T>
 class Vector;
 
+/**
+ * @brief Координаты элемента, упакованные в одно 64-битное число (строка << 32 | столбец)
+ *
+ * Ключ вдвое меньше std::pair<uint64_t, uint64_t>, а сравнение и хэширование сводятся к одной
+ * операции над числом. Поля first и second повторяют интерфейс пары, поэтому код, работающий
+ * с ключами матрицы, не зависит от выбранного представления.
+ */
+struct Matrix_packed_key
+{
+    uint32_t first = 0;  /**< Номер строки */
+    uint32_t second = 0; /**< Номер столбца */
+
+    /**
+     * @brief Конструктор по умолчанию
+     *
+     */
+    Matrix_packed_key() {}
+
+    /**
+     * @brief Конструктор из пары координат
+     *
+     * @param[in] coords пара (строка, столбец)
+     * @throws MatrixIndexError если координата не помещается в 32 бита
+     */
+    template <typename R, typename C>
+    Matrix_packed_key(const std::pair<R, C> &coords)
+        : first(static_cast<uint32_t>(coords.first)), second(static_cast<uint32_t>(coords.second))
+    {
+        if (static_cast<uint64_t>(coords.first) > UINT32_MAX || static_cast<uint64_t>(coords.second) > UINT32_MAX)
+            throw MatrixIndexError("Packed matrix keys support 32-bit coordinates only.", __FILE__, __LINE__, "Matrix_packed_key",
+                                   std::make_pair(UINT32_MAX, UINT32_MAX), std::make_pair(coords.first, coords.second));
+    }
+
+    /**
+     * @brief Упакованное значение ключа
+     *
+     * @return строка << 32 | столбец
+     */
+    uint64_t packed() const
+    {
+        return (static_cast<uint64_t>(first) << 32) | second;
+    }
+
+    friend bool operator==(const Matrix_packed_key &lhs, const Matrix_packed_key &rhs)
+    {
+        return lhs.packed() == rhs.packed();
+    }
+
+    friend bool operator!=(const Matrix_packed_key &lhs, const Matrix_packed_key &rhs)
+    {
+        return lhs.packed() != rhs.packed();
+    }
+
+    friend bool operator<(const Matrix_packed_key &lhs, const Matrix_packed_key &rhs)
+    {
+        return lhs.packed() < rhs.packed();
+    }
+};
+
+/**
+ * @brief Ключ элемента в контейнерах Matrix<std::map, T> и Matrix<std::unordered_map, T>
+ *
+ * По умолчанию - std::pair<uint64_t, uint64_t>. При сборке с SPARCE_MATRIX_KIT_PACKED_KEYS -
+ * Matrix_packed_key, тогда размеры матрицы ограничены 2^32 - 1 строками и столбцами.
+ */
+#if defined(SPARCE_MATRIX_KIT_PACKED_KEYS)
+using Matrix_key = Matrix_packed_key;
+#else
+using Matrix_key = std::pair<uint64_t, uint64_t>;
+#endif
+
+/**
+ * @brief Проверка, что координаты матрицы данного размера представимы ключом Matrix_key
+ *
+ * @param[in] size размер матрицы
+ * @param[in] object имя конструктора для сообщения об ошибке
+ * @throws MatrixShapeError если размер превышает 2^32 - 1 при упакованных ключах
+ */
+inline void checkKeyRange(const std::pair<uint64_t, uint64_t> &size, const char *object)
+{
+    if constexpr (std::is_same_v<Matrix_key, Matrix_packed_key>)
+        if (size.first > UINT32_MAX || size.second > UINT32_MAX)
+            throw MatrixShapeError("Packed matrix keys support at most 2^32 - 1 rows and columns.", __FILE__, __LINE__, object,
+                                   size, std::make_pair(UINT32_MAX, UINT32_MAX));
+}
+
 /**
  * @brief Структура для хэширования std::pair<uint64_t, uint64_t>
  *
+ * std::hash<uint64_t> в libstdc++ - тождественное отображение, поэтому координаты сначала
+ * сводятся в одно 64-битное число, а затем перемешиваются финализатором splitmix64: соседние
+ * строки, столбцы и диагонали расходятся по всем битам хэша, в том числе по младшим,
+ * которые выбирают ячейку в таблице с размером - степенью двойки.
  */
 struct PairHash
 {
@@ -30,12 +135,152 @@ struct PairHash
      */
     std::size_t operator()(const std::pair<uint64_t, uint64_t> &p) const
     {
-        std::size_t h1 = std::hash<uint64_t>{}(p.first);
-        std::size_t h2 = std::hash<uint64_t>{}(p.second);
-        return h1 ^ (h2 << 1);
+        uint64_t h = p.first * 0x9E3779B97F4A7C15ull + p.second;
+        h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+        h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+        return static_cast<std::size_t>(h ^ (h >> 31));
+    }
+
+    /**
+     * @brief Хэш упакованного ключа (тот же финализатор над одним числом)
+     *
+     * @param[in] key ключ
+     * @return std::size_t
+     */
+    std::size_t operator()(const Matrix_packed_key &key) const
+    {
+        uint64_t h = key.packed();
+        h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+        h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+        return static_cast<std::size_t>(h ^ (h >> 31));
+    }
+};
+
+/**
+ * @brief Контейнер элементов Matrix<std::unordered_map, T>
+ *
+ * По умолчанию - std::unordered_map. При сборке с SPARCE_MATRIX_KIT_FLAT_HASH - хэш-таблица
+ * с открытой адресацией Flat_hash_map (элементы в непрерывном массиве, без узла на элемент).
+ *
+ * @tparam T тип элементов матрицы
+ */
+#if defined(SPARCE_MATRIX_KIT_FLAT_HASH)
+template <typename T>
+using Coordinate_hash_map = Flat_hash_map<Matrix_key, T, PairHash>;
+#else
+template <typename T>
+using Coordinate_hash_map = std::unordered_map<Matrix_key, T, PairHash>;
+#endif
+
+/**
+ * @brief Ненулевые элементы матрицы, сгруппированные по строкам или по столбцам
+ *
+ * @tparam T тип элементов матрицы
+ */
+template <typename T>
+struct Matrix_index
+{
+    std::vector<uint64_t> offsets;                       /**< Элементы линии i лежат в entries[offsets[i], offsets[i + 1]) */
+    std::vector<std::pair<uint64_t, const T *>> entries; /**< Пары (второй индекс элемента, указатель на значение) */
+};
+
+/**
+ * @brief Индекс, строящийся при первом обращении из константных методов матрицы
+ *
+ * Индекс строится под мьютексом ровно один раз, а готовый публикуется атомарным указателем, поэтому
+ * одновременные чтения одной матрицы из нескольких потоков безопасны, а после построения обходятся
+ * без блокировки. Сброс (reset) выполняется только изменяющими методами матрицы и, как и любое
+ * изменение, не должен выполняться одновременно с чтением.
+ *
+ * @tparam T тип элементов матрицы
+ */
+template <typename T>
+class Lazy_matrix_index
+{
+public:
+    Lazy_matrix_index() = default;
+
+    /**
+     * @brief Индекс; при отсутствии строится функцией build
+     *
+     * @param[in] build функция без аргументов, возвращающая Matrix_index<T>
+     * @return ссылка на индекс, действительная до reset()
+     */
+    template <typename Build>
+    const Matrix_index<T> &get(Build build) const
+    {
+        const Matrix_index<T> *current = ready.load(std::memory_order_acquire);
+        if (current != nullptr)
+            return *current;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!cached)
+        {
+            cached = std::make_unique<const Matrix_index<T>>(build());
+            ready.store(cached.get(), std::memory_order_release);
+        }
+        return *cached;
+    }
+
+    /**
+     * @brief Сброс индекса
+     *
+     */
+    void reset()
+    {
+        ready.store(nullptr, std::memory_order_relaxed);
+        cached.reset();
     }
+
+private:
+    mutable std::atomic<const Matrix_index<T> *> ready{nullptr}; /**< Опубликованный индекс (nullptr - не построен) */
+    mutable std::unique_ptr<const Matrix_index<T>> cached;       /**< Владелец индекса */
+    mutable std::mutex mutex;                                    /**< Защищает построение */
 };
 
+/**
+ * @brief Группировка хранимых элементов по строкам или столбцам подсчетом (за O(nnz + rows + columns))
+ *
+ * Группировка устойчива: если контейнер упорядочен по (строка, столбец), то внутри линии
+ * элементы также упорядочены. Элементы вне размеров матрицы пропускаются.
+ *
+ * @tparam Data контейнер с ключами Matrix_key
+ * @param[in] data хранимые элементы
+ * @param[in] size размер матрицы
+ * @param[in] by_columns группировать по столбцам, а не по строкам
+ * @return индекс
+ */
+template <typename Data>
+auto buildMatrixIndex(const Data &data, const std::pair<uint64_t, uint64_t> &size, bool by_columns)
+{
+    Matrix_index<typename Data::mapped_type> index;
+    index.offsets.assign((by_columns ? size.second : size.first) + 2, 0);
+
+    auto inShape = [&size](const auto &key)
+    { return key.first <= size.first && key.second <= size.second; };
+
+    for (auto &entry : data)
+        if (inShape(entry.first))
+            ++index.offsets[(by_columns ? entry.first.second : entry.first.first) + 1];
+
+    for (uint64_t i = 1; i < index.offsets.size(); ++i)
+        index.offsets[i] += index.offsets[i - 1];
+
+    index.entries.resize(index.offsets.back());
+    std::vector<uint64_t> position(index.offsets.begin(), index.offsets.end() - 1);
+    for (auto &entry : data)
+    {
+        if (!inShape(entry.first))
+            continue;
+
+        if (by_columns)
+            index.entries[position[entry.first.second]++] = std::make_pair(entry.first.first, &entry.second);
+        else
+            index.entries[position[entry.first.first]++] = std::make_pair(entry.first.second, &entry.second);
+    }
+    return index;
+}
+
 /**
  * @brief Структрура среза для матрицы
  *
@@ -105,7 +350,112 @@ struct Matrix_column_coord
 };
 
 /**
- * @brief Proxy объект матрицы
+ * @brief Сборка элементов матрицы из координатных массивов (COO)
+ *
+ * Тройки упорядочиваются по (строка, столбец) одной устойчивой сортировкой, значения с одинаковыми
+ * координатами суммируются в порядке следования, суммы с модулем меньше eps отбрасываются.
+ *
+ * @tparam T тип элементов матрицы
+ * @param[in] size размеры матрицы
+ * @param[in] rows номера строк
+ * @param[in] columns номера столбцов
+ * @param[in] values значения
+ * @param[in] eps eps матрицы
+ * @return элементы, упорядоченные по (строка, столбец), без повторов
+ * @throws MatrixShapeError если массивы разной длины
+ * @throws MatrixIndexError если координаты вне размеров матрицы
+ */
+template <typename T>
+std::vector<Matrix_entry<T>> assembleTriplets(std::pair<uint64_t, uint64_t> size, std::span<const uint64_t> rows, std::span<const uint64_t> columns, std::span<const T> values, double eps)
+{
+    if (rows.size() != values.size() || columns.size() != values.size())
+        throw MatrixShapeError("Triplet arrays have different lengths.", __FILE__, __LINE__, "Matrix(rows, columns, row_indices, column_indices, values)",
+                               std::make_pair(rows.size(), columns.size()), std::make_pair(values.size(), 1));
+
+    std::vector<Matrix_entry<T>> entries;
+    entries.reserve(values.size());
+    for (size_t k = 0; k < values.size(); ++k)
+    {
+        if (rows[k] < 1 || rows[k] > size.first || columns[k] < 1 || columns[k] > size.second)
+            throw MatrixIndexError("", __FILE__, __LINE__, "Matrix(rows, columns, row_indices, column_indices, values)", size, {rows[k], columns[k]});
+        entries.emplace_back(std::make_pair(rows[k], columns[k]), values[k]);
+    }
+
+    std::stable_sort(entries.begin(), entries.end(), [](const Matrix_entry<T> &lhs, const Matrix_entry<T> &rhs)
+                     { return lhs.first < rhs.first; });
+
+    size_t count = 0;
+    for (size_t k = 0; k < entries.size();)
+    {
+        size_t next = k + 1;
+        for (; next < entries.size() && entries[next].first == entries[k].first; ++next)
+            entries[k].second += entries[next].second;
+        if (entries[k].second.abs() >= eps)
+            entries[count++] = std::move(entries[k]);
+        k = next;
+    }
+    entries.resize(count);
+    return entries;
+}
+
+/**
+ * @brief Тег сжатого хранения (CSR/CSC) для Matrix
+ *
+ * Шаблон только объявлен и используется в качестве параметра Container:
+ * Matrix<Compressed_storage, T> хранит ненулевые элементы в непрерывных массивах.
+ */
+template <class Key, class Value, class... Args>
+class Compressed_storage;
+
+/**
+ * @brief Тег хранения в отображенном в память двоичном файле для Matrix
+ *
+ * Шаблон только объявлен и используется в качестве параметра Container:
+ * Matrix<Mapped_storage, T> - матрица только для чтения, ссылающаяся на файл writeToBinaryFile.
+ */
+template <class Key, class Value, class... Args>
+class Mapped_storage;
+
+/**
+ * @brief Указатель матрицы на себя, на который ссылаются представления (proxy, ленивое транспонирование).
+ * Создается при первом запросе и не передается при копировании и перемещении матрицы, поэтому
+ * представление ссылается на объект, от которого получено, и истекает при его удалении.
+ *
+ * @tparam M тип матрицы
+ */
+template <typename M>
+class View_anchor
+{
+public:
+    View_anchor() = default;
+
+    View_anchor(const View_anchor &) noexcept {}
+
+    View_anchor &operator=(const View_anchor &) noexcept
+    {
+        return *this;
+    }
+
+    /**
+     * @brief Слабая ссылка на матрицу
+     *
+     * @param[in] matrix матрица, которой принадлежит указатель (представления константной матрицы только читают ее)
+     * @return слабая ссылка, которая истекает при удалении матрицы
+     */
+    std::weak_ptr<M *> get(const M *matrix) const
+    {
+        if (!self)
+            self = std::make_shared<M *>(const_cast<M *>(matrix));
+        return self;
+    }
+
+private:
+    mutable std::shared_ptr<M *> self; /**< Указатель на матрицу (nullptr - представления не запрашивались) */
+};
+
+/**
+ * @brief Proxy объект матрицы: блок, строка или столбец без копирования элементов.
+ * Хранит слабую ссылку на матрицу и после ее удаления бросает ProxyPointerError.
  *
  * @tparam Container
  * @tparam T
@@ -113,715 +463,2320 @@ struct Matrix_column_coord
 template <template <class, class...> class Container, class T>
 class Matrix_proxy;
 
+/**
+ * @brief Ленивое транспонирование матрицы
+ *
+ * @tparam Container
+ * @tparam T
+ */
+template <template <class, class...> class Container, class T>
+class Matrix_transposed;
+
 template <template <class, class...> class Container, class T>
 class Matrix
 {
 protected:
-    Container<std::pair<uint64_t, uint64_t>, T> data;
+    Shared_storage<Container<Matrix_key, T>> data;
     double eps;
     std::pair<uint64_t, uint64_t> size;
+    T fill; /**< Значение нехранимых элементов (по умолчанию ноль) */
+    Lazy_matrix_index<T> row_index;    /**< Построчный индекс (строится по запросу) */
+    Lazy_matrix_index<T> column_index; /**< Постолбцовый индекс (строится по запросу) */
 
-    std::vector<Matrix_proxy<Container, T> *> proxies;
-
-public:
-    /*
-        =========================== Конструкторы ===========================
-    */
+    View_anchor<Matrix<Container, T>> anchor; /**< Указатель на себя, на который ссылаются proxy и транспонирование */
 
-    /**
-     * @brief Конструктор по умолчанию
-     *
-     */
-    Matrix() : size(0, 0), eps(0) {}
+    friend class Matrix_proxy<Container, T>;
 
     /**
-     * @brief Конструктор
+     * @brief Слабая ссылка на матрицу для proxy и транспонирования (см. View_anchor)
      *
-     * @param[in] rows количество строк в матрице
-     * @param[in] columns количество столбцов в матрице
-     * @param[in] epsilon eps (по умолчанию 0)
+     * @return слабая ссылка, которая истекает при удалении матрицы
      */
-    Matrix(uint64_t rows, uint64_t columns, double epsilon = 0) : eps(epsilon), size(rows, columns) {}
-
-    /*
-        =========================== Static конструкторы ===========================
-    */
+    std::weak_ptr<Matrix<Container, T> *> viewAnchor() const
+    {
+        return anchor.get(this);
+    }
 
     /**
-     * @brief Конструктор, создающий матрицу из нулей
+     * @brief Поэлементное объединение двух матриц одного размера слиянием упорядоченных ключей (за O(nnz(A) + nnz(B)))
      *
-     * @param[in] rows количество строк в матрице
-     * @param[in] columns количество столбцов в матрице
-     * @return Нулевая матрица размера (rows x columns)
+     * @tparam Operation бинарная операция над элементами
+     * @param[in] other вторая матрица
+     * @param[in] operation операция, отсутствующий элемент передается как ноль
+     * @return Новая матрица
      */
-    static Matrix<Container, T> zeros(uint64_t rows, uint64_t columns)
+    template <typename Operation>
+    Matrix<Container, T> merge(const Matrix<Container, T> &other, Operation operation) const
     {
-        Matrix<Container, T> result(rows, columns);
-        for (int i = 1; i < rows + 1; ++i)
+        Matrix<Container, T> result(size.first, size.second, eps);
+        result.fill = operation(fill, other.fill);
+        auto &target = result.data.mutate();
+
+        auto it = data.begin();
+        auto jt = other.data.begin();
+        while (it != data.end() || jt != other.data.end())
         {
-            for (int j = 1; j < columns + 1; ++j)
+            if (jt == other.data.end() || (it != data.end() && it->first < jt->first))
             {
-                result.set(i, j, T(0, 1));
+                T value = operation(it->second, other.fill);
+                if (!result.isBackground(value))
+                    target.emplace_hint(target.end(), it->first, value);
+                ++it;
+            }
+            else if (it == data.end() || jt->first < it->first)
+            {
+                T value = operation(fill, jt->second);
+                if (!result.isBackground(value))
+                    target.emplace_hint(target.end(), jt->first, value);
+                ++jt;
+            }
+            else
+            {
+                T value = operation(it->second, jt->second);
+                if (!result.isBackground(value))
+                    target.emplace_hint(target.end(), it->first, value);
+                ++it;
+                ++jt;
             }
         }
         return result;
     }
 
     /**
-     * @brief Конструктор, создающий матрицу из единиц
+     * @brief Поэлементное изменение матрицы на месте: this = operation(this, other).
+     * Перебираются только хранимые элементы other (и все элементы this, если у other есть fill),
+     * остальные элементы this не затрагиваются; элементы, ставшие нехранимыми, удаляются.
      *
-     * @param[in] rows количество строк в матрице
-     * @param[in] columns количество столбцов в матрице
-     * @return Матрица размера (rows x columns) состоящая из единиц
+     * @tparam Operation бинарная операция над элементами
+     * @param[in] other матрица того же размера
+     * @param[in] operation операция, отсутствующий элемент передается как fill
+     * @return ссылка на эту матрицу
      */
-    static Matrix<Container, T> ones(uint64_t rows, uint64_t columns)
+    template <typename Operation>
+    Matrix<Container, T> &update(const Matrix<Container, T> &other, Operation operation)
     {
-        Matrix<Container, T> result(rows, columns);
-        for (int i = 1; i < rows + 1; ++i)
+        if (&other == this)
+        {
+            Matrix<Container, T> copy(other);
+            return update(copy, operation);
+        }
+
+        T old_fill = fill;
+        fill = operation(fill, other.fill);
+        auto &target = data.mutate();
+        std::vector<Matrix_key> erased;
+
+        if (other.hasFill())
+            for (auto &entry : target)
+            {
+                auto found = other.data.find(entry.first);
+                entry.second = operation(entry.second, found == other.data.end() ? other.fill : found->second);
+                if (isBackground(entry.second))
+                    erased.push_back(entry.first);
+            }
+
+        for (auto &entry : other.data)
         {
-            for (int j = 1; j < columns + 1; ++j)
+            auto it = target.find(entry.first);
+            if (it == target.end())
             {
-                result.set(i, j, T(1));
+                T value = operation(old_fill, entry.second);
+                if (!isBackground(value))
+                    target.emplace(entry.first, value);
+            }
+            else if (!other.hasFill())
+            {
+                it->second = operation(it->second, entry.second);
+                if (isBackground(it->second))
+                    erased.push_back(entry.first);
             }
         }
-        return result;
+
+        for (auto &key : erased)
+            target.erase(key);
+        invalidateIndex();
+        return *this;
     }
 
     /**
-     * @brief Конструктор, создающий единичную матрицу
+     * @brief Проверка, что значение не нужно хранить: отличается от fill меньше, чем на eps
      *
-     * @param[in] rows количество строк в матрице
-     * @param[in] columns количество столбцов в матрице
-     * @return Единичная матрица размера (rows x columns)
+     * @param[in] value значение
+     * @return true, если элемент со значением value равен нехранимому
      */
-    static Matrix<Container, T> eye(uint64_t rows, uint64_t columns)
+    bool isBackground(const T &value) const
     {
-        Matrix<Container, T> result(rows, columns);
-        for (int i = 1; i < std::min(rows, columns) + 1; ++i)
-        {
-            result.set(i, i, T(1));
-        }
-        return result;
+        return (hasFill() ? (value - fill).abs() : value.abs()) < eps;
     }
 
-    /*
-        =========================== Getter, setter ===========================
-    */
-
     /**
-     * @brief Получение размера матрицы
+     * @brief Добавление вклада нехранимых элементов в произведение на вектор:
+     * y_i += fill * (сумма всех x_j - сумма x_j по хранимым элементам линии i), за O(nnz + rows)
      *
-     * @return пара (кол-во строк, кол-во столбцов)
+     * @param[in] other вектор
+     * @param[in, out] result произведение по хранимым элементам
+     * @param[in] transposed произведение транспонированной матрицы
      */
-    const std::pair<uint64_t, uint64_t> &shape() const
+    void addFillProduct(const Vector<T> &other, Vector<T> &result, bool transposed) const
     {
-        return size;
+        T total = T();
+        other.forEachStored([&total](int, const T &value)
+                            { total += value; });
+
+        uint64_t lines = transposed ? size.second : size.first;
+        uint64_t length = transposed ? size.first : size.second;
+        T background = fill * total;
+        for (uint64_t i = 1; i < lines + 1; ++i)
+            result.element(static_cast<int>(i)) += background;
+
+        for (auto &entry : data)
+        {
+            uint64_t line = transposed ? entry.first.second : entry.first.first;
+            uint64_t index = transposed ? entry.first.first : entry.first.second;
+            if (line < 1 || line > lines || index < 1 || index > length)
+                continue;
+
+            const T *factor = other.stored(static_cast<int>(index));
+            if (factor != nullptr)
+                result.element(static_cast<int>(line)) -= fill * *factor;
+        }
     }
 
     /**
-     * @brief Получение контейнера с хранимыми в матрице значениями
+     * @brief Отклонение матрицы от fill: матрица с нулевым fill на том же шаблоне, хранимые элементы
+     * которой равны a_ij - fill, за O(nnz)
      *
-     * @return контейнер
+     * @return матрица D, для которой this = D + fill * J (J - матрица из единиц)
      */
-    const Container<std::pair<uint64_t, uint64_t>, T> &getData() const
+    Matrix<Container, T> deviation() const
     {
-        return data;
+        Matrix<Container, T> result(size.first, size.second, eps);
+        auto &target = result.data.mutate();
+        for (auto &entry : data)
+            target.emplace_hint(target.end(), entry.first, entry.second - fill);
+        return result;
     }
 
     /**
-     * @brief Получение значение eps
+     * @brief Произведение матриц с ненулевым fill без материализации. При A = D_A + a J и B = D_B + b J
+     * A B = D_A D_B + b (D_A 1) 1^T + a 1 (1^T D_B) + a b n J, где n - общая размерность:
+     * fill результата равен a b n, хранятся элементы D_A D_B, строки с ненулевой суммой строки D_A
+     * и столбцы с ненулевой суммой столбца D_B. Время и память пропорциональны количеству хранимых
+     * элементов результата, а не rows * columns.
      *
-     * @return eps
+     * @param[in] other правый множитель
+     * @param[in] transposed умножать this^T, а не this
+     * @return произведение
      */
-    const double &getEps() const
+    Matrix<Container, T> multiplyWithFill(const Matrix<Container, T> &other, bool transposed) const
     {
-        return eps;
+        Matrix<Container, T> left = deviation(), right = other.deviation();
+        Matrix<Container, T> product = transposed ? left.multiplyTransposed(right) : left * right;
+
+        uint64_t rows = transposed ? size.second : size.first;
+        uint64_t inner = transposed ? size.first : size.second;
+        uint64_t columns = other.size.second;
+
+        // b (D_A 1) - вклад строк, a (1^T D_B) - вклад столбцов
+        std::vector<T> row_terms(rows + 1), column_terms(columns + 1);
+        if (other.hasFill())
+            for (auto &entry : left.data)
+            {
+                uint64_t row = transposed ? entry.first.second : entry.first.first;
+                uint64_t index = transposed ? entry.first.first : entry.first.second;
+                if (row >= 1 && row <= rows && index >= 1 && index <= inner)
+                    row_terms[row] += entry.second;
+            }
+        if (hasFill())
+            for (auto &entry : right.data)
+                if (entry.first.first >= 1 && entry.first.first <= inner && entry.first.second >= 1 && entry.first.second <= columns)
+                    column_terms[entry.first.second] += entry.second;
+
+        std::vector<uint64_t> dense_rows, dense_columns;
+        for (uint64_t i = 1; i < rows + 1; ++i)
+            if ((row_terms[i] = row_terms[i] * other.fill) != T())
+                dense_rows.push_back(i);
+        for (uint64_t j = 1; j < columns + 1; ++j)
+            if ((column_terms[j] = fill * column_terms[j]) != T())
+                dense_columns.push_back(j);
+
+        Matrix<Container, T> result(rows, columns, eps);
+        result.fill = fill * other.fill * T(static_cast<int64_t>(inner));
+        auto element = [&](uint64_t i, uint64_t j)
+        { return product.at(i, j) + row_terms[i] + column_terms[j] + result.fill; };
+
+        for (uint64_t i : dense_rows)
+            for (uint64_t j = 1; j < columns + 1; ++j)
+                result.set(i, j, element(i, j));
+        for (uint64_t j : dense_columns)
+            for (uint64_t i = 1; i < rows + 1; ++i)
+                result.set(i, j, element(i, j));
+        for (auto &entry : product.data)
+            result.set(entry.first.first, entry.first.second, element(entry.first.first, entry.first.second));
+        return result;
     }
 
     /**
-     * @brief Метод для установки значения в заданную позицию
+     * @brief Постолбцовый индекс хранимых элементов. Строится при первом обращении за O(nnz + columns)
+     * и сбрасывается при изменении матрицы; внутри столбца элементы упорядочены по строкам.
+     * Построение потокобезопасно (см. Lazy_matrix_index).
      *
-     * @param[in] row количество строк
-     * @param[in] column количество столбцов
-     * @param[in] value устанавливаемое значение
+     * @return индекс
      */
-    void set(uint64_t row, uint64_t column, const T &value)
+    const Matrix_index<T> &columnIndex() const
     {
-        if (value.abs() >= eps)
-            data[std::make_pair(row, column)] = value;
+        return column_index.get([this]
+                                { return buildMatrixIndex(data, size, true); });
     }
 
     /**
-     * @brief Получение элемента по заданным координатам
+     * @brief Построчный индекс хранимых элементов. Строится при первом обращении за O(nnz + rows)
+     * и сбрасывается при изменении матрицы; внутри строки элементы упорядочены по столбцам.
+     * Используется параллельными методами для разбиения строк по числу ненулевых элементов.
+     * Построение потокобезопасно (см. Lazy_matrix_index).
      *
-     * @param[in] row номер строки
-     * @param[in] column номер столбца
-     * @return константная ссылка на элемент по заданным координатам
+     * @return индекс
      */
-    const T &at(uint64_t row, uint64_t column) const
+    const Matrix_index<T> &rowIndex() const
     {
-        auto it = data.find(std::make_pair(row, column));
-        if (it == data.end())
-        {
-            static const T zero;
-            return zero;
-        }
-        else
-            return it->second;
+        return row_index.get([this]
+                             { return buildMatrixIndex(data, size, false); });
     }
 
     /**
-     * @brief Получение элемента по заданным координатам
+     * @brief Сброс индексов после изменения набора хранимых элементов
      *
-     * @param[in] coord координаты элемента
-     * @return ссылка на элемент по заданным координатам
      */
-    T &operator[](const std::pair<uint64_t, uint64_t> &coord)
+    void invalidateIndex()
     {
-        return data[coord];
+        row_index.reset();
+        column_index.reset();
     }
 
     /**
-     * @brief Оператор () для доступа к элементу матрицы по индексам.
-     * @param row Номер строки.
-     * @param column Номер столбца.
-     * @return Ссылка на элемент матрицы в позиции (row, column).
-     * @throws MatrixIndexError Если индексы выходят за пределы размеров матрицы.
+     * @brief Построчное умножение (Gustavson) для хранимых элементов из диапазона [first, last), который
+     * должен состоять из целых строк: строка i результата накапливается как сумма a_ik * (строка k матрицы other).
+     * Ключи упорядочены по (строка, столбец), поэтому строка k матрицы other - непрерывный диапазон,
+     * начинающийся с lower_bound.
+     *
+     * @param[in] other правый множитель
+     * @param[in] first начало диапазона
+     * @param[in] last конец диапазона
+     * @param[in] emit функция, получающая элементы результата (строка, столбец, значение) по возрастанию ключей
      */
-    const T &operator()(uint64_t row, uint64_t column) const
+    template <typename Iterator, typename Emit>
+    void multiplyRows(const Matrix<Container, T> &other, Iterator first, Iterator last, Emit emit) const
     {
-        if (row < 1 || row > size.first + 1 || column < 1 || column > size.second + 1)
+        std::vector<T> accumulator(other.shape().second + 1);
+        std::vector<bool> occupied(other.shape().second + 1, false);
+        std::vector<uint64_t> columns;
+
+        auto it = first;
+        while (it != last)
         {
-            throw MatrixIndexError("", __FILE__, __LINE__, "operator ()", size, {row, column});
+            uint64_t row = it->first.first;
+            for (; it != last && it->first.first == row; ++it)
+            {
+                uint64_t k = it->first.second;
+                for (auto jt = other.data.lower_bound(std::make_pair(k, uint64_t(0))); jt != other.data.end() && jt->first.first == k; ++jt)
+                {
+                    uint64_t column = jt->first.second;
+                    if (column > other.shape().second)
+                        break;
+
+                    if (occupied[column])
+                        accumulator[column] += it->second * jt->second;
+                    else
+                    {
+                        occupied[column] = true;
+                        accumulator[column] = it->second * jt->second;
+                        columns.push_back(column);
+                    }
+                }
+            }
+
+            std::sort(columns.begin(), columns.end());
+            for (uint64_t column : columns)
+            {
+                if (accumulator[column].abs() >= eps)
+                    emit(row, column, accumulator[column]);
+                occupied[column] = false;
+            }
+            columns.clear();
         }
-        return this->at(row, column);
     }
 
+public:
     /*
-        =========================== Арифметические операции с матрицами, оператор транспонирования ===========================
+        =========================== Конструкторы ===========================
     */
 
     /**
-     * @brief Перегрузка оператора сложения для матриц.
-     * @param[in] other Матрица.
-     * @return Новая матрица, являющаяся результатом сложения.
+     * @brief Конструктор по умолчанию
+     *
      */
-    Matrix<Container, T> operator+(const Matrix<Container, T> &other)
-    {
-        if (size.first != other.shape().first || size.second != other.shape().second)
-            throw MatrixShapeError("", __FILE__, __LINE__, "operator +", size, other.shape());
-
-        Matrix<Container, T> result(size.first, size.second, eps);
+    Matrix() : size(0, 0), eps(0) {}
 
-        for (int i = 1; i < size.first + 1; ++i)
-        {
-            for (int j = 1; j < size.second + 1; ++j)
-            {
-                T value = at(i, j) + other.at(i, j);
-                result.set(i, j, value);
-            }
-        }
-        return result;
+    /**
+     * @brief Конструктор
+     *
+     * @param[in] rows количество строк в матрице
+     * @param[in] columns количество столбцов в матрице
+     * @param[in] epsilon eps (по умолчанию 0)
+     */
+    Matrix(uint64_t rows, uint64_t columns, double epsilon = 0) : eps(epsilon), size(rows, columns)
+    {
+        checkKeyRange(size, "Matrix(rows, columns)");
     }
 
     /**
-     * @brief Перегрузка оператора сложения для матриц.
-     * @param[in] other Матрица.
-     * @return Новая матрица, являющаяся результатом сложения.
+     * @brief Конструктор из координатных массивов (COO) с одной сортировкой вместо поэлементной вставки.
+     * Значения с одинаковыми координатами суммируются, суммы с модулем меньше eps не хранятся.
+     *
+     * @param[in] rows количество строк в матрице
+     * @param[in] columns количество столбцов в матрице
+     * @param[in] row_indices номера строк элементов
+     * @param[in] column_indices номера столбцов элементов
+     * @param[in] values значения элементов
+     * @param[in] epsilon eps (по умолчанию 0)
+     * @throws MatrixShapeError если массивы разной длины
+     * @throws MatrixIndexError если координаты вне размеров матрицы
      */
-    Matrix<Container, T> operator-(const Matrix<Container, T> &other)
+    Matrix(uint64_t rows, uint64_t columns, std::span<const uint64_t> row_indices, std::span<const uint64_t> column_indices, std::span<const T> values, double epsilon = 0)
+        : eps(epsilon), size(rows, columns)
     {
-        if (size.first != other.shape().first || size.second != other.shape().second)
-            throw MatrixShapeError("", __FILE__, __LINE__, "operator -", size, other.shape());
-
-        Matrix<Container, T> result(size.first, size.second, eps);
-
-        for (int i = 1; i < size.first + 1; ++i)
-        {
-            for (int j = 1; j < size.second + 1; ++j)
-            {
-                T value = at(i, j) - other.at(i, j);
-                result.set(i, j, value);
-            }
-        }
-        return result;
+        checkKeyRange(size, "Matrix(rows, columns, row_indices, column_indices, values)");
+        std::vector<Matrix_entry<T>> entries = assembleTriplets(size, row_indices, column_indices, values, eps);
+        auto &target = data.mutate();
+        for (auto &entry : entries)
+            target.emplace_hint(target.end(), std::move(entry));
     }
 
     /**
-     * @brief Перегрузка оператора умножения для матриц.
-     * @param[in] other Матрица.
-     * @return Новая матрица, являющаяся результатом умножения.
+     * @brief Конструктор из сжатого представления CSR.
+     * @param[in] other матрица в формате CSR
      */
-    Matrix<Container, T> operator*(const Matrix<Container, T> &other)
+    explicit Matrix(const Matrix<Compressed_storage, T> &other) : eps(other.getEps()), size(other.shape())
     {
-        if (size.second != other.shape().first)
-            throw MatrixShapeError("", __FILE__, __LINE__, "operator *", size, other.shape());
+        checkKeyRange(size, "Matrix(const Matrix<Compressed_storage, T> &)");
+        const auto &offsets = other.getRowOffsets();
+        const auto &columns = other.getColumnIndices();
+        const auto &values = other.getValues();
+        auto &target = data.mutate();
+        for (uint64_t i = 1; i < offsets.size(); ++i)
+            for (uint64_t k = offsets[i - 1]; k < offsets[i]; ++k)
+                target.emplace_hint(target.end(), std::make_pair(i, columns[k]), values[k]);
+    }
 
-        Matrix<Container, T> result(size.first, size.second, eps);
+    /*
+        =========================== Static конструкторы ===========================
+    */
 
-        for (int i = 1; i < size.first + 1; ++i)
-        {
-            for (int k = 1; k < other.shape().second + 1; ++k)
-            {
-                T sum = T();
-                for (int j = 1; j < size.second + 1; ++j)
-                {
-                    sum += at(i, j) * other.at(j, k);
-                }
-                result.set(i, k, sum);
-            }
-        }
-        return result;
+    /**
+     * @brief Конструктор, создающий матрицу из нулей
+     *
+     * @param[in] rows количество строк в матрице
+     * @param[in] columns количество столбцов в матрице
+     * @return Нулевая матрица размера (rows x columns) без хранимых элементов
+     */
+    static Matrix<Container, T> zeros(uint64_t rows, uint64_t columns)
+    {
+        return Matrix<Container, T>(rows, columns);
     }
 
     /**
-     * @brief Перегрузка оператора унарного минуса.
-     * @return Новая матрица, являющаяся результатом инверсии знака всех элементов текущей матрицы.
+     * @brief Конструктор, создающий матрицу из единиц
+     *
+     * @param[in] rows количество строк в матрице
+     * @param[in] columns количество столбцов в матрице
+     * @return Матрица размера (rows x columns) состоящая из единиц (хранится только значение fill, за O(1))
      */
-    Matrix<Container, T> operator-() const
+    static Matrix<Container, T> ones(uint64_t rows, uint64_t columns)
     {
-        Matrix<Container, T> result(*this);
-        for (auto &pair : result.data)
-        {
-            pair.second = -pair.second;
-        }
-        return result;
+        return full(rows, columns, T(1));
     }
 
     /**
-     * @brief Перегрузка оператора транспонирования.
-     * @return Транспонированная матрица.
+     * @brief Конструктор, создающий матрицу, все элементы которой равны value.
+     * Элементы не хранятся: value становится значением fill, поэтому построение выполняется за O(1).
+     *
+     * @param[in] rows количество строк в матрице
+     * @param[in] columns количество столбцов в матрице
+     * @param[in] value значение элементов
+     * @return Матрица размера (rows x columns) из элементов value
      */
-    Matrix<Container, T> operator~() const
+    static Matrix<Container, T> full(uint64_t rows, uint64_t columns, const T &value)
     {
-        Matrix<Container, T> result(size.second, size.first, eps);
-
-        for (int i = 1; i < size.second + 1; ++i)
-        {
-            for (int j = 1; j < size.first + 1; ++j)
-            {
-                result.set(i, j, at(j, i));
-            }
-        }
+        Matrix<Container, T> result(rows, columns);
+        result.fill = value;
         return result;
     }
 
-    /*
-        =========================== Умножение на вектор ===========================
-    */
-
     /**
-     * @brief Перегрузка оператора умножения матрицы на вектор
+     * @brief Конструктор, создающий единичную матрицу
      *
-     * @param[in] other вектор
-     * @return Вектор, являющийся произведением матрицы на вектор
+     * @param[in] rows количество строк в матрице
+     * @param[in] columns количество столбцов в матрице
+     * @return Единичная матрица размера (rows x columns)
      */
-    Vector<T> operator*(const Vector<T> &other)
+    static Matrix<Container, T> eye(uint64_t rows, uint64_t columns)
     {
-        if (other.getLen() != size.second)
-            throw MatrixShapeError("", __FILE__, __LINE__, "operator * vector", size, other.shape());
-
-        Vector<T> result(size.first);
-
-        for (int i = 1; i < size.first + 1; ++i)
+        Matrix<Container, T> result(rows, columns);
+        for (uint64_t i = 1; i < std::min(rows, columns) + 1; ++i)
         {
-            T sum = T();
-            for (int j = 1; j < size.first + 1; ++j)
-            {
-                sum += at(i, j) * other.at(j);
-            }
-            result.set(i, sum);
+            result.set(i, i, T(1));
         }
         return result;
     }
 
     /*
-        =========================== Прочее ===========================
+        =========================== Getter, setter ===========================
     */
 
     /**
-     * @brief Преобразование матрицы к строке
+     * @brief Получение размера матрицы
      *
-     * @return Матрица приведенная к строке.
+     * @return пара (кол-во строк, кол-во столбцов)
      */
-    std::string to_string() const
+    const std::pair<uint64_t, uint64_t> &shape() const
     {
-        std::string result;
-        for (int i = 1; i < size.first + 1; ++i)
-        {
-            for (int j = 1; j < size.second + 1; ++j)
-                result += at(i, j).to_string() + " ";
-            result += "\n";
-        }
-        return result;
+        return size;
     }
 
     /**
-     * @brief Конструктор перемещения матрицы.
-     * @param[in] other R-value ссылка на другой объект класса Matrix.
-     */
-    Matrix(Matrix &&other) noexcept : data(std::move(other.data)), eps(std::move(other.eps)) {}
-
-    /**
-     * @brief Конструктор копирования матрицы.
-     * @param[in] other Константная ссылка на другой объект класса Matrix.
+     * @brief Получение контейнера с хранимыми в матрице значениями
+     *
+     * @return контейнер
      */
-    Matrix(const Matrix &other) : data(other.data), eps(other.eps) {}
+    const Container<Matrix_key, T> &getData() const
+    {
+        return data.get();
+    }
 
     /**
-     * @brief Оператор присваивания.
-     * @param[in] other Константная ссылка на другой объект класса Matrix.
-     * @return Ссылка на скопированный объект.
+     * @brief Получение значение eps
+     *
+     * @return eps
      */
-    Matrix &operator=(const Matrix &other)
+    const double &getEps() const
     {
-        if (this == &other)
-            return *this;
-
-        data = other.getData();
-        eps = other.getEps();
-        size = other.shape();
-        return *this;
+        return eps;
     }
 
     /**
-     * @brief Оператор перемещения.
-     * @param[in] other R-value ссылка на другой объект класса Matrix.
-     * @return Ссылка на текущий объект после перемещения.
+     * @brief Получение значения нехранимых элементов
+     *
+     * @return fill (ноль у обычной разреженной матрицы)
      */
-    Matrix &operator=(Matrix &&other) noexcept
+    const T &getFill() const
     {
-        if (this == &other)
-            return *this;
-
-        data = std::move(other.getData());
-        eps = std::move(other.getEps());
-        size = std::move(other.shape());
-        return *this;
+        return fill;
     }
 
     /**
-     * @brief Деструктор
+     * @brief Проверка, что нехранимые элементы не равны нулю
      *
+     * @return true, если fill отличен от нуля
      */
-    ~Matrix()
+    bool hasFill() const
     {
-        for (auto &proxy : proxies)
-            proxy->delete_ptr();
+        return fill != T();
     }
 
-    /*
-        =========================== Срезы и proxy ===========================
-    */
-
     /**
-     * @brief Перегрузка оператора [] для получения среза
+     * @brief Метод для установки значения в заданную позицию
      *
-     * @param[in] coords срез
-     * @return Прокси объект
+     * @param[in] row количество строк
+     * @param[in] column количество столбцов
+     * @param[in] value устанавливаемое значение
      */
-    Matrix_proxy<Container, T> operator[](const Matrix_coords &coords)
+    void set(uint64_t row, uint64_t column, const T &value)
     {
-        uint64_t c1 = coords.c1;
-        uint64_t c2 = coords.c2;
-        uint64_t r1 = coords.r1;
-        uint64_t r2 = coords.r2;
-
-        if (c1 == -1 || r1 == -1)
-        {
-            c1 = 1;
-            r1 = 1;
-        }
-        if (c2 == -1 || r2 == -1)
+        if (!isBackground(value))
         {
-            c2 = size.second;
-            r2 = size.first;
+            data.mutate()[std::make_pair(row, column)] = value;
+            invalidateIndex();
         }
-        Matrix_proxy<Container, T> tmp(this, Matrix_coords(r1, c1, r2, c2), Matrix_row_coord(-1), Matrix_column_coord(-1));
-        proxies.push_back(&tmp);
-        return tmp;
     }
 
     /**
-     * @brief Перегрузка оператора [] для получения proxy строки
+     * @brief Получение элемента по заданным координатам
      *
      * @param[in] row номер строки
-     * @return Прокси объект
+     * @param[in] column номер столбца
+     * @return константная ссылка на элемент по заданным координатам
      */
-    Matrix_proxy<Container, T> operator[](const Matrix_row_coord &row)
+    const T &at(uint64_t row, uint64_t column) const
     {
-        Matrix_proxy<Container, T> tmp(this, Matrix_coords(), row, Matrix_column_coord(-1));
-        proxies.push_back(&tmp);
-        return tmp;
+        auto it = data.find(std::make_pair(row, column));
+        if (it == data.end())
+            return fill;
+        else
+            return it->second;
     }
 
     /**
-     * @brief Перегрузка оператора [] для получения proxy столбца
+     * @brief Получение элемента по заданным координатам
      *
-     * @param[in] column номер столбца
-     * @return Прокси объект
+     * Ссылка может пережить копирование матрицы, поэтому последующие копии получают собственные
+     * элементы (см. Shared_storage::leak) и изменение по ссылке видно только этой матрице.
+     *
+     * @param[in] coord координаты элемента
+     * @return ссылка на элемент по заданным координатам (нехранимый элемент создается со значением fill)
      */
-    Matrix_proxy<Container, T> operator[](const Matrix_column_coord &column)
+    T &operator[](const std::pair<uint64_t, uint64_t> &coord)
+    {
+        invalidateIndex();
+        return data.leak().try_emplace(coord, fill).first->second;
+    }
+
+    /**
+     * @brief Оператор () для доступа к элементу матрицы по индексам.
+     * @param row Номер строки.
+     * @param column Номер столбца.
+     * @return Ссылка на элемент матрицы в позиции (row, column).
+     * @throws MatrixIndexError Если индексы выходят за пределы размеров матрицы.
+     */
+    const T &operator()(uint64_t row, uint64_t column) const
     {
-        Matrix_proxy<Container, T> tmp(this, Matrix_coords(), Matrix_row_coord(-1), column);
-        proxies.push_back(&tmp);
-        return tmp;
+        if (row < 1 || row > size.first + 1 || column < 1 || column > size.second + 1)
+        {
+            throw MatrixIndexError("", __FILE__, __LINE__, "operator ()", size, {row, column});
+        }
+        return this->at(row, column);
     }
 
     /*
-        =========================== Чтение с потока ===========================
+        =========================== Арифметические операции с матрицами, оператор транспонирования ===========================
     */
 
     /**
-     * @brief Метод для чтения матрицы с файла
-     *
-     * @param[in] file файловый поток
-     * @return Прочитанная матрица
+     * @brief Перегрузка оператора сложения для матриц.
+     * @param[in] other Матрица.
+     * @return Новая матрица, являющаяся результатом сложения.
      */
-    static Matrix<Container, T> readFromFile(std::string &&filename)
+    Matrix<Container, T> operator+(const Matrix<Container, T> &other) const
     {
-        std::ifstream file(filename);
-        if (!file.is_open())
-            throw MatrixReadFromFileError("", __FILE__, __LINE__);
+        if (size.first != other.shape().first || size.second != other.shape().second)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator +", size, other.shape());
 
-        std::string line, _T1, _T2;
-        uint64_t rows, columns;
-        std::vector<std::string> params;
-        while (std::getline(file, line))
+        return merge(other, std::plus<T>());
+    }
+
+    /**
+     * @brief Перегрузка оператора вычитания для матриц.
+     * @param[in] other Матрица.
+     * @return Новая матрица, являющаяся результатом вычитания.
+     */
+    Matrix<Container, T> operator-(const Matrix<Container, T> &other) const
+    {
+        if (size.first != other.shape().first || size.second != other.shape().second)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator -", size, other.shape());
+
+        return merge(other, std::minus<T>());
+    }
+
+    /**
+     * @brief Прибавление матрицы на месте (см. update).
+     * @param[in] other Матрица.
+     * @return Ссылка на эту матрицу.
+     */
+    Matrix<Container, T> &operator+=(const Matrix<Container, T> &other)
+    {
+        if (size.first != other.shape().first || size.second != other.shape().second)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator +=", size, other.shape());
+
+        return update(other, std::plus<T>());
+    }
+
+    /**
+     * @brief Вычитание матрицы на месте (см. update).
+     * @param[in] other Матрица.
+     * @return Ссылка на эту матрицу.
+     */
+    Matrix<Container, T> &operator-=(const Matrix<Container, T> &other)
+    {
+        if (size.first != other.shape().first || size.second != other.shape().second)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator -=", size, other.shape());
+
+        return update(other, std::minus<T>());
+    }
+
+    /**
+     * @brief Умножение на матрицу с присваиванием (произведение строится заново).
+     * @param[in] other Матрица.
+     * @return Ссылка на эту матрицу.
+     */
+    Matrix<Container, T> &operator*=(const Matrix<Container, T> &other)
+    {
+        *this = *this * other;
+        return *this;
+    }
+
+    /**
+     * @brief Умножение на число на месте: изменяются только хранимые элементы и fill.
+     * @param[in] factor Множитель.
+     * @return Ссылка на эту матрицу.
+     */
+    Matrix<Container, T> &operator*=(const T &factor)
+    {
+        fill = fill * factor;
+        auto &target = data.mutate();
+        std::vector<Matrix_key> erased;
+        for (auto &entry : target)
+        {
+            entry.second = entry.second * factor;
+            if (isBackground(entry.second))
+                erased.push_back(entry.first);
+        }
+
+        for (auto &key : erased)
+            target.erase(key);
+        invalidateIndex();
+        return *this;
+    }
+
+    /**
+     * @brief Перегрузка оператора умножения матрицы на число.
+     * @param[in] factor Множитель.
+     * @return Новая матрица, являющаяся результатом умножения.
+     */
+    Matrix<Container, T> operator*(const T &factor) const
+    {
+        Matrix<Container, T> result(*this);
+        result *= factor;
+        return result;
+    }
+
+    /**
+     * @brief Перегрузка оператора умножения для матриц.
+     * @param[in] other Матрица.
+     * @return Новая матрица, являющаяся результатом умножения.
+     */
+    Matrix<Container, T> operator*(const Matrix<Container, T> &other) const
+    {
+        if (size.second != other.shape().first)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator *", size, other.shape());
+
+        // Ненулевой fill учитывается поправками ранга 1 (см. multiplyWithFill)
+        if (hasFill() || other.hasFill())
+            return multiplyWithFill(other, false);
+
+        Matrix<Container, T> result(size.first, other.shape().second, eps);
+        auto &target = result.data.mutate();
+        multiplyRows(other, data.begin(), data.end(), [&target](uint64_t row, uint64_t column, const T &value)
+                     { target.emplace_hint(target.end(), std::make_pair(row, column), value); });
+        return result;
+    }
+
+    /**
+     * @brief Перегрузка оператора унарного минуса.
+     * @return Новая матрица, являющаяся результатом инверсии знака всех элементов текущей матрицы.
+     */
+    Matrix<Container, T> operator-() const
+    {
+        Matrix<Container, T> result(*this);
+        for (auto &pair : result.data.mutate())
+        {
+            pair.second = -pair.second;
+        }
+        result.fill = -fill;
+        return result;
+    }
+
+    /**
+     * @brief Перегрузка оператора транспонирования.
+     * @return Транспонированная матрица.
+     */
+    Matrix<Container, T> operator~() const
+    {
+        Matrix<Container, T> result(size.second, size.first, eps);
+        result.fill = fill;
+        auto &target = result.data.mutate();
+
+        // Группировка по столбцам устойчива, поэтому ключи (j, i) вставляются в порядке возрастания
+        auto columns = buildMatrixIndex(data, size, true);
+        for (uint64_t j = 0; j + 1 < columns.offsets.size(); ++j)
+            for (uint64_t k = columns.offsets[j]; k < columns.offsets[j + 1]; ++k)
+                target.emplace_hint(target.end(), std::make_pair(j, columns.entries[k].first), *columns.entries[k].second);
+
+        return result;
+    }
+
+    /**
+     * @brief Транспонированное представление матрицы без копирования элементов.
+     * Представление хранит слабую ссылку на матрицу и после ее удаления бросает ProxyPointerError.
+     * @return Ленивое транспонирование.
+     */
+    Matrix_transposed<Container, T> transposed() const
+    {
+        return Matrix_transposed<Container, T>(viewAnchor());
+    }
+
+    /**
+     * @brief Произведение транспонированной матрицы на матрицу (this^T * other) без транспонирования this.
+     * @param[in] other Матрица.
+     * @return Новая матрица, являющаяся результатом умножения.
+     */
+    Matrix<Container, T> multiplyTransposed(const Matrix<Container, T> &other) const
+    {
+        if (size.first != other.shape().first)
+            throw MatrixShapeError("", __FILE__, __LINE__, "transposed operator *", std::make_pair(size.second, size.first), other.shape());
+
+        if (hasFill() || other.hasFill())
+            return multiplyWithFill(other, true);
+
+        Matrix<Container, T> result(size.second, other.shape().second, eps);
+        auto &target = result.data.mutate();
+
+        // Строка i результата - сумма a_ki * (строка k матрицы other) по столбцу i матрицы this
+        auto columns = buildMatrixIndex(data, size, true);
+        std::vector<T> accumulator(other.shape().second + 1);
+        std::vector<bool> occupied(other.shape().second + 1, false);
+        std::vector<uint64_t> touched;
+
+        for (uint64_t i = 1; i + 1 < columns.offsets.size(); ++i)
+        {
+            for (uint64_t a = columns.offsets[i]; a < columns.offsets[i + 1]; ++a)
+            {
+                uint64_t k = columns.entries[a].first;
+                const T &value = *columns.entries[a].second;
+                for (auto jt = other.data.lower_bound(std::make_pair(k, uint64_t(0))); jt != other.data.end() && jt->first.first == k; ++jt)
+                {
+                    uint64_t column = jt->first.second;
+                    if (column > other.shape().second)
+                        break;
+
+                    if (occupied[column])
+                        accumulator[column] += value * jt->second;
+                    else
+                    {
+                        occupied[column] = true;
+                        accumulator[column] = value * jt->second;
+                        touched.push_back(column);
+                    }
+                }
+            }
+
+            std::sort(touched.begin(), touched.end());
+            for (uint64_t column : touched)
+            {
+                if (accumulator[column].abs() >= eps)
+                    target.emplace_hint(target.end(), std::make_pair(i, column), accumulator[column]);
+                occupied[column] = false;
+            }
+            touched.clear();
+        }
+        return result;
+    }
+
+    /*
+        =========================== Умножение на вектор ===========================
+    */
+
+    /**
+     * @brief Перегрузка оператора умножения матрицы на вектор.
+     * Произведение вычисляется отложенно, при присваивании вектору, и может входить
+     * в выражения вида A * x + B * y без промежуточных векторов (см. Expression.h).
+     *
+     * @param[in] other вектор
+     * @return Выражение - произведение матрицы на вектор
+     */
+    Matrix_vector_product<Matrix<Container, T>, T> operator*(const Vector<T> &other) const &
+    {
+        if (static_cast<uint64_t>(other.getLen()) != size.second)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator * vector", size, std::make_pair(other.getLen(), 1));
+        return makeMatrixVectorProduct<T>(*this, other);
+    }
+
+    /**
+     * @brief Умножение на временный вектор: вектор перемещается в выражение, поэтому его можно
+     * сохранить (auto y = A * Vector<T>(n))
+     *
+     * @param[in] other вектор
+     * @return Выражение, хранящее вектор
+     */
+    auto operator*(Vector<T> &&other) const &
+    {
+        if (static_cast<uint64_t>(other.getLen()) != size.second)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator * vector", size, std::make_pair(other.getLen(), 1));
+        return makeMatrixVectorProduct<T>(*this, std::move(other));
+    }
+
+    /**
+     * @brief Умножение на вектор временного объекта: матрица перемещается в выражение
+     *
+     * @param[in] other вектор
+     * @return Выражение, хранящее матрицу
+     */
+    auto operator*(const Vector<T> &other) &&
+    {
+        if (static_cast<uint64_t>(other.getLen()) != size.second)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator * vector", size, std::make_pair(other.getLen(), 1));
+        return makeMatrixVectorProduct<T>(std::move(*this), other);
+    }
+
+    /**
+     * @brief Умножение временного объекта на временный вектор: оба операнда перемещаются в выражение
+     *
+     * @param[in] other вектор
+     * @return Выражение, хранящее оба операнда
+     */
+    auto operator*(Vector<T> &&other) &&
+    {
+        if (static_cast<uint64_t>(other.getLen()) != size.second)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator * vector", size, std::make_pair(other.getLen(), 1));
+        return makeMatrixVectorProduct<T>(std::move(*this), std::move(other));
+    }
+
+    /**
+     * @brief Умножение матрицы на вектор с записью в заданный вектор (один проход по ненулевым элементам).
+     * Строки результата перебираются по возрастанию, поэтому уже существующие узлы result переиспользуются.
+     *
+     * @param[in] other вектор
+     * @param[out] result вектор для записи произведения (используется его eps)
+     */
+    void multiply(const Vector<T> &other, Vector<T> &result) const
+    {
+        if (static_cast<uint64_t>(other.getLen()) != size.second)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator * vector", size, std::make_pair(other.getLen(), 1));
+
+        if (&other == &result)
+        {
+            Vector<T> copy(other);
+            multiply(copy, result);
+            return;
+        }
+
+        auto out = result.beginOrdered(size.first);
+        auto it = data.begin();
+        while (it != data.end())
+        {
+            uint64_t row = it->first.first;
+            T sum = T();
+            for (; it != data.end() && it->first.first == row; ++it)
+                if (it->first.second <= size.second)
+                    sum += it->second * other.at(it->first.second);
+
+            if (row >= 1 && row <= size.first)
+                result.writeOrdered(out, static_cast<int>(row), sum);
+        }
+        result.endOrdered(out);
+
+        if (hasFill())
+        {
+            addFillProduct(other, result, false);
+            result.compactValues();
+        }
+    }
+
+    /**
+     * @brief Прибавление alpha * this * other к накопителю отложенного выражения
+     *
+     * @param[in] alpha множитель
+     * @param[in] other вектор
+     * @param[in, out] result накопитель
+     */
+    void multiplyAdd(const T &alpha, const Vector<T> &other, Vector_accumulator<T> &result) const
+    {
+        if (hasFill())
+        {
+            Vector<T> product(size.first);
+            multiply(other, product);
+            product.accumulate(result, alpha);
+            return;
+        }
+
+        auto it = data.begin();
+        while (it != data.end())
+        {
+            uint64_t row = it->first.first;
+            T sum = T();
+            for (; it != data.end() && it->first.first == row; ++it)
+                if (it->first.second <= size.second)
+                    sum += it->second * other.at(it->first.second);
+
+            if (row >= 1 && row <= size.first)
+                result.add(static_cast<int>(row), alpha * sum);
+        }
+    }
+
+    /**
+     * @brief Параллельное умножение матрицы на вектор.
+     *
+     * @param[in] other вектор
+     * @param[in] policy политика параллельного выполнения
+     * @return Вектор, являющийся произведением матрицы на вектор
+     */
+    Vector<T> multiply(const Vector<T> &other, const Parallel_policy &policy) const
+    {
+        Vector<T> result(size.first);
+        multiply(other, result, policy);
+        return result;
+    }
+
+    /**
+     * @brief Параллельное умножение матрицы на вектор с записью в заданный вектор, без копирования матрицы.
+     * Используется кэшируемый построчный индекс (см. rowIndex): он строится один раз, поэтому
+     * повторные умножения (итерационные методы) его не перестраивают. Строки делятся на части
+     * с равным числом ненулевых элементов; каждая строка суммируется по возрастанию столбцов,
+     * как и последовательно, поэтому результат не зависит от числа потоков.
+     *
+     * @param[in] other вектор
+     * @param[out] result вектор для записи произведения (используется его eps)
+     * @param[in] policy политика параллельного выполнения
+     */
+    void multiply(const Vector<T> &other, Vector<T> &result, const Parallel_policy &policy) const
+    {
+        if (static_cast<uint64_t>(other.getLen()) != size.second)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator * vector", size, std::make_pair(other.getLen(), 1));
+
+        if (hasFill() || policy.threads < 2)
+        {
+            multiply(other, result);
+            return;
+        }
+
+        if (&other == &result)
+        {
+            Vector<T> copy(other);
+            multiply(copy, result, policy);
+            return;
+        }
+
+        const Matrix_index<T> &index = rowIndex();
+        std::vector<uint64_t> bounds = partitionByWork(std::vector<uint64_t>(index.offsets.begin() + 1, index.offsets.end()), policy.threads);
+        std::vector<T> sums(size.first + 1);
+
+        Thread_pool::shared().run(bounds.size() - 1, [&](size_t part)
+                                  {
+            for (uint64_t i = bounds[part] + 1; i < bounds[part + 1] + 1; ++i)
+            {
+                T sum = T();
+                for (uint64_t k = index.offsets[i]; k < index.offsets[i + 1]; ++k)
+                    sum += *index.entries[k].second * other.at(index.entries[k].first);
+                sums[i] = sum;
+            } });
+
+        auto out = result.beginOrdered(size.first);
+        for (uint64_t i = 1; i < size.first + 1; ++i)
+            if (index.offsets[i] != index.offsets[i + 1])
+                result.writeOrdered(out, static_cast<int>(i), sums[i]);
+        result.endOrdered(out);
+    }
+
+    /**
+     * @brief Параллельное умножение матриц без копирования в другое представление.
+     * Строки делятся на части с равным числом умножений (по кэшируемым построчным индексам обеих матриц),
+     * каждая часть вычисляется тем же алгоритмом, что и operator*, поэтому результат совпадает
+     * с operator* при любом числе потоков.
+     * @param[in] other Матрица.
+     * @param[in] policy политика параллельного выполнения
+     * @return Новая матрица, являющаяся результатом умножения.
+     */
+    Matrix<Container, T> multiply(const Matrix<Container, T> &other, const Parallel_policy &policy) const
+    {
+        if (size.second != other.size.first)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator *", size, other.size);
+        if (hasFill() || other.hasFill() || policy.threads < 2)
+            return *this * other;
+
+        const Matrix_index<T> &rows_a = rowIndex();
+        const Matrix_index<T> &rows_b = other.rowIndex();
+
+        // Работа строки i - количество умножений a_ik * b_kj плюс число элементов строки
+        std::vector<uint64_t> work(size.first + 1, 0);
+        for (uint64_t i = 1; i < size.first + 1; ++i)
+        {
+            work[i] = work[i - 1] + rows_a.offsets[i + 1] - rows_a.offsets[i];
+            for (uint64_t a = rows_a.offsets[i]; a < rows_a.offsets[i + 1]; ++a)
+                work[i] += rows_b.offsets[rows_a.entries[a].first + 1] - rows_b.offsets[rows_a.entries[a].first];
+        }
+
+        std::vector<uint64_t> bounds = partitionByWork(work, policy.threads);
+        std::vector<std::vector<std::pair<std::pair<uint64_t, uint64_t>, T>>> parts(bounds.size() - 1);
+
+        // Крайние части захватывают и ключи вне формы матрицы, как в последовательном operator*
+        Thread_pool::shared().run(parts.size(), [&](size_t part)
+                                  {
+            auto first = part == 0 ? data.begin() : data.lower_bound(std::make_pair(bounds[part] + 1, uint64_t(0)));
+            auto last = part + 1 == parts.size() ? data.end() : data.lower_bound(std::make_pair(bounds[part + 1] + 1, uint64_t(0)));
+            multiplyRows(other, first, last, [&entries = parts[part]](uint64_t row, uint64_t column, const T &value)
+                         { entries.emplace_back(std::make_pair(row, column), value); }); });
+
+        Matrix<Container, T> result(size.first, other.shape().second, eps);
+        auto &target = result.data.mutate();
+        for (auto &entries : parts)
+            for (auto &entry : entries)
+                target.emplace_hint(target.end(), entry.first, std::move(entry.second));
+        return result;
+    }
+
+    /**
+     * @brief Произведение транспонированной матрицы на вектор (this^T * other).
+     * Перебираются только ненулевые элементы other и соответствующие им строки матрицы.
+     * @param[in] other Вектор.
+     * @return Вектор, являющийся результатом умножения.
+     */
+    Vector<T> multiplyTransposed(const Vector<T> &other) const
+    {
+        Vector<T> result(size.second);
+        multiplyTransposed(other, result);
+        return result;
+    }
+
+    /**
+     * @brief Произведение транспонированной матрицы на вектор с записью в заданный вектор.
+     *
+     * @param[in] other вектор
+     * @param[out] result вектор для записи произведения (используется его eps)
+     */
+    void multiplyTransposed(const Vector<T> &other, Vector<T> &result) const
+    {
+        if (static_cast<uint64_t>(other.getLen()) != size.first)
+            throw MatrixShapeError("", __FILE__, __LINE__, "transposed operator * vector", std::make_pair(size.second, size.first), std::make_pair(other.getLen(), 1));
+
+        if (&other == &result)
+        {
+            Vector<T> copy(other);
+            multiplyTransposed(copy, result);
+            return;
+        }
+
+        result.resetValues(size.second);
+        other.forEachStored([this, &result](int index, const T &value)
+                            {
+            uint64_t row = index;
+            for (auto it = data.lower_bound(std::make_pair(row, uint64_t(0))); it != data.end() && it->first.first == row; ++it)
+                if (it->first.second >= 1 && it->first.second <= size.second)
+                    result.element(static_cast<int>(it->first.second)) += it->second * value; });
+        if (hasFill())
+            addFillProduct(other, result, true);
+        result.compactValues();
+    }
+
+    /*
+        =========================== Прочее ===========================
+    */
+
+    /**
+     * @brief Преобразование матрицы к строке
+     *
+     * @return Матрица приведенная к строке.
+     */
+    std::string to_string() const
+    {
+        std::string result;
+        for (uint64_t i = 1; i < size.first + 1; ++i)
+        {
+            for (uint64_t j = 1; j < size.second + 1; ++j)
+                result += at(i, j).to_string() + " ";
+            result += "\n";
+        }
+        return result;
+    }
+
+    /**
+     * @brief Явное представление матрицы: все элементы, отличные от нуля больше чем на eps, хранятся,
+     * fill равен нулю (за O(rows * columns))
+     *
+     * @return Матрица с теми же элементами и нулевым fill
+     */
+    Matrix<Container, T> materialized() const
+    {
+        Matrix<Container, T> result(size.first, size.second, eps);
+        auto &target = result.data.mutate();
+        for (uint64_t i = 1; i < size.first + 1; ++i)
+            for (uint64_t j = 1; j < size.second + 1; ++j)
+            {
+                const T &value = at(i, j);
+                if (value.abs() >= eps)
+                    target.emplace_hint(target.end(), std::make_pair(i, j), value);
+            }
+        return result;
+    }
+
+    /**
+     * @brief Конструктор перемещения матрицы.
+     * @param[in] other R-value ссылка на другой объект класса Matrix.
+     */
+    Matrix(Matrix &&other) noexcept : data(std::move(other.data)), eps(std::move(other.eps)), size(std::move(other.size)), fill(std::move(other.fill)) {}
+
+    /**
+     * @brief Конструктор копирования матрицы.
+     * @param[in] other Константная ссылка на другой объект класса Matrix.
+     */
+    Matrix(const Matrix &other) : data(other.data), eps(other.eps), size(other.size), fill(other.fill) {}
+
+    /**
+     * @brief Оператор присваивания.
+     * @param[in] other Константная ссылка на другой объект класса Matrix.
+     * @return Ссылка на скопированный объект.
+     */
+    Matrix &operator=(const Matrix &other)
+    {
+        if (this == &other)
+            return *this;
+
+        data = other.data;
+        eps = other.getEps();
+        size = other.shape();
+        fill = other.getFill();
+        invalidateIndex();
+        return *this;
+    }
+
+    /**
+     * @brief Оператор перемещения.
+     * @param[in] other R-value ссылка на другой объект класса Matrix.
+     * @return Ссылка на текущий объект после перемещения.
+     */
+    Matrix &operator=(Matrix &&other) noexcept
+    {
+        if (this == &other)
+            return *this;
+
+        data = std::move(other.data);
+        eps = std::move(other.getEps());
+        size = std::move(other.shape());
+        fill = std::move(other.fill);
+        invalidateIndex();
+        return *this;
+    }
+
+    /*
+        =========================== Срезы и proxy ===========================
+    */
+
+    /**
+     * @brief Обход хранимых элементов строки по возрастанию номеров столбцов (за O(log nnz + nnz строки))
+     *
+     * @param[in] row номер строки
+     * @param[in] visit функция, принимающая номер столбца и значение
+     */
+    template <typename Visitor>
+    void forEachInRow(uint64_t row, Visitor visit) const
+    {
+        for (auto it = data.lower_bound(std::make_pair(row, uint64_t(0))); it != data.end() && it->first.first == row; ++it)
+            if (it->first.second >= 1 && it->first.second <= size.second)
+                visit(uint64_t(it->first.second), it->second);
+    }
+
+    /**
+     * @brief Обход хранимых элементов столбца по возрастанию номеров строк (за O(nnz столбца)
+     * после построения постолбцового индекса)
+     *
+     * Константный метод: одновременные вызовы из нескольких потоков безопасны, пока матрица не изменяется.
+     *
+     * @param[in] column номер столбца
+     * @param[in] visit функция, принимающая номер строки и значение
+     */
+    template <typename Visitor>
+    void forEachInColumn(uint64_t column, Visitor visit) const
+    {
+        if (column < 1 || column > size.second)
+            return;
+
+        const Matrix_index<T> &index = columnIndex();
+        for (uint64_t k = index.offsets[column]; k < index.offsets[column + 1]; ++k)
+            if (index.entries[k].first >= 1)
+                visit(index.entries[k].first, *index.entries[k].second);
+    }
+
+    /**
+     * @brief Обход хранимых элементов блока [r1, r2] x [c1, c2] по возрастанию (строка, столбец).
+     * Упорядоченные ключи позволяют перескакивать к началу блока в каждой строке через lower_bound,
+     * поэтому обход стоит O(строк блока * log nnz + nnz блока).
+     *
+     * @param[in] r1 первая строка
+     * @param[in] c1 первый столбец
+     * @param[in] r2 последняя строка
+     * @param[in] c2 последний столбец
+     * @param[in] visit функция, принимающая номер строки, номер столбца и значение
+     */
+    template <typename Visitor>
+    void forEachInBlock(uint64_t r1, uint64_t c1, uint64_t r2, uint64_t c2, Visitor visit) const
+    {
+        auto it = data.lower_bound(std::make_pair(r1, c1));
+        while (it != data.end() && it->first.first <= r2)
+        {
+            uint64_t row = it->first.first;
+            uint64_t column = it->first.second;
+            if (column < c1)
+                it = data.lower_bound(std::make_pair(row, c1));
+            else if (column > c2)
+            {
+                if (row == r2)
+                    break;
+                it = data.lower_bound(std::make_pair(row + 1, c1));
+            }
+            else
+            {
+                visit(row, column, it->second);
+                ++it;
+            }
+        }
+    }
+
+    /**
+     * @brief Строка матрицы в виде вектора (перебираются только хранимые элементы строки)
+     *
+     * @param[in] row номер строки
+     * @return вектор длины columns
+     * @throws MatrixIndexError если строки нет в матрице
+     */
+    Vector<T> getRow(uint64_t row) const
+    {
+        if (row < 1 || row > size.first)
+            throw MatrixIndexError("", __FILE__, __LINE__, "getRow", size, {row, 1});
+
+        Vector<T> result(static_cast<int>(size.second));
+        if (hasFill())
+        {
+            for (uint64_t j = 1; j < size.second + 1; ++j)
+                result.element(static_cast<int>(j)) = at(row, j);
+            result.compactValues();
+            return result;
+        }
+
+        auto out = result.beginOrdered(static_cast<int>(size.second));
+        forEachInRow(row, [&result, &out](uint64_t column, const T &value)
+                     { result.writeOrdered(out, static_cast<int>(column), value); });
+        result.endOrdered(out);
+        return result;
+    }
+
+    /**
+     * @brief Столбец матрицы в виде вектора (перебираются только хранимые элементы столбца)
+     *
+     * Константный метод: одновременные вызовы из нескольких потоков безопасны, пока матрица не изменяется.
+     *
+     * @param[in] column номер столбца
+     * @return вектор длины rows
+     * @throws MatrixIndexError если столбца нет в матрице
+     */
+    Vector<T> getColumn(uint64_t column) const
+    {
+        if (column < 1 || column > size.second)
+            throw MatrixIndexError("", __FILE__, __LINE__, "getColumn", size, {1, column});
+
+        Vector<T> result(static_cast<int>(size.first));
+        if (hasFill())
+        {
+            for (uint64_t i = 1; i < size.first + 1; ++i)
+                result.element(static_cast<int>(i)) = at(i, column);
+            result.compactValues();
+            return result;
+        }
+
+        auto out = result.beginOrdered(static_cast<int>(size.first));
+        forEachInColumn(column, [&result, &out](uint64_t row, const T &value)
+                        { result.writeOrdered(out, static_cast<int>(row), value); });
+        result.endOrdered(out);
+        return result;
+    }
+
+    /**
+     * @brief Перегрузка оператора [] для получения среза
+     *
+     * @param[in] coords срез
+     * @return Прокси объект
+     */
+    Matrix_proxy<Container, T> operator[](const Matrix_coords &coords)
+    {
+        uint64_t c1 = coords.c1;
+        uint64_t c2 = coords.c2;
+        uint64_t r1 = coords.r1;
+        uint64_t r2 = coords.r2;
+
+        if (c1 == uint64_t(-1) || r1 == uint64_t(-1))
+        {
+            c1 = 1;
+            r1 = 1;
+        }
+        if (c2 == uint64_t(-1) || r2 == uint64_t(-1))
+        {
+            c2 = size.second;
+            r2 = size.first;
+        }
+        return Matrix_proxy<Container, T>(viewAnchor(), Matrix_coords(r1, c1, r2, c2), Matrix_row_coord(-1), Matrix_column_coord(-1));
+    }
+
+    /**
+     * @brief Перегрузка оператора [] для получения proxy строки
+     *
+     * @param[in] row номер строки
+     * @return Прокси объект
+     */
+    Matrix_proxy<Container, T> operator[](const Matrix_row_coord &row)
+    {
+        return Matrix_proxy<Container, T>(viewAnchor(), Matrix_coords(), row, Matrix_column_coord(-1));
+    }
+
+    /**
+     * @brief Перегрузка оператора [] для получения proxy столбца
+     *
+     * @param[in] column номер столбца
+     * @return Прокси объект
+     */
+    Matrix_proxy<Container, T> operator[](const Matrix_column_coord &column)
+    {
+        return Matrix_proxy<Container, T>(viewAnchor(), Matrix_coords(), Matrix_row_coord(-1), column);
+    }
+
+    /*
+        =========================== Чтение с потока ===========================
+    */
+
+    /**
+     * @brief Метод для чтения матрицы с файла
+     *
+     * Файл отображается в память и разбирается без выделения памяти на каждую строку.
+     *
+     * @param[in] filename имя файла
+     * @param[out] stats статистика чтения (размер, количество элементов, время), если не nullptr
+     * @return Прочитанная матрица
+     */
+    static Matrix<Container, T> readFromFile(std::string &&filename, Read_stats *stats = nullptr)
+    {
+        auto start = std::chrono::steady_clock::now();
+        Mapped_file file(filename);
+        if (!file.is_open())
+            throw MatrixReadFromFileError("", __FILE__, __LINE__);
+
+        Line_scanner scanner(file.data(), file.data() + file.size());
+        uint64_t rows, columns;
+        T fill;
+        readMatrixHeader<T>(scanner, rows, columns, &fill);
+
+        auto new_matrix = Matrix<Container, T>(rows, columns);
+        new_matrix.fill = fill;
+
+        uint64_t entries;
+        if (!readEntries<T, 2>(scanner, [&](const uint64_t *idx, const T &value)
+                               { new_matrix.set(idx[0], idx[1], value); },
+                               entries))
+            throw MatrixReadFromFileError("Incorrect matrix element line.", __FILE__, __LINE__);
+
+        if (stats != nullptr)
+            *stats = Read_stats{file.size(), entries, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+        return new_matrix;
+    }
+
+    /**
+     * @brief Параллельное чтение матрицы с файла
+     *
+     * Часть файла с элементами делится на части, выровненные по строкам; каждая часть разбирается
+     * отдельным потоком в свой координатный буфер. Буферы упорядочиваются по координатам, и контейнер строится вставками в конец с подсказкой.
+     *
+     * @param[in] filename имя файла
+     * @param[in] policy политика параллельного выполнения
+     * @param[out] stats статистика чтения (размер, количество элементов, время), если не nullptr
+     * @return Прочитанная матрица (совпадает с результатом последовательного чтения)
+     */
+    static Matrix<Container, T> readFromFile(std::string &&filename, const Parallel_policy &policy, Read_stats *stats = nullptr)
+    {
+        auto start = std::chrono::steady_clock::now();
+        Mapped_file file(filename);
+        if (!file.is_open())
+            throw MatrixReadFromFileError("", __FILE__, __LINE__);
+
+        Line_scanner scanner(file.data(), file.data() + file.size());
+        uint64_t rows, columns;
+        T fill;
+        readMatrixHeader<T>(scanner, rows, columns, &fill);
+
+        auto new_matrix = Matrix<Container, T>(rows, columns);
+        new_matrix.fill = fill;
+        auto &target = new_matrix.data.mutate();
+
+        std::vector<std::vector<Matrix_entry<T>>> chunks;
+        uint64_t entries = readMatrixEntries<T>(scanner.position(), file.data() + file.size(), new_matrix.eps, policy, chunks, new_matrix.fill);
+
+        std::vector<Matrix_entry<T>> sorted = sortEntries(chunks);
+        for (size_t k = 0; k < sorted.size(); ++k)
+        {
+            // при повторе координат остается последний в файле элемент, как при последовательной записи
+            if (k + 1 == sorted.size() || sorted[k].first != sorted[k + 1].first)
+                target.emplace_hint(target.end(), std::move(sorted[k]));
+        }
+
+        if (stats != nullptr)
+            *stats = Read_stats{file.size(), entries, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+        return new_matrix;
+    }
+
+    /**
+     * @brief Запись матрицы в двоичный файл (заголовок, упорядоченные координаты и значения)
+     *
+     * Двоичный формат не хранит fill, поэтому матрица с ненулевым fill не записывается
+     * (ее можно записать в текстовом формате writeToFile).
+     *
+     * @param[in] filename имя файла
+     * @throws MatrixWriteToFileError если запись не удалась или fill матрицы ненулевой
+     */
+    void writeToBinaryFile(std::string &&filename) const
+    {
+        if (hasFill())
+            throw MatrixWriteToFileError("Binary format does not store fill value.", __FILE__, __LINE__);
+
+        std::vector<uint64_t> rows, columns;
+        std::vector<T> values;
+        rows.reserve(data.size());
+        columns.reserve(data.size());
+        values.reserve(data.size());
+        for (auto &entry : data)
+        {
+            rows.push_back(entry.first.first);
+            columns.push_back(entry.first.second);
+            values.push_back(entry.second);
+        }
+
+        Binary_header header = makeBinaryHeader<T>(2, size.first, size.second, eps, values.size());
+        if (!writeBinaryFile(filename, header, {{rows.data(), rows.size() * sizeof(uint64_t)}, {columns.data(), columns.size() * sizeof(uint64_t)}, {values.data(), values.size() * sizeof(T)}}))
+            throw MatrixWriteToFileError("", __FILE__, __LINE__);
+    }
+
+    /**
+     * @brief Чтение матрицы из двоичного файла без разбора текста
+     *
+     * @param[in] filename имя файла, записанного writeToBinaryFile
+     * @return Прочитанная матрица
+     * @throws MatrixReadFromFileError если файл не содержит матрицу типа T
+     */
+    static Matrix<Container, T> readFromBinaryFile(std::string &&filename)
+    {
+        auto view = Matrix<Mapped_storage, T>::readFromBinaryFile(std::move(filename));
+        Matrix<Container, T> result(view.shape().first, view.shape().second, view.getEps());
+        auto &target = result.data.mutate();
+
+        auto rows = view.getRowIndices();
+        auto columns = view.getColumnIndices();
+        auto values = view.getValues();
+        for (uint64_t k = 0; k < view.nonZeros(); ++k)
+            target.emplace_hint(target.end(), std::make_pair(rows[k], columns[k]), values[k]);
+        return result;
+    }
+
+    /**
+     * @brief Потоковая запись матрицы в текстовом формате readFromFile: записываются только хранимые
+     * элементы, текст формируется в буфере фиксированного размера (время O(nnz), память O(1)).
+     * Ненулевой fill записывается в конец заголовка.
+     *
+     * @param[in, out] out поток вывода
+     * @throws MatrixWriteToFileError если запись в поток не удалась
+     */
+    void writeToFile(std::ostream &out) const
+    {
+        {
+            Text_writer writer(out);
+            writeHeader<T>(writer, "matrix", {size.first, size.second}, hasFill() ? &fill : nullptr);
+            for (auto &entry : data)
+                writeEntry(writer, {entry.first.first, entry.first.second}, entry.second);
+        }
+        if (!out)
+            throw MatrixWriteToFileError("", __FILE__, __LINE__);
+    }
+
+    /**
+     * @brief Запись матрицы в текстовый файл (см. writeToFile(std::ostream &))
+     *
+     * @param[in] filename имя файла
+     * @throws MatrixWriteToFileError если файл не открывается или запись не удалась
+     */
+    void writeToFile(std::string &&filename) const
+    {
+        std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+            throw MatrixWriteToFileError("", __FILE__, __LINE__);
+        writeToFile(file);
+    }
+};
+
+template <template <class, class...> class Container, class T>
+class Matrix_proxy
+{
+protected:
+    std::weak_ptr<Matrix<Container, T> *> owner; /**< Слабая ссылка на исходную матрицу */
+    Matrix_coords slice;
+    uint64_t idx_row = -1;
+    uint64_t idx_column = -1;
+
+    /**
+     * @brief Исходная матрица
+     *
+     * @return указатель на матрицу
+     * @throws ProxyPointerError если матрица уже удалена
+     */
+    Matrix<Container, T> *parent() const
+    {
+        auto matrix = owner.lock();
+        if (!matrix)
+            throw ProxyPointerError("Basic matrix was deleted.", __FILE__, __LINE__);
+        return *matrix;
+    }
+
+    /**
+     * @brief Границы proxy в координатах исходной матрицы (строка и столбец - блоки из одной линии)
+     *
+     * @return срез
+     */
+    Matrix_coords block() const
+    {
+        if (idx_row != uint64_t(-1))
+            return Matrix_coords(idx_row, 1, idx_row, parent()->shape().second);
+        if (idx_column != uint64_t(-1))
+            return Matrix_coords(1, idx_column, parent()->shape().first, idx_column);
+        return slice;
+    }
+
+    /**
+     * @brief Запись строки или столбца в текст: хранимые элементы берутся обходом линии,
+     * промежутки между ними заполняются значением fill матрицы
+     *
+     * @param[in, out] result текст
+     * @param[in] separator разделитель элементов
+     */
+    void appendLine(std::string &result, char separator) const
+    {
+        Matrix<Container, T> *matrix = parent();
+        std::string background = matrix->getFill().to_string() + separator;
+        uint64_t length = idx_column != uint64_t(-1) ? matrix->shape().first : matrix->shape().second;
+        uint64_t next = 1;
+        auto visit = [&](uint64_t index, const T &value)
+        {
+            for (; next < index; ++next)
+                result += background;
+            result += value.to_string() + separator;
+            next = index + 1;
+        };
+
+        if (idx_column != uint64_t(-1))
+            matrix->forEachInColumn(idx_column, visit);
+        else
+            matrix->forEachInRow(idx_row, visit);
+        for (; next <= length; ++next)
+            result += background;
+    }
+
+public:
+    /**
+     * @brief Конструктор
+     *
+     * @param[in] owner слабая ссылка на исходную матрицу
+     * @param[in] coords срез
+     * @param[in] row номер строки
+     * @param[in] column номер столбца
+     */
+    Matrix_proxy(std::weak_ptr<Matrix<Container, T> *> owner, Matrix_coords coords, Matrix_row_coord row, Matrix_column_coord column)
+        : owner(std::move(owner)), slice(coords), idx_row(row.row), idx_column(column.column) {}
+
+    /**
+     * @brief Оператор [] для обращения к элементу proxy
+     *
+     * @param index индекс элемента
+     * @return auto& элемент по индексу index
+     */
+    auto &operator[](const int index)
+    {
+        Matrix<Container, T> *matrix = parent();
+
+        if (idx_row != uint64_t(-1) && !(1 <= index && static_cast<uint64_t>(index) <= matrix->shape().second))
+            throw ProxyIndexError("", __FILE__, __LINE__, "operator []", matrix->shape().second, index);
+
+        if (idx_column != uint64_t(-1) && !(1 <= index && static_cast<uint64_t>(index) <= matrix->shape().first))
+            throw ProxyIndexError("", __FILE__, __LINE__, "operator []", matrix->shape().first, index);
+
+        return idx_column == uint64_t(-1) ? matrix->at(idx_row, index) : matrix->at(index, idx_column);
+    }
+
+    /**
+     * @brief Оператор для доступа к элементу матрицы
+     *
+     * @param[in] coords координаты
+     * @return элемент по заданным координатам
+     */
+    auto &operator[](const std::pair<uint64_t, uint64_t> &coords)
+    {
+        return parent()->operator[](coords);
+    }
+
+    /**
+     * @brief Оператор для мульти-slice
+     *
+     * @param[in] coords новый срез
+     * @return обновленный срез
+     */
+    auto &operator[](const Matrix_coords &coords)
+    {
+        parent();
+        bool firstRectCondition = (slice.r1 >= coords.r1 && slice.c1 >= coords.r1) && (slice.r2 <= coords.r2 && slice.c2 <= coords.c2);
+        bool secondRectCondition = (slice.r1 <= coords.r1 && slice.c1 <= coords.r1) && (slice.r2 >= coords.r2 && slice.c2 >= coords.c2);
+        if (!firstRectCondition && !secondRectCondition)
+            throw MatrixSliceError("", __FILE__, __LINE__);
+
+        if (firstRectCondition)
+            slice = coords;
+
+        return *this;
+    }
+
+    /*
+        =========================== Блок как матрица ===========================
+    */
+
+    /**
+     * @brief Размер proxy
+     *
+     * @return пара (кол-во строк, кол-во столбцов)
+     */
+    std::pair<uint64_t, uint64_t> shape() const
+    {
+        Matrix_coords coords = block();
+        return std::make_pair(coords.r2 - coords.r1 + 1, coords.c2 - coords.c1 + 1);
+    }
+
+    /**
+     * @brief Получение элемента по координатам внутри proxy
+     *
+     * @param[in] row номер строки (от 1)
+     * @param[in] column номер столбца (от 1)
+     * @return константная ссылка на элемент исходной матрицы
+     */
+    const T &at(uint64_t row, uint64_t column) const
+    {
+        Matrix_coords coords = block();
+        return parent()->at(coords.r1 + row - 1, coords.c1 + column - 1);
+    }
+
+    /**
+     * @brief Обход хранимых элементов proxy по возрастанию (строка, столбец) за O(nnz блока)
+     * без копирования элементов
+     *
+     * @param[in] visit функция, принимающая номер строки, номер столбца (внутри proxy) и значение
+     */
+    template <typename Visitor>
+    void forEach(Visitor visit) const
+    {
+        Matrix_coords coords = block();
+        parent()->forEachInBlock(coords.r1, coords.c1, coords.r2, coords.c2, [&](uint64_t row, uint64_t column, const T &value)
+                                 { visit(row - coords.r1 + 1, column - coords.c1 + 1, value); });
+    }
+
+    /**
+     * @brief Копирование блока в отдельную матрицу за O(nnz блока)
+     *
+     * @return матрица с элементами, eps и fill исходной матрицы
+     */
+    Matrix<Container, T> materialize() const
+    {
+        Matrix<Container, T> *matrix = parent();
+        Matrix<Container, T> result(shape().first, shape().second, matrix->getEps());
+        result.fill = matrix->getFill();
+        forEach([&result](uint64_t row, uint64_t column, const T &value)
+                { result.set(row, column, value); });
+        return result;
+    }
+
+    /**
+     * @brief Прибавление alpha * this * other к накопителю отложенного выражения
+     *
+     * @param[in] alpha множитель
+     * @param[in] other вектор
+     * @param[in, out] result накопитель
+     */
+    void multiplyAdd(const T &alpha, const Vector<T> &other, Vector_accumulator<T> &result) const
+    {
+        // Нехранимые элементы блока равны fill: y_i = fill * (сумма x_j) + сумма (a_ij - fill) x_j по хранимым
+        const bool has_fill = parent()->hasFill();
+        const T &fill = parent()->getFill();
+        if (has_fill)
         {
-            if (line.empty() || startsWithHash(line))
-                continue;
+            T total = T();
+            other.forEachStored([&total](int, const T &value)
+                                { total += value; });
+            T background = alpha * (fill * total);
+            for (uint64_t i = 1; i < shape().first + 1; ++i)
+                result.add(static_cast<int>(i), background);
+        }
 
-            std::istringstream iss(line);
-            params = std::vector<std::string>(std::istream_iterator<std::string>{iss}, std::istream_iterator<std::string>());
+        uint64_t current = 0;
+        T sum = T();
+        forEach([&](uint64_t row, uint64_t column, const T &value)
+                {
+            if (row != current)
+            {
+                if (current != 0)
+                    result.add(static_cast<int>(current), alpha * sum);
+                current = row;
+                sum = T();
+            }
+            const T &factor = other.at(static_cast<int>(column));
+            sum += value * factor;
+            if (has_fill)
+                sum -= fill * factor; });
+        if (current != 0)
+            result.add(static_cast<int>(current), alpha * sum);
+    }
 
-            if (params[0] != "matrix")
-                throw MatrixReadFromFileError("File not contains matrix.", __FILE__, __LINE__);
+    /**
+     * @brief Умножение proxy на вектор без копирования блока (вычисляется отложенно, см. Expression.h)
+     *
+     * @param[in] other вектор
+     * @return Выражение - произведение блока на вектор
+     */
+    Matrix_vector_product<Matrix_proxy<Container, T>, T> operator*(const Vector<T> &other) const &
+    {
+        if (static_cast<uint64_t>(other.getLen()) != shape().second)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator * vector", shape(), std::make_pair(other.getLen(), 1));
+        return makeMatrixVectorProduct<T>(*this, other);
+    }
 
-            if (T::type() != params[1])
-                throw MatrixReadFromFileError("Incorrect type of input matrix.", __FILE__, __LINE__);
+    /**
+     * @brief Умножение на временный вектор: вектор перемещается в выражение, поэтому его можно
+     * сохранить (auto y = A * Vector<T>(n))
+     *
+     * @param[in] other вектор
+     * @return Выражение, хранящее вектор
+     */
+    auto operator*(Vector<T> &&other) const &
+    {
+        if (static_cast<uint64_t>(other.getLen()) != shape().second)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator * vector", shape(), std::make_pair(other.getLen(), 1));
+        return makeMatrixVectorProduct<T>(*this, std::move(other));
+    }
 
-            if (params[1] == "rational")
-            {
-                if (params.size() != 4)
-                    throw MatrixReadFromFileError("To many params. Expected 4. But given " + std::to_string(params.size()), __FILE__, __LINE__);
+    /**
+     * @brief Умножение на вектор временного объекта: блок перемещается в выражение
+     *
+     * @param[in] other вектор
+     * @return Выражение, хранящее блок
+     */
+    auto operator*(const Vector<T> &other) &&
+    {
+        if (static_cast<uint64_t>(other.getLen()) != shape().second)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator * vector", shape(), std::make_pair(other.getLen(), 1));
+        return makeMatrixVectorProduct<T>(std::move(*this), other);
+    }
 
-                rows = std::stoll(params[2]);
-                columns = std::stoll(params[3]);
-            }
-            else if (params[1] == "complex")
-            {
-                if (params.size() != 6)
-                    throw MatrixReadFromFileError("To many params. Expected 6. But given " + std::to_string(params.size()), __FILE__, __LINE__);
+    /**
+     * @brief Умножение временного объекта на временный вектор: оба операнда перемещаются в выражение
+     *
+     * @param[in] other вектор
+     * @return Выражение, хранящее оба операнда
+     */
+    auto operator*(Vector<T> &&other) &&
+    {
+        if (static_cast<uint64_t>(other.getLen()) != shape().second)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator * vector", shape(), std::make_pair(other.getLen(), 1));
+        return makeMatrixVectorProduct<T>(std::move(*this), std::move(other));
+    }
 
-                std::map<std::string, std::string> in_types;
-                in_types["a"] = "integer";
-                in_types["s"] = "integer";
-                in_types["i"] = "integer";
-                in_types["l"] = "integer";
-                in_types["f"] = "float";
-                in_types["d"] = "float";
+    /**
+     * @brief Сложение блоков за O(nnz блоков)
+     *
+     * @param[in] other proxy того же размера
+     * @return Новая матрица, являющаяся результатом сложения
+     */
+    Matrix<Container, T> operator+(const Matrix_proxy<Container, T> &other) const
+    {
+        if (shape() != other.shape())
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator +", shape(), other.shape());
 
-                _T1 = T::getTypeNames().first;
-                _T2 = T::getTypeNames().second;
+        Matrix<Container, T> result = materialize();
+        result += other.materialize();
+        return result;
+    }
 
-                if (params[2] != in_types[_T1] || params[3] != in_types[_T2])
-                    throw MatrixReadFromFileError("Incorrect complex im and real field types. ", __FILE__, __LINE__);
+    /**
+     * @brief Вычитание блоков за O(nnz блоков)
+     *
+     * @param[in] other proxy того же размера
+     * @return Новая матрица, являющаяся результатом вычитания
+     */
+    Matrix<Container, T> operator-(const Matrix_proxy<Container, T> &other) const
+    {
+        if (shape() != other.shape())
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator -", shape(), other.shape());
 
-                rows = std::stoll(params[4]);
-                columns = std::stoll(params[5]);
-            }
-            break;
-        }
+        Matrix<Container, T> result = materialize();
+        result -= other.materialize();
+        return result;
+    }
 
-        auto new_matrix = Matrix<Container, T>(rows, columns);
+    /**
+     * @brief Умножение блоков
+     *
+     * @param[in] other proxy
+     * @return Новая матрица, являющаяся результатом умножения
+     */
+    Matrix<Container, T> operator*(const Matrix_proxy<Container, T> &other) const
+    {
+        if (shape().second != other.shape().first)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator *", shape(), other.shape());
 
-        uint64_t idx_1, idx_2;
-        while (std::getline(file, line))
-        {
-            if (line.empty() || startsWithHash(line))
-                continue;
+        return materialize() * other.materialize();
+    }
 
-            std::istringstream iss(line);
-            iss >> idx_1 >> idx_2;
-            if (params[1] == "complex")
-            {
-                auto left = line.find('(');
-                auto right = line.find(')');
-                auto valueString = line.substr(left + 1, right - left - 1);
-                auto value = T(valueString.c_str());
-                new_matrix.set(idx_1, idx_2, value);
-            }
-            else if (params[1] == "rational")
+    /*
+        =========================== Прочее ===========================
+    */
+
+    /**
+     * @brief Приведение proxy объекта к строке
+     *
+     * @return строка
+     */
+    std::string to_string() const
+    {
+        Matrix<Container, T> *matrix = parent();
+
+        std::string result;
+        if (idx_column != uint64_t(-1))
+            appendLine(result, '\n');
+        else if (idx_row != uint64_t(-1))
+            appendLine(result, ' ');
+        else
+        {
+            for (uint64_t i = slice.r1; i <= slice.r2; ++i)
             {
-                auto left = line.find('<');
-                auto right = line.find('>');
-                auto valueString = line.substr(left + 1, right - left - 1);
-                auto value = T(valueString.c_str());
-                new_matrix.set(idx_1, idx_2, value);
+                for (uint64_t j = slice.c1; j <= slice.c2; ++j)
+                    result += matrix->at(i, j).to_string() + " ";
+                result += "\n";
             }
         }
-        return new_matrix;
+        return result;
+    }
+
+    /**
+     * @brief Преобразование прокси строки или столбца к вектору (перебираются только хранимые элементы линии)
+     *
+     * @return вектор
+     */
+    auto create_vector()
+    {
+        Matrix<Container, T> *matrix = parent();
+
+        if (idx_column == uint64_t(-1) && idx_row == uint64_t(-1))
+            throw ProxyPointerError("Not a vector.", __FILE__, __LINE__);
+
+        if (idx_column != uint64_t(-1))
+            return matrix->getColumn(idx_column);
+        else
+            return matrix->getRow(idx_row);
     }
 };
 
+/**
+ * @brief Транспонированная матрица, которая не материализуется.
+ * Хранит слабую ссылку на исходную матрицу (как Matrix_proxy) и после ее удаления бросает
+ * ProxyPointerError; умножения выполняются по элементам исходной матрицы.
+ *
+ * @tparam Container
+ * @tparam T
+ */
 template <template <class, class...> class Container, class T>
-class Matrix_proxy
+class Matrix_transposed
 {
 protected:
-    Matrix<Container, T> *matrix;
-    Matrix_coords slice;
-    uint64_t idx_row = -1;
-    uint64_t idx_column = -1;
+    std::weak_ptr<Matrix<Container, T> *> owner; /**< Слабая ссылка на исходную матрицу */
+
+    /**
+     * @brief Исходная матрица
+     *
+     * @return константная ссылка на исходную матрицу
+     * @throws ProxyPointerError если исходная матрица удалена
+     */
+    const Matrix<Container, T> &matrix() const
+    {
+        auto matrix = owner.lock();
+        if (!matrix)
+            throw ProxyPointerError("Basic matrix was deleted.", __FILE__, __LINE__);
+        return **matrix;
+    }
 
 public:
     /**
      * @brief Конструктор
      *
-     * @param[in] matrix указатель на исходную матрицу
-     * @param[in] coords срез
-     * @param[in] row номер строки
-     * @param[in] column номер столбца
+     * @param[in] owner слабая ссылка на исходную матрицу (см. Matrix::transposed)
      */
-    Matrix_proxy(Matrix<Container, T> *matrix, Matrix_coords coords, Matrix_row_coord row, Matrix_column_coord column)
-        : matrix(matrix), slice(coords), idx_row(row.row), idx_column(column.column) {}
+    explicit Matrix_transposed(std::weak_ptr<Matrix<Container, T> *> owner) : owner(std::move(owner)) {}
 
     /**
-     * @brief Обнуление указателя на исходную матрицу, при удалении объекта матрицы
+     * @brief Получение размера транспонированной матрицы
      *
+     * @return пара (кол-во строк, кол-во столбцов)
      */
-    void delete_ptr()
+    std::pair<uint64_t, uint64_t> shape() const
     {
-        matrix = nullptr;
+        return std::make_pair(matrix().shape().second, matrix().shape().first);
     }
 
     /**
-     * @brief Оператор [] для обращения к элементу proxy
+     * @brief Получение элемента по заданным координатам
      *
-     * @param index индекс элемента
-     * @return auto& элемент по индексу index
+     * @param[in] row номер строки
+     * @param[in] column номер столбца
+     * @return константная ссылка на элемент исходной матрицы в позиции (column, row)
      */
-    auto &operator[](const int index)
+    const T &at(uint64_t row, uint64_t column) const
     {
-        if (matrix == nullptr)
-            throw ProxyPointerError("Basic matrix was deleted.", __FILE__, __LINE__);
-
-        if (idx_row != -1 && !(1 <= idx_row && index <= matrix->shape().first))
-            throw ProxyIndexError("", __FILE__, __LINE__, "operator []", matrix->shape().first, index);
-
-        if (idx_column != -1 && !(1 <= idx_column && index <= matrix->shape().second))
-            throw ProxyIndexError("", __FILE__, __LINE__, "operator []", matrix->shape().second, index);
+        return matrix().at(column, row);
+    }
 
-        return idx_column == -1 ? matrix->at(idx_row, index) : matrix->at(index, idx_column);
+    /**
+     * @brief Умножение на вектор без транспонирования исходной матрицы
+     *
+     * @param[in] other вектор
+     * @return Вектор, являющийся произведением
+     */
+    Vector<T> operator*(const Vector<T> &other) const
+    {
+        return matrix().multiplyTransposed(other);
     }
 
     /**
-     * @brief Оператор для доступа к элементу матрицы
+     * @brief Умножение на матрицу без транспонирования исходной матрицы
      *
-     * @param[in] coords координаты
-     * @return элемент по заданным координатам
+     * @param[in] other матрица
+     * @return Матрица, являющаяся произведением
      */
-    auto &operator[](const std::pair<uint64_t, uint64_t> &coords)
+    Matrix<Container, T> operator*(const Matrix<Container, T> &other) const
     {
-        if (matrix == nullptr)
-            throw ProxyPointerError("Basic matrix was deleted.", __FILE__, __LINE__);
-        return matrix->operator[](coords);
+        return matrix().multiplyTransposed(other);
     }
 
     /**
-     * @brief Оператор для мульти-slice
+     * @brief Построение транспонированной матрицы
      *
-     * @param[in] coords новый срез
-     * @return обновленный срез
+     * @return Транспонированная матрица
      */
-    auto &operator[](const Matrix_coords &coords)
+    Matrix<Container, T> materialize() const
     {
-        if (matrix == nullptr)
-            throw ProxyPointerError("Basic matrix was deleted.", __FILE__, __LINE__);
-        bool firstRectCondition = (slice.r1 >= coords.r1 && slice.c1 >= coords.r1) && (slice.r2 <= coords.r2 && slice.c2 <= coords.c2);
-        bool secondRectCondition = (slice.r1 <= coords.r1 && slice.c1 <= coords.r1) && (slice.r2 >= coords.r2 && slice.c2 >= coords.c2);
-        if (!firstRectCondition && !secondRectCondition)
-            throw MatrixSliceError("", __FILE__, __LINE__);
+        return ~matrix();
+    }
+};
 
-        if (firstRectCondition)
-            slice = coords;
+template <typename T>
+class Matrix<std::unordered_map, T>
+{
+protected:
+    using MyHash = PairHash;
+    double eps;
+    std::pair<uint64_t, uint64_t> size;
+    T fill; /**< Значение нехранимых элементов (по умолчанию ноль) */
+    Lazy_matrix_index<T> row_index;    /**< Построчный индекс (строится по запросу) */
+    Lazy_matrix_index<T> column_index; /**< Постолбцовый индекс (строится по запросу) */
 
-        return *this;
+    Shared_storage<Coordinate_hash_map<T>> data;
+    View_anchor<Matrix<std::unordered_map, T>> anchor; /**< Указатель на себя, на который ссылаются proxy и транспонирование */
+
+    friend class Matrix_proxy<std::unordered_map, T>;
+
+    /**
+     * @brief Слабая ссылка на матрицу для proxy и транспонирования (см. View_anchor)
+     *
+     * @return слабая ссылка, которая истекает при удалении матрицы
+     */
+    std::weak_ptr<Matrix<std::unordered_map, T> *> viewAnchor() const
+    {
+        return anchor.get(this);
     }
 
     /**
-     * @brief Приведение proxy объекта к строке
+     * @brief Поэлементное объединение двух матриц одного размера через хэш-объединение (за O(nnz(A) + nnz(B)))
      *
-     * @return строка
+     * @tparam Operation бинарная операция над элементами
+     * @param[in] other вторая матрица
+     * @param[in] operation операция, отсутствующий элемент передается как ноль
+     * @return Новая матрица
      */
-    std::string to_string() const
+    template <typename Operation>
+    Matrix<std::unordered_map, T> merge(const Matrix<std::unordered_map, T> &other, Operation operation) const
     {
-        if (matrix == nullptr)
-            throw ProxyPointerError("Basic matrix was deleted.", __FILE__, __LINE__);
+        Matrix<std::unordered_map, T> result(size.first, size.second, eps);
+        result.fill = operation(fill, other.fill);
+        auto &target = result.data.mutate();
+        target.reserve(data.size() + other.data.size());
 
-        std::string result;
-        if (idx_column != -1)
+        for (auto &entry : data)
         {
-            for (int i = 1; i <= matrix->shape().first; ++i)
-                result += matrix->at(i, idx_column).to_string() + '\n';
+            auto found = other.data.find(entry.first);
+            T value = operation(entry.second, found == other.data.end() ? other.fill : found->second);
+            if (!result.isBackground(value))
+                target.emplace(entry.first, value);
         }
-        else if (idx_row != -1)
+
+        for (auto &entry : other.data)
         {
-            for (int i = 1; i <= matrix->shape().second; ++i)
-                result += matrix->at(idx_row, i).to_string() + ' ';
+            if (data.find(entry.first) != data.end())
+                continue;
+
+            T value = operation(fill, entry.second);
+            if (!result.isBackground(value))
+                target.emplace(entry.first, value);
         }
-        else
+        return result;
+    }
+
+    /**
+     * @brief Поэлементное изменение матрицы на месте: this = operation(this, other).
+     * Перебираются только хранимые элементы other (и все элементы this, если у other есть fill),
+     * остальные элементы this не затрагиваются; элементы, ставшие нехранимыми, удаляются.
+     *
+     * @tparam Operation бинарная операция над элементами
+     * @param[in] other матрица того же размера
+     * @param[in] operation операция, отсутствующий элемент передается как fill
+     * @return ссылка на эту матрицу
+     */
+    template <typename Operation>
+    Matrix<std::unordered_map, T> &update(const Matrix<std::unordered_map, T> &other, Operation operation)
+    {
+        if (&other == this)
         {
-            for (int j = slice.r1; j <= slice.r2; ++j)
+            Matrix<std::unordered_map, T> copy(other);
+            return update(copy, operation);
+        }
+
+        T old_fill = fill;
+        fill = operation(fill, other.fill);
+        auto &target = data.mutate();
+        std::vector<Matrix_key> erased;
+
+        if (other.hasFill())
+            for (auto &entry : target)
             {
-                for (int i = slice.c1; i <= slice.c2; ++i)
-                    result += matrix->at(i, j).to_string() + " ";
-                result += "\n";
+                auto found = other.data.find(entry.first);
+                entry.second = operation(entry.second, found == other.data.end() ? other.fill : found->second);
+                if (isBackground(entry.second))
+                    erased.push_back(entry.first);
+            }
+
+        for (auto &entry : other.data)
+        {
+            auto it = target.find(entry.first);
+            if (it == target.end())
+            {
+                T value = operation(old_fill, entry.second);
+                if (!isBackground(value))
+                    target.emplace(entry.first, value);
+            }
+            else if (!other.hasFill())
+            {
+                it->second = operation(it->second, entry.second);
+                if (isBackground(it->second))
+                    erased.push_back(entry.first);
             }
         }
-        return result;
+
+        for (auto &key : erased)
+            target.erase(key);
+        invalidateIndex();
+        return *this;
     }
 
     /**
-     * @brief Преобразование прокси к вектору
+     * @brief Проверка, что значение не нужно хранить: отличается от fill меньше, чем на eps
      *
-     * @return вектор
+     * @param[in] value значение
+     * @return true, если элемент со значением value равен нехранимому
      */
-    auto create_vector()
+    bool isBackground(const T &value) const
     {
-        if (matrix == nullptr)
-            throw ProxyPointerError("Basic matrix was deleted.", __FILE__, __LINE__);
+        return (hasFill() ? (value - fill).abs() : value.abs()) < eps;
+    }
 
-        if (idx_column == -1 && idx_row == -1)
-            throw ProxyPointerError("Not a vector.", __FILE__, __LINE__);
+    /**
+     * @brief Добавление вклада нехранимых элементов в произведение на вектор:
+     * y_i += fill * (сумма всех x_j - сумма x_j по хранимым элементам линии i), за O(nnz + rows)
+     *
+     * @param[in] other вектор
+     * @param[in, out] result произведение по хранимым элементам
+     * @param[in] transposed произведение транспонированной матрицы
+     */
+    void addFillProduct(const Vector<T> &other, Vector<T> &result, bool transposed) const
+    {
+        T total = T();
+        other.forEachStored([&total](int, const T &value)
+                            { total += value; });
 
-        if (idx_column != -1)
-        {
-            Vector<T> result(matrix->shape().first);
-            for (int i = 1; i <= matrix->shape().first; ++i)
-                result[i] += matrix->at(i, idx_column);
-            return result;
-        }
-        else
+        uint64_t lines = transposed ? size.second : size.first;
+        uint64_t length = transposed ? size.first : size.second;
+        T background = fill * total;
+        for (uint64_t i = 1; i < lines + 1; ++i)
+            result.element(static_cast<int>(i)) += background;
+
+        for (auto &entry : data)
         {
-            Vector<T> result(matrix->shape().second);
-            for (int i = 1; i <= matrix->shape().second; ++i)
-                result[i] = matrix->at(idx_row, i);
-            return result;
+            uint64_t line = transposed ? entry.first.second : entry.first.first;
+            uint64_t index = transposed ? entry.first.first : entry.first.second;
+            if (line < 1 || line > lines || index < 1 || index > length)
+                continue;
+
+            const T *factor = other.stored(static_cast<int>(index));
+            if (factor != nullptr)
+                result.element(static_cast<int>(line)) -= fill * *factor;
         }
     }
-};
 
-template <typename T>
-class Matrix<std::unordered_map, T>
-{
-protected:
-    using MyHash = PairHash;
-    double eps;
-    std::pair<uint64_t, uint64_t> size;
+    /**
+     * @brief Отклонение матрицы от fill: матрица с нулевым fill на том же шаблоне, хранимые элементы
+     * которой равны a_ij - fill, за O(nnz)
+     *
+     * @return матрица D, для которой this = D + fill * J (J - матрица из единиц)
+     */
+    Matrix<std::unordered_map, T> deviation() const
+    {
+        Matrix<std::unordered_map, T> result(size.first, size.second, eps);
+        auto &target = result.data.mutate();
+        for (auto &entry : data)
+            target.emplace(entry.first, entry.second - fill);
+        return result;
+    }
+
+    /**
+     * @brief Произведение матриц с ненулевым fill без материализации. При A = D_A + a J и B = D_B + b J
+     * A B = D_A D_B + b (D_A 1) 1^T + a 1 (1^T D_B) + a b n J, где n - общая размерность:
+     * fill результата равен a b n, хранятся элементы D_A D_B, строки с ненулевой суммой строки D_A
+     * и столбцы с ненулевой суммой столбца D_B. Время и память пропорциональны количеству хранимых
+     * элементов результата, а не rows * columns.
+     *
+     * @param[in] other правый множитель
+     * @param[in] transposed умножать this^T, а не this
+     * @return произведение
+     */
+    Matrix<std::unordered_map, T> multiplyWithFill(const Matrix<std::unordered_map, T> &other, bool transposed) const
+    {
+        Matrix<std::unordered_map, T> left = deviation(), right = other.deviation();
+        Matrix<std::unordered_map, T> product = transposed ? left.multiplyTransposed(right) : left * right;
+
+        uint64_t rows = transposed ? size.second : size.first;
+        uint64_t inner = transposed ? size.first : size.second;
+        uint64_t columns = other.size.second;
+
+        // b (D_A 1) - вклад строк, a (1^T D_B) - вклад столбцов
+        std::vector<T> row_terms(rows + 1), column_terms(columns + 1);
+        if (other.hasFill())
+            for (auto &entry : left.data)
+            {
+                uint64_t row = transposed ? entry.first.second : entry.first.first;
+                uint64_t index = transposed ? entry.first.first : entry.first.second;
+                if (row >= 1 && row <= rows && index >= 1 && index <= inner)
+                    row_terms[row] += entry.second;
+            }
+        if (hasFill())
+            for (auto &entry : right.data)
+                if (entry.first.first >= 1 && entry.first.first <= inner && entry.first.second >= 1 && entry.first.second <= columns)
+                    column_terms[entry.first.second] += entry.second;
+
+        std::vector<uint64_t> dense_rows, dense_columns;
+        for (uint64_t i = 1; i < rows + 1; ++i)
+            if ((row_terms[i] = row_terms[i] * other.fill) != T())
+                dense_rows.push_back(i);
+        for (uint64_t j = 1; j < columns + 1; ++j)
+            if ((column_terms[j] = fill * column_terms[j]) != T())
+                dense_columns.push_back(j);
+
+        Matrix<std::unordered_map, T> result(rows, columns, eps);
+        result.fill = fill * other.fill * T(static_cast<int64_t>(inner));
+        auto element = [&](uint64_t i, uint64_t j)
+        { return product.at(i, j) + row_terms[i] + column_terms[j] + result.fill; };
+
+        for (uint64_t i : dense_rows)
+            for (uint64_t j = 1; j < columns + 1; ++j)
+                result.set(i, j, element(i, j));
+        for (uint64_t j : dense_columns)
+            for (uint64_t i = 1; i < rows + 1; ++i)
+                result.set(i, j, element(i, j));
+        for (auto &entry : product.data)
+            result.set(entry.first.first, entry.first.second, element(entry.first.first, entry.first.second));
+        return result;
+    }
+
+    /**
+     * @brief Индекс хранимых элементов по строкам или по столбцам. Строится при первом обращении
+     * за O(nnz log nnz) и сбрасывается при изменении матрицы; внутри линии элементы упорядочены.
+     * Построение потокобезопасно (см. Lazy_matrix_index).
+     *
+     * @param[in] by_columns индекс по столбцам, а не по строкам
+     * @return индекс
+     */
+    const Matrix_index<T> &lineIndex(bool by_columns) const
+    {
+        return (by_columns ? column_index : row_index).get([this, by_columns]
+                                                           {
+            Matrix_index<T> index = buildMatrixIndex(data, size, by_columns);
+            for (uint64_t i = 0; i + 1 < index.offsets.size(); ++i)
+                std::sort(index.entries.begin() + index.offsets[i], index.entries.begin() + index.offsets[i + 1],
+                          [](const auto &lhs, const auto &rhs)
+                          { return lhs.first < rhs.first; });
+            return index; });
+    }
+
+    /**
+     * @brief Сброс индексов после изменения набора хранимых элементов
+     *
+     */
+    void invalidateIndex()
+    {
+        row_index.reset();
+        column_index.reset();
+    }
+
+    /**
+     * @brief Вычисление строк (first, last] произведения this * other построчным умножением (Gustavson):
+     * строка i результата накапливается как сумма a_ik * (строка k матрицы other).
+     *
+     * @param[in] rows_a построчный индекс этой матрицы
+     * @param[in] rows_b построчный индекс матрицы other
+     * @param[in] columns_b количество столбцов матрицы other
+     * @param[in] first строка перед первой вычисляемой строкой
+     * @param[in] last последняя вычисляемая строка
+     * @param[in] emit функция, получающая элементы результата (строка, столбец, значение)
+     */
+    template <typename Emit>
+    static void multiplyRows(const Matrix_index<T> &rows_a, const Matrix_index<T> &rows_b, uint64_t columns_b,
+                             uint64_t first, uint64_t last, Emit emit)
+    {
+        std::vector<T> accumulator(columns_b + 1);
+        std::vector<bool> occupied(columns_b + 1, false);
+        std::vector<uint64_t> columns;
+
+        for (uint64_t row = first + 1; row < last + 1; ++row)
+        {
+            for (uint64_t a = rows_a.offsets[row]; a < rows_a.offsets[row + 1]; ++a)
+            {
+                uint64_t k = rows_a.entries[a].first;
+                if (k + 1 >= rows_b.offsets.size())
+                    continue;
+
+                const T &value = *rows_a.entries[a].second;
+                for (uint64_t b = rows_b.offsets[k]; b < rows_b.offsets[k + 1]; ++b)
+                {
+                    uint64_t column = rows_b.entries[b].first;
+                    if (column > columns_b)
+                        continue;
+
+                    if (occupied[column])
+                        accumulator[column] += value * *rows_b.entries[b].second;
+                    else
+                    {
+                        occupied[column] = true;
+                        accumulator[column] = value * *rows_b.entries[b].second;
+                        columns.push_back(column);
+                    }
+                }
+            }
 
-    std::unordered_map<std::pair<uint64_t, uint64_t>, T, MyHash> data;
-    std::vector<Matrix_proxy<std::unordered_map, T> *> proxies;
+            for (uint64_t column : columns)
+            {
+                emit(row, column, accumulator[column]);
+                occupied[column] = false;
+            }
+            columns.clear();
+        }
+    }
 
 public:
     /*
@@ -841,7 +2796,51 @@ public:
      * @param[in] columns количество столбцов в матрице
      * @param[in] epsilon eps (по умолчанию 0)
      */
-    Matrix(uint64_t rows, uint64_t columns, double epsilon = 0) : eps(epsilon), size(rows, columns) {}
+    Matrix(uint64_t rows, uint64_t columns, double epsilon = 0) : eps(epsilon), size(rows, columns)
+    {
+        checkKeyRange(size, "Matrix(rows, columns)");
+    }
+
+    /**
+     * @brief Конструктор из координатных массивов (COO) с одной сортировкой вместо поэлементной вставки.
+     * Значения с одинаковыми координатами суммируются, суммы с модулем меньше eps не хранятся.
+     *
+     * @param[in] rows количество строк в матрице
+     * @param[in] columns количество столбцов в матрице
+     * @param[in] row_indices номера строк элементов
+     * @param[in] column_indices номера столбцов элементов
+     * @param[in] values значения элементов
+     * @param[in] epsilon eps (по умолчанию 0)
+     * @throws MatrixShapeError если массивы разной длины
+     * @throws MatrixIndexError если координаты вне размеров матрицы
+     */
+    Matrix(uint64_t rows, uint64_t columns, std::span<const uint64_t> row_indices, std::span<const uint64_t> column_indices, std::span<const T> values, double epsilon = 0)
+        : eps(epsilon), size(rows, columns)
+    {
+        checkKeyRange(size, "Matrix(rows, columns, row_indices, column_indices, values)");
+        std::vector<Matrix_entry<T>> entries = assembleTriplets(size, row_indices, column_indices, values, eps);
+        auto &target = data.mutate();
+        target.reserve(entries.size());
+        for (auto &entry : entries)
+            target.emplace(std::move(entry));
+    }
+
+    /**
+     * @brief Конструктор из сжатого представления CSR.
+     * @param[in] other матрица в формате CSR
+     */
+    explicit Matrix(const Matrix<Compressed_storage, T> &other) : eps(other.getEps()), size(other.shape())
+    {
+        checkKeyRange(size, "Matrix(const Matrix<Compressed_storage, T> &)");
+        const auto &offsets = other.getRowOffsets();
+        const auto &columns = other.getColumnIndices();
+        const auto &values = other.getValues();
+        auto &target = data.mutate();
+        target.reserve(values.size());
+        for (uint64_t i = 1; i < offsets.size(); ++i)
+            for (uint64_t k = offsets[i - 1]; k < offsets[i]; ++k)
+                target.emplace(std::make_pair(i, columns[k]), values[k]);
+    }
 
     /*
         =========================== Static конструкторы ===========================
@@ -852,19 +2851,11 @@ public:
      *
      * @param[in] rows количество строк в матрице
      * @param[in] columns количество столбцов в матрице
-     * @return Нулевая матрица размера (rows x columns)
+     * @return Нулевая матрица размера (rows x columns) без хранимых элементов
      */
     static Matrix<std::unordered_map, T> zeros(uint64_t rows, uint64_t columns)
     {
-        Matrix<std::unordered_map, T> result(rows, columns);
-        for (int i = 1; i < rows + 1; ++i)
-        {
-            for (int j = 1; j < columns + 1; ++j)
-            {
-                result.set(i, j, T(0, 1));
-            }
-        }
-        return result;
+        return Matrix<std::unordered_map, T>(rows, columns);
     }
 
     /**
@@ -872,18 +2863,26 @@ public:
      *
      * @param[in] rows количество строк в матрице
      * @param[in] columns количество столбцов в матрице
-     * @return Матрица размера (rows x columns) состоящая из единиц
+     * @return Матрица размера (rows x columns) состоящая из единиц (хранится только значение fill, за O(1))
      */
     static Matrix<std::unordered_map, T> ones(uint64_t rows, uint64_t columns)
+    {
+        return full(rows, columns, T(1));
+    }
+
+    /**
+     * @brief Конструктор, создающий матрицу, все элементы которой равны value.
+     * Элементы не хранятся: value становится значением fill, поэтому построение выполняется за O(1).
+     *
+     * @param[in] rows количество строк в матрице
+     * @param[in] columns количество столбцов в матрице
+     * @param[in] value значение элементов
+     * @return Матрица размера (rows x columns) из элементов value
+     */
+    static Matrix<std::unordered_map, T> full(uint64_t rows, uint64_t columns, const T &value)
     {
         Matrix<std::unordered_map, T> result(rows, columns);
-        for (int i = 1; i < rows + 1; ++i)
-        {
-            for (int j = 1; j < columns + 1; ++j)
-            {
-                result.set(i, j, T(1));
-            }
-        }
+        result.fill = value;
         return result;
     }
 
@@ -897,7 +2896,7 @@ public:
     static Matrix<std::unordered_map, T> eye(uint64_t rows, uint64_t columns)
     {
         Matrix<std::unordered_map, T> result(rows, columns);
-        for (int i = 1; i < std::min(rows, columns) + 1; ++i)
+        for (uint64_t i = 1; i < std::min(rows, columns) + 1; ++i)
         {
             result.set(i, i, T(1));
         }
@@ -923,9 +2922,9 @@ public:
      *
      * @return контейнер
      */
-    const std::unordered_map<std::pair<uint64_t, uint64_t>, T> &getData() const
+    const Coordinate_hash_map<T> &getData() const
     {
-        return data;
+        return data.get();
     }
 
     /**
@@ -935,204 +2934,581 @@ public:
      */
     const double &getEps() const
     {
-        return eps;
+        return eps;
+    }
+
+    /**
+     * @brief Получение значения нехранимых элементов
+     *
+     * @return fill (ноль у обычной разреженной матрицы)
+     */
+    const T &getFill() const
+    {
+        return fill;
+    }
+
+    /**
+     * @brief Проверка, что нехранимые элементы не равны нулю
+     *
+     * @return true, если fill отличен от нуля
+     */
+    bool hasFill() const
+    {
+        return fill != T();
+    }
+
+    /**
+     * @brief Метод для установки значения в заданную позицию
+     *
+     * @param[in] row количество строк
+     * @param[in] column количество столбцов
+     * @param[in] value устанавливаемое значение
+     */
+    void set(uint64_t row, uint64_t column, const T &value)
+    {
+        if (!isBackground(value))
+        {
+            data.mutate()[std::make_pair(row, column)] = value;
+            invalidateIndex();
+        }
+    }
+
+    /**
+     * @brief Получение элемента по заданным координатам
+     *
+     * @param[in] row номер строки
+     * @param[in] column номер столбца
+     * @return константная ссылка на элемент по заданным координатам
+     */
+    const T &at(uint64_t row, uint64_t column) const
+    {
+        auto it = data.find(std::make_pair(row, column));
+        if (it == data.end())
+            return fill;
+        else
+            return it->second;
+    }
+
+    /**
+     * @brief Получение элемента по заданным координатам
+     *
+     * Ссылка может пережить копирование матрицы, поэтому последующие копии получают собственные
+     * элементы (см. Shared_storage::leak) и изменение по ссылке видно только этой матрице.
+     *
+     * @param[in] coord координаты элемента
+     * @return ссылка на элемент по заданным координатам (нехранимый элемент создается со значением fill)
+     */
+    T &operator[](const std::pair<uint64_t, uint64_t> &coord)
+    {
+        invalidateIndex();
+        return data.leak().try_emplace(coord, fill).first->second;
+    }
+
+    /**
+     * @brief Оператор () для доступа к элементу матрицы по индексам.
+     * @param row Номер строки.
+     * @param column Номер столбца.
+     * @return Ссылка на элемент матрицы в позиции (row, column).
+     * @throws MatrixIndexError Если индексы выходят за пределы размеров матрицы.
+     */
+    const T &operator()(uint64_t row, uint64_t column) const
+    {
+        if (row < 1 || row > size.first + 1 || column < 1 || column > size.second + 1)
+        {
+            throw MatrixIndexError("", __FILE__, __LINE__, "operator ()", size, {row, column});
+        }
+        return this->at(row, column);
+    }
+
+    /*
+        =========================== Арифметические операции с матрицами, оператор транспонирования ===========================
+    */
+
+    /**
+     * @brief Перегрузка оператора сложения для матриц.
+     * @param[in] other Матрица.
+     * @return Новая матрица, являющаяся результатом сложения.
+     */
+    Matrix<std::unordered_map, T> operator+(const Matrix<std::unordered_map, T> &other) const
+    {
+        if (size.first != other.shape().first || size.second != other.shape().second)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator +", size, other.shape());
+
+        return merge(other, std::plus<T>());
+    }
+
+    /**
+     * @brief Перегрузка оператора вычитания для матриц.
+     * @param[in] other Матрица.
+     * @return Новая матрица, являющаяся результатом вычитания.
+     */
+    Matrix<std::unordered_map, T> operator-(const Matrix<std::unordered_map, T> &other) const
+    {
+        if (size.first != other.shape().first || size.second != other.shape().second)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator -", size, other.shape());
+
+        return merge(other, std::minus<T>());
+    }
+
+    /**
+     * @brief Прибавление матрицы на месте (см. update).
+     * @param[in] other Матрица.
+     * @return Ссылка на эту матрицу.
+     */
+    Matrix<std::unordered_map, T> &operator+=(const Matrix<std::unordered_map, T> &other)
+    {
+        if (size.first != other.shape().first || size.second != other.shape().second)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator +=", size, other.shape());
+
+        return update(other, std::plus<T>());
+    }
+
+    /**
+     * @brief Вычитание матрицы на месте (см. update).
+     * @param[in] other Матрица.
+     * @return Ссылка на эту матрицу.
+     */
+    Matrix<std::unordered_map, T> &operator-=(const Matrix<std::unordered_map, T> &other)
+    {
+        if (size.first != other.shape().first || size.second != other.shape().second)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator -=", size, other.shape());
+
+        return update(other, std::minus<T>());
+    }
+
+    /**
+     * @brief Умножение на матрицу с присваиванием (произведение строится заново).
+     * @param[in] other Матрица.
+     * @return Ссылка на эту матрицу.
+     */
+    Matrix<std::unordered_map, T> &operator*=(const Matrix<std::unordered_map, T> &other)
+    {
+        *this = *this * other;
+        return *this;
+    }
+
+    /**
+     * @brief Умножение на число на месте: изменяются только хранимые элементы и fill.
+     * @param[in] factor Множитель.
+     * @return Ссылка на эту матрицу.
+     */
+    Matrix<std::unordered_map, T> &operator*=(const T &factor)
+    {
+        fill = fill * factor;
+        auto &target = data.mutate();
+        std::vector<Matrix_key> erased;
+        for (auto &entry : target)
+        {
+            entry.second = entry.second * factor;
+            if (isBackground(entry.second))
+                erased.push_back(entry.first);
+        }
+
+        for (auto &key : erased)
+            target.erase(key);
+        invalidateIndex();
+        return *this;
+    }
+
+    /**
+     * @brief Перегрузка оператора умножения матрицы на число.
+     * @param[in] factor Множитель.
+     * @return Новая матрица, являющаяся результатом умножения.
+     */
+    Matrix<std::unordered_map, T> operator*(const T &factor) const
+    {
+        Matrix<std::unordered_map, T> result(*this);
+        result *= factor;
+        return result;
+    }
+
+    /**
+     * @brief Перегрузка оператора умножения для матриц.
+     * @param[in] other Матрица.
+     * @return Новая матрица, являющаяся результатом умножения.
+     */
+    Matrix<std::unordered_map, T> operator*(const Matrix<std::unordered_map, T> &other) const
+    {
+        if (size.second != other.shape().first)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator *", size, other.shape());
+
+        // Ненулевой fill учитывается поправками ранга 1 (см. multiplyWithFill)
+        if (hasFill() || other.hasFill())
+            return multiplyWithFill(other, false);
+
+        Matrix<std::unordered_map, T> result(size.first, other.shape().second, eps);
+
+        // Хэш-таблица не упорядочена, поэтому используются кэшируемые построчные индексы, упорядоченные по столбцам:
+        // порядок суммирования не зависит от порядка хэширования и совпадает с параллельным multiply
+        const Matrix_index<T> &rows_a = lineIndex(false);
+        const Matrix_index<T> &rows_b = other.lineIndex(false);
+        multiplyRows(rows_a, rows_b, other.shape().second, 0, size.first, [&result](uint64_t row, uint64_t column, const T &value)
+                     { result.set(row, column, value); });
+        return result;
+    }
+
+    /**
+     * @brief Перегрузка оператора унарного минуса.
+     * @return Новая матрица, являющаяся результатом инверсии знака всех элементов текущей матрицы.
+     */
+    Matrix<std::unordered_map, T> operator-() const
+    {
+        Matrix<std::unordered_map, T> result(*this);
+        for (auto &pair : result.data.mutate())
+        {
+            pair.second = -pair.second;
+        }
+        result.fill = -fill;
+        return result;
+    }
+
+    /**
+     * @brief Перегрузка оператора транспонирования.
+     * @return Транспонированная матрица.
+     */
+    Matrix<std::unordered_map, T> operator~() const
+    {
+        Matrix<std::unordered_map, T> result(size.second, size.first, eps);
+        result.fill = fill;
+        auto &target = result.data.mutate();
+        target.reserve(data.size());
+
+        for (auto &entry : data)
+            target.emplace(std::make_pair(entry.first.second, entry.first.first), entry.second);
+
+        return result;
+    }
+
+    /**
+     * @brief Транспонированное представление матрицы без копирования элементов.
+     * Представление хранит слабую ссылку на матрицу и после ее удаления бросает ProxyPointerError.
+     * @return Ленивое транспонирование.
+     */
+    Matrix_transposed<std::unordered_map, T> transposed() const
+    {
+        return Matrix_transposed<std::unordered_map, T>(viewAnchor());
+    }
+
+    /**
+     * @brief Произведение транспонированной матрицы на матрицу (this^T * other) без транспонирования this.
+     * @param[in] other Матрица.
+     * @return Новая матрица, являющаяся результатом умножения.
+     */
+    Matrix<std::unordered_map, T> multiplyTransposed(const Matrix<std::unordered_map, T> &other) const
+    {
+        if (size.first != other.shape().first)
+            throw MatrixShapeError("", __FILE__, __LINE__, "transposed operator *", std::make_pair(size.second, size.first), other.shape());
+
+        if (hasFill() || other.hasFill())
+            return multiplyWithFill(other, true);
+
+        Matrix<std::unordered_map, T> result(size.second, other.shape().second, eps);
+
+        // Строка i результата - сумма a_ki * (строка k матрицы other) по столбцу i матрицы this
+        auto columns_a = buildMatrixIndex(data, size, true);
+        auto rows_b = buildMatrixIndex(other.data, other.size, false);
+
+        std::vector<T> accumulator(other.shape().second + 1);
+        std::vector<bool> occupied(other.shape().second + 1, false);
+        std::vector<uint64_t> touched;
+
+        for (uint64_t i = 1; i + 1 < columns_a.offsets.size(); ++i)
+        {
+            for (uint64_t a = columns_a.offsets[i]; a < columns_a.offsets[i + 1]; ++a)
+            {
+                uint64_t k = columns_a.entries[a].first;
+                const T &value = *columns_a.entries[a].second;
+                for (uint64_t b = rows_b.offsets[k]; b < rows_b.offsets[k + 1]; ++b)
+                {
+                    uint64_t column = rows_b.entries[b].first;
+                    if (occupied[column])
+                        accumulator[column] += value * *rows_b.entries[b].second;
+                    else
+                    {
+                        occupied[column] = true;
+                        accumulator[column] = value * *rows_b.entries[b].second;
+                        touched.push_back(column);
+                    }
+                }
+            }
+
+            for (uint64_t column : touched)
+            {
+                result.set(i, column, accumulator[column]);
+                occupied[column] = false;
+            }
+            touched.clear();
+        }
+        return result;
+    }
+
+    /*
+        =========================== Умножение на вектор ===========================
+    */
+    
+    /**
+     * @brief Перегрузка оператора умножения матрицы на вектор.
+     * Произведение вычисляется отложенно, при присваивании вектору, и может входить
+     * в выражения вида A * x + B * y без промежуточных векторов (см. Expression.h).
+     *
+     * @param[in] other вектор
+     * @return Выражение - произведение матрицы на вектор
+     */
+    Matrix_vector_product<Matrix<std::unordered_map, T>, T> operator*(const Vector<T> &other) const &
+    {
+        if (static_cast<uint64_t>(other.getLen()) != size.second)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator * vector", size, std::make_pair(other.getLen(), 1));
+        return makeMatrixVectorProduct<T>(*this, other);
     }
 
     /**
-     * @brief Метод для установки значения в заданную позицию
+     * @brief Умножение на временный вектор: вектор перемещается в выражение, поэтому его можно
+     * сохранить (auto y = A * Vector<T>(n))
      *
-     * @param[in] row количество строк
-     * @param[in] column количество столбцов
-     * @param[in] value устанавливаемое значение
+     * @param[in] other вектор
+     * @return Выражение, хранящее вектор
      */
-    void set(uint64_t row, uint64_t column, const T &value)
+    auto operator*(Vector<T> &&other) const &
     {
-        if (value.abs() >= eps)
-            data[std::make_pair(row, column)] = value;
+        if (static_cast<uint64_t>(other.getLen()) != size.second)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator * vector", size, std::make_pair(other.getLen(), 1));
+        return makeMatrixVectorProduct<T>(*this, std::move(other));
     }
 
     /**
-     * @brief Получение элемента по заданным координатам
+     * @brief Умножение на вектор временного объекта: матрица перемещается в выражение
      *
-     * @param[in] row номер строки
-     * @param[in] column номер столбца
-     * @return константная ссылка на элемент по заданным координатам
+     * @param[in] other вектор
+     * @return Выражение, хранящее матрицу
      */
-    const T &at(uint64_t row, uint64_t column) const
+    auto operator*(const Vector<T> &other) &&
     {
-        auto it = data.find(std::make_pair(row, column));
-        if (it == data.end())
-        {
-            static const T zero;
-            return zero;
-        }
-        else
-            return it->second;
+        if (static_cast<uint64_t>(other.getLen()) != size.second)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator * vector", size, std::make_pair(other.getLen(), 1));
+        return makeMatrixVectorProduct<T>(std::move(*this), other);
     }
 
     /**
-     * @brief Получение элемента по заданным координатам
+     * @brief Умножение временного объекта на временный вектор: оба операнда перемещаются в выражение
      *
-     * @param[in] coord координаты элемента
-     * @return ссылка на элемент по заданным координатам
+     * @param[in] other вектор
+     * @return Выражение, хранящее оба операнда
      */
-    T &operator[](const std::pair<uint64_t, uint64_t> &coord)
+    auto operator*(Vector<T> &&other) &&
     {
-        return data[coord];
+        if (static_cast<uint64_t>(other.getLen()) != size.second)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator * vector", size, std::make_pair(other.getLen(), 1));
+        return makeMatrixVectorProduct<T>(std::move(*this), std::move(other));
     }
 
     /**
-     * @brief Оператор () для доступа к элементу матрицы по индексам.
-     * @param row Номер строки.
-     * @param column Номер столбца.
-     * @return Ссылка на элемент матрицы в позиции (row, column).
-     * @throws MatrixIndexError Если индексы выходят за пределы размеров матрицы.
+     * @brief Умножение матрицы на вектор с записью в заданный вектор (один проход по ненулевым элементам).
+     * Уже существующие элементы result обнуляются и переиспользуются.
+     *
+     * @param[in] other вектор
+     * @param[out] result вектор для записи произведения (используется его eps)
      */
-    const T &operator()(uint64_t row, uint64_t column) const
+    void multiply(const Vector<T> &other, Vector<T> &result) const
     {
-        if (row < 1 || row > size.first + 1 || column < 1 || column > size.second + 1)
+        if (static_cast<uint64_t>(other.getLen()) != size.second)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator * vector", size, std::make_pair(other.getLen(), 1));
+
+        if (&other == &result)
         {
-            throw MatrixIndexError("", __FILE__, __LINE__, "operator ()", size, {row, column});
+            Vector<T> copy(other);
+            multiply(copy, result);
+            return;
         }
-        return this->at(row, column);
-    }
 
-    /*
-        =========================== Арифметические операции с матрицами, оператор транспонирования ===========================
-    */
+        result.resetValues(size.first);
+        for (auto &entry : data)
+        {
+            uint64_t row = entry.first.first;
+            if (row < 1 || row > size.first || entry.first.second > size.second)
+                continue;
+            result.element(static_cast<int>(row)) += entry.second * other.at(entry.first.second);
+        }
+        if (hasFill())
+            addFillProduct(other, result, false);
+        result.compactValues();
+    }
 
     /**
-     * @brief Перегрузка оператора сложения для матриц.
-     * @param[in] other Матрица.
-     * @return Новая матрица, являющаяся результатом сложения.
+     * @brief Прибавление alpha * this * other к накопителю отложенного выражения
+     *
+     * @param[in] alpha множитель
+     * @param[in] other вектор
+     * @param[in, out] result накопитель
      */
-    Matrix<std::unordered_map, T> operator+(const Matrix<std::unordered_map, T> &other)
+    void multiplyAdd(const T &alpha, const Vector<T> &other, Vector_accumulator<T> &result) const
     {
-        if (size.first != other.shape().first || size.second != other.shape().second)
-            throw MatrixShapeError("", __FILE__, __LINE__, "operator +", size, other.shape());
-
-        Matrix<std::unordered_map, T> result(size.first, size.second, eps);
+        if (hasFill())
+        {
+            Vector<T> product(size.first);
+            multiply(other, product);
+            product.accumulate(result, alpha);
+            return;
+        }
 
-        for (int i = 1; i < size.first + 1; ++i)
+        for (auto &entry : data)
         {
-            for (int j = 1; j < size.second + 1; ++j)
-            {
-                T value = at(i, j) + other.at(i, j);
-                result.set(i, j, value);
-            }
+            uint64_t row = entry.first.first;
+            if (row < 1 || row > size.first || entry.first.second > size.second)
+                continue;
+            result.add(static_cast<int>(row), alpha * (entry.second * other.at(entry.first.second)));
         }
-        return result;
     }
 
     /**
-     * @brief Перегрузка оператора сложения для матриц.
-     * @param[in] other Матрица.
-     * @return Новая матрица, являющаяся результатом сложения.
+     * @brief Параллельное умножение матрицы на вектор.
+     *
+     * @param[in] other вектор
+     * @param[in] policy политика параллельного выполнения
+     * @return Вектор, являющийся произведением матрицы на вектор
      */
-    Matrix<std::unordered_map, T> operator-(const Matrix<std::unordered_map, T> &other)
+    Vector<T> multiply(const Vector<T> &other, const Parallel_policy &policy) const
     {
-        if (size.first != other.shape().first || size.second != other.shape().second)
-            throw MatrixShapeError("", __FILE__, __LINE__, "operator -", size, other.shape());
-
-        Matrix<std::unordered_map, T> result(size.first, size.second, eps);
-
-        for (int i = 1; i < size.first + 1; ++i)
-        {
-            for (int j = 1; j < size.second + 1; ++j)
-            {
-                T value = at(i, j) - other.at(i, j);
-                result.set(i, j, value);
-            }
-        }
+        Vector<T> result(size.first);
+        multiply(other, result, policy);
         return result;
     }
 
     /**
-     * @brief Перегрузка оператора умножения для матриц.
-     * @param[in] other Матрица.
-     * @return Новая матрица, являющаяся результатом умножения.
+     * @brief Параллельное умножение матрицы на вектор с записью в заданный вектор, без копирования матрицы.
+     * Используется кэшируемый построчный индекс (см. lineIndex): он строится один раз, поэтому
+     * повторные умножения (итерационные методы) его не перестраивают. Строки делятся между потоками
+     * по числу ненулевых элементов; внутри строки элементы суммируются по возрастанию столбцов,
+     * поэтому результат не зависит от числа потоков.
+     *
+     * @param[in] other вектор
+     * @param[out] result вектор для записи произведения (используется его eps)
+     * @param[in] policy политика параллельного выполнения
      */
-    Matrix<std::unordered_map, T> operator*(const Matrix<std::unordered_map, T> &other)
+    void multiply(const Vector<T> &other, Vector<T> &result, const Parallel_policy &policy) const
     {
-        if (size.second != other.shape().first)
-            throw MatrixShapeError("", __FILE__, __LINE__, "operator *", size, other.shape());
+        if (static_cast<uint64_t>(other.getLen()) != size.second)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator * vector", size, std::make_pair(other.getLen(), 1));
 
-        Matrix<std::unordered_map, T> result(size.first, size.second, eps);
+        if (hasFill())
+        {
+            multiply(other, result);
+            return;
+        }
 
-        for (int i = 1; i < size.first + 1; ++i)
+        if (&other == &result)
         {
-            for (int k = 1; k < other.shape().second + 1; ++k)
+            Vector<T> copy(other);
+            multiply(copy, result, policy);
+            return;
+        }
+
+        const Matrix_index<T> &index = lineIndex(false);
+        std::vector<uint64_t> bounds = partitionByWork(std::vector<uint64_t>(index.offsets.begin() + 1, index.offsets.end()), policy.threads);
+        std::vector<T> sums(size.first + 1);
+
+        Thread_pool::shared().run(bounds.size() - 1, [&](size_t part)
+                                  {
+            for (uint64_t i = bounds[part] + 1; i < bounds[part + 1] + 1; ++i)
             {
                 T sum = T();
-                for (int j = 1; j < size.second + 1; ++j)
-                {
-                    sum += at(i, j) * other.at(j, k);
-                }
-                result.set(i, k, sum);
-            }
-        }
-        return result;
+                for (uint64_t k = index.offsets[i]; k < index.offsets[i + 1]; ++k)
+                    sum += *index.entries[k].second * other.at(index.entries[k].first);
+                sums[i] = sum;
+            } });
+
+        auto out = result.beginOrdered(size.first);
+        for (uint64_t i = 1; i < size.first + 1; ++i)
+            if (index.offsets[i] != index.offsets[i + 1])
+                result.writeOrdered(out, static_cast<int>(i), sums[i]);
+        result.endOrdered(out);
     }
 
     /**
-     * @brief Перегрузка оператора унарного минуса.
-     * @return Новая матрица, являющаяся результатом инверсии знака всех элементов текущей матрицы.
+     * @brief Параллельное умножение матриц без копирования в другое представление.
+     * Используются кэшируемые построчные индексы обеих матриц; строки делятся между потоками
+     * по числу умножений. Результат совпадает с operator* при любом числе потоков.
+     * @param[in] other Матрица.
+     * @param[in] policy политика параллельного выполнения
+     * @return Новая матрица, являющаяся результатом умножения.
      */
-    Matrix<std::unordered_map, T> operator-() const
+    Matrix<std::unordered_map, T> multiply(const Matrix<std::unordered_map, T> &other, const Parallel_policy &policy) const
     {
-        Matrix<std::unordered_map, T> result(*this);
-        for (auto &pair : result.data)
+        if (size.second != other.size.first)
+            throw MatrixShapeError("", __FILE__, __LINE__, "operator *", size, other.size);
+        if (hasFill() || other.hasFill())
+            return *this * other;
+
+        const Matrix_index<T> &rows_a = lineIndex(false);
+        const Matrix_index<T> &rows_b = other.lineIndex(false);
+
+        // Работа строки i - количество умножений a_ik * b_kj плюс число элементов строки
+        std::vector<uint64_t> work(size.first + 1, 0);
+        for (uint64_t i = 1; i < size.first + 1; ++i)
         {
-            pair.second = -pair.second;
+            work[i] = work[i - 1] + rows_a.offsets[i + 1] - rows_a.offsets[i];
+            for (uint64_t a = rows_a.offsets[i]; a < rows_a.offsets[i + 1]; ++a)
+                work[i] += rows_b.offsets[rows_a.entries[a].first + 1] - rows_b.offsets[rows_a.entries[a].first];
         }
+
+        std::vector<uint64_t> bounds = partitionByWork(work, policy.threads);
+        std::vector<std::vector<std::pair<std::pair<uint64_t, uint64_t>, T>>> parts(bounds.size() - 1);
+
+        Thread_pool::shared().run(parts.size(), [&](size_t part)
+                                  { multiplyRows(rows_a, rows_b, other.shape().second, bounds[part], bounds[part + 1],
+                                                 [&entries = parts[part]](uint64_t row, uint64_t column, const T &value)
+                                                 { entries.emplace_back(std::make_pair(row, column), value); }); });
+
+        Matrix<std::unordered_map, T> result(size.first, other.shape().second, eps);
+        for (auto &entries : parts)
+            for (auto &entry : entries)
+                result.set(entry.first.first, entry.first.second, entry.second);
         return result;
     }
 
     /**
-     * @brief Перегрузка оператора транспонирования.
-     * @return Транспонированная матрица.
+     * @brief Произведение транспонированной матрицы на вектор (this^T * other) за один проход по ненулевым элементам.
+     * @param[in] other Вектор.
+     * @return Вектор, являющийся результатом умножения.
      */
-    Matrix<std::unordered_map, T> operator~() const
+    Vector<T> multiplyTransposed(const Vector<T> &other) const
     {
-        Matrix<std::unordered_map, T> result(size.second, size.first, eps);
-
-        for (int i = 1; i < size.second + 1; ++i)
-        {
-            for (int j = 1; j < size.first + 1; ++j)
-            {
-                result.set(i, j, at(j, i));
-            }
-        }
+        Vector<T> result(size.second);
+        multiplyTransposed(other, result);
         return result;
     }
 
-    /*
-        =========================== Умножение на вектор ===========================
-    */
-    
     /**
-     * @brief Перегрузка оператора умножения матрицы на вектор
+     * @brief Произведение транспонированной матрицы на вектор с записью в заданный вектор.
      *
      * @param[in] other вектор
-     * @return Вектор, являющийся произведением матрицы на вектор
+     * @param[out] result вектор для записи произведения (используется его eps)
      */
-    Vector<T> operator*(const Vector<T> &other)
+    void multiplyTransposed(const Vector<T> &other, Vector<T> &result) const
     {
-        if (other.getLen() != size.second)
-            throw MatrixShapeError("", __FILE__, __LINE__, "operator * vector", size, std::make_pair(other.getLen(), 1));
+        if (static_cast<uint64_t>(other.getLen()) != size.first)
+            throw MatrixShapeError("", __FILE__, __LINE__, "transposed operator * vector", std::make_pair(size.second, size.first), std::make_pair(other.getLen(), 1));
 
-        Vector<T> result(size.first);
+        if (&other == &result)
+        {
+            Vector<T> copy(other);
+            multiplyTransposed(copy, result);
+            return;
+        }
 
-        for (int i = 1; i < size.first + 1; ++i)
+        result.resetValues(size.second);
+        for (auto &entry : data)
         {
-            T sum = T();
-            for (int j = 1; j < size.first + 1; ++j)
-            {
-                sum += at(i, j) * other.at(j);
-            }
-            result.set(i, sum);
+            uint64_t column = entry.first.second;
+            if (column < 1 || column > size.second)
+                continue;
+
+            const T *factor = other.stored(static_cast<int>(entry.first.first));
+            if (factor != nullptr)
+                result.element(static_cast<int>(column)) += entry.second * *factor;
         }
-        return result;
+        if (hasFill())
+            addFillProduct(other, result, true);
+        result.compactValues();
     }
 
     /*
@@ -1147,26 +3523,46 @@ public:
     std::string to_string() const
     {
         std::string result;
-        for (int i = 1; i < size.first + 1; ++i)
+        for (uint64_t i = 1; i < size.first + 1; ++i)
         {
-            for (int j = 1; j < size.second + 1; ++j)
+            for (uint64_t j = 1; j < size.second + 1; ++j)
                 result += at(i, j).to_string() + " ";
             result += "\n";
         }
         return result;
     }
 
+    /**
+     * @brief Явное представление матрицы: все элементы, отличные от нуля больше чем на eps, хранятся,
+     * fill равен нулю (за O(rows * columns))
+     *
+     * @return Матрица с теми же элементами и нулевым fill
+     */
+    Matrix<std::unordered_map, T> materialized() const
+    {
+        Matrix<std::unordered_map, T> result(size.first, size.second, eps);
+        auto &target = result.data.mutate();
+        for (uint64_t i = 1; i < size.first + 1; ++i)
+            for (uint64_t j = 1; j < size.second + 1; ++j)
+            {
+                const T &value = at(i, j);
+                if (value.abs() >= eps)
+                    target.emplace(std::make_pair(i, j), value);
+            }
+        return result;
+    }
+
     /**
      * @brief Конструктор перемещения матрицы.
      * @param[in] other R-value ссылка на другой объект класса Matrix.
      */
-    Matrix(Matrix &&other) noexcept : data(std::move(other.data)), eps(std::move(other.eps)) {}
+    Matrix(Matrix &&other) noexcept : data(std::move(other.data)), eps(std::move(other.eps)), size(std::move(other.size)), fill(std::move(other.fill)) {}
 
     /**
      * @brief Конструктор копирования матрицы.
      * @param[in] other Константная ссылка на другой объект класса Matrix.
      */
-    Matrix(const Matrix &other) : data(other.data), eps(other.eps) {}
+    Matrix(const Matrix &other) : data(other.data), eps(other.eps), size(other.size), fill(other.fill) {}
 
     /**
      * @brief Оператор присваивания.
@@ -1178,9 +3574,11 @@ public:
         if (this == &other)
             return *this;
 
-        data = other.getData();
+        data = other.data;
         eps = other.getEps();
         size = other.shape();
+        fill = other.getFill();
+        invalidateIndex();
         return *this;
     }
 
@@ -1194,25 +3592,147 @@ public:
         if (this == &other)
             return *this;
 
-        data = std::move(other.getData());
+        data = std::move(other.data);
         eps = std::move(other.getEps());
         size = std::move(other.shape());
+        fill = std::move(other.fill);
+        invalidateIndex();
         return *this;
     }
 
+    /*
+        =========================== Срезы и proxy ===========================
+    */
+
     /**
-     * @brief Деструктор
+     * @brief Обход хранимых элементов строки по возрастанию номеров столбцов (за O(nnz строки)
+     * после построения построчного индекса)
      *
+     * Константный метод: одновременные вызовы из нескольких потоков безопасны, пока матрица не изменяется.
+     *
+     * @param[in] row номер строки
+     * @param[in] visit функция, принимающая номер столбца и значение
      */
-    ~Matrix()
+    template <typename Visitor>
+    void forEachInRow(uint64_t row, Visitor visit) const
     {
-        for (auto &proxy : proxies)
-            proxy->delete_ptr();
+        if (row < 1 || row > size.first)
+            return;
+
+        const Matrix_index<T> &index = lineIndex(false);
+        for (uint64_t k = index.offsets[row]; k < index.offsets[row + 1]; ++k)
+            if (index.entries[k].first >= 1)
+                visit(index.entries[k].first, *index.entries[k].second);
     }
 
-    /*
-        =========================== Срезы и proxy ===========================
-    */
+    /**
+     * @brief Обход хранимых элементов столбца по возрастанию номеров строк (за O(nnz столбца)
+     * после построения постолбцового индекса)
+     *
+     * Константный метод: одновременные вызовы из нескольких потоков безопасны, пока матрица не изменяется.
+     *
+     * @param[in] column номер столбца
+     * @param[in] visit функция, принимающая номер строки и значение
+     */
+    template <typename Visitor>
+    void forEachInColumn(uint64_t column, Visitor visit) const
+    {
+        if (column < 1 || column > size.second)
+            return;
+
+        const Matrix_index<T> &index = lineIndex(true);
+        for (uint64_t k = index.offsets[column]; k < index.offsets[column + 1]; ++k)
+            if (index.entries[k].first >= 1)
+                visit(index.entries[k].first, *index.entries[k].second);
+    }
+
+    /**
+     * @brief Обход хранимых элементов блока [r1, r2] x [c1, c2] по возрастанию (строка, столбец).
+     * В каждой строке построчного индекса начало блока находится двоичным поиском,
+     * поэтому обход стоит O(строк блока * log nnz строки + nnz блока).
+     *
+     * @param[in] r1 первая строка
+     * @param[in] c1 первый столбец
+     * @param[in] r2 последняя строка
+     * @param[in] c2 последний столбец
+     * @param[in] visit функция, принимающая номер строки, номер столбца и значение
+     */
+    template <typename Visitor>
+    void forEachInBlock(uint64_t r1, uint64_t c1, uint64_t r2, uint64_t c2, Visitor visit) const
+    {
+        r2 = std::min(r2, size.first);
+        if (r1 < 1 || r1 > r2)
+            return;
+
+        const Matrix_index<T> &index = lineIndex(false);
+        for (uint64_t row = r1; row <= r2; ++row)
+        {
+            auto first = index.entries.begin() + index.offsets[row];
+            auto last = index.entries.begin() + index.offsets[row + 1];
+            auto it = std::lower_bound(first, last, c1, [](const auto &entry, uint64_t column)
+                                       { return entry.first < column; });
+            for (; it != last && it->first <= c2; ++it)
+                visit(row, uint64_t(it->first), *it->second);
+        }
+    }
+
+    /**
+     * @brief Строка матрицы в виде вектора (перебираются только хранимые элементы строки)
+     *
+     * @param[in] row номер строки
+     * @return вектор длины columns
+     * @throws MatrixIndexError если строки нет в матрице
+     */
+    Vector<T> getRow(uint64_t row) const
+    {
+        if (row < 1 || row > size.first)
+            throw MatrixIndexError("", __FILE__, __LINE__, "getRow", size, {row, 1});
+
+        Vector<T> result(static_cast<int>(size.second));
+        if (hasFill())
+        {
+            for (uint64_t j = 1; j < size.second + 1; ++j)
+                result.element(static_cast<int>(j)) = at(row, j);
+            result.compactValues();
+            return result;
+        }
+
+        auto out = result.beginOrdered(static_cast<int>(size.second));
+        forEachInRow(row, [&result, &out](uint64_t column, const T &value)
+                     { result.writeOrdered(out, static_cast<int>(column), value); });
+        result.endOrdered(out);
+        return result;
+    }
+
+    /**
+     * @brief Столбец матрицы в виде вектора (перебираются только хранимые элементы столбца)
+     *
+     * Константный метод: одновременные вызовы из нескольких потоков безопасны, пока матрица не изменяется.
+     *
+     * @param[in] column номер столбца
+     * @return вектор длины rows
+     * @throws MatrixIndexError если столбца нет в матрице
+     */
+    Vector<T> getColumn(uint64_t column) const
+    {
+        if (column < 1 || column > size.second)
+            throw MatrixIndexError("", __FILE__, __LINE__, "getColumn", size, {1, column});
+
+        Vector<T> result(static_cast<int>(size.first));
+        if (hasFill())
+        {
+            for (uint64_t i = 1; i < size.first + 1; ++i)
+                result.element(static_cast<int>(i)) = at(i, column);
+            result.compactValues();
+            return result;
+        }
+
+        auto out = result.beginOrdered(static_cast<int>(size.first));
+        forEachInColumn(column, [&result, &out](uint64_t row, const T &value)
+                        { result.writeOrdered(out, static_cast<int>(row), value); });
+        result.endOrdered(out);
+        return result;
+    }
 
     /**
      * @brief Перегрузка оператора [] для получения среза
@@ -1227,19 +3747,17 @@ public:
         uint64_t r1 = coords.r1;
         uint64_t r2 = coords.r2;
 
-        if (c1 == -1 || r1 == -1)
+        if (c1 == uint64_t(-1) || r1 == uint64_t(-1))
         {
             c1 = 1;
             r1 = 1;
         }
-        if (c2 == -1 || r2 == -1)
+        if (c2 == uint64_t(-1) || r2 == uint64_t(-1))
         {
             c2 = size.second;
             r2 = size.first;
         }
-        Matrix_proxy<std::unordered_map, T> tmp(this, Matrix_coords(r1, c1, r2, c2), Matrix_row_coord(-1), Matrix_column_coord(-1));
-        proxies.push_back(&tmp);
-        return tmp;
+        return Matrix_proxy<std::unordered_map, T>(viewAnchor(), Matrix_coords(r1, c1, r2, c2), Matrix_row_coord(-1), Matrix_column_coord(-1));
     }
 
     /**
@@ -1250,9 +3768,7 @@ public:
      */
     Matrix_proxy<std::unordered_map, T> operator[](const Matrix_row_coord &row)
     {
-        Matrix_proxy<std::unordered_map, T> tmp(this, Matrix_coords(), row, Matrix_column_coord(-1));
-        proxies.push_back(&tmp);
-        return tmp;
+        return Matrix_proxy<std::unordered_map, T>(viewAnchor(), Matrix_coords(), row, Matrix_column_coord(-1));
     }
 
     /**
@@ -1263,100 +3779,183 @@ public:
      */
     Matrix_proxy<std::unordered_map, T> operator[](const Matrix_column_coord &column)
     {
-        Matrix_proxy<std::unordered_map, T> tmp(this, Matrix_coords(), Matrix_row_coord(-1), column);
-        proxies.push_back(&tmp);
-        return tmp;
+        return Matrix_proxy<std::unordered_map, T>(viewAnchor(), Matrix_coords(), Matrix_row_coord(-1), column);
     }
 
     /**
      * @brief Метод для чтения матрицы с файла
      *
-     * @param[in] file файловый поток
+     * Файл отображается в память и разбирается без выделения памяти на каждую строку.
+     *
+     * @param[in] filename имя файла
+     * @param[out] stats статистика чтения (размер, количество элементов, время), если не nullptr
      * @return Прочитанная матрица
      */
-    static Matrix<std::unordered_map, T> readFromFile(std::string &&filename)
+    static Matrix<std::unordered_map, T> readFromFile(std::string &&filename, Read_stats *stats = nullptr)
     {
-        std::ifstream file(filename);
+        auto start = std::chrono::steady_clock::now();
+        Mapped_file file(filename);
         if (!file.is_open())
             throw MatrixReadFromFileError("", __FILE__, __LINE__);
 
-        std::string line, _T1, _T2;
+        Line_scanner scanner(file.data(), file.data() + file.size());
         uint64_t rows, columns;
-        std::vector<std::string> params;
-        while (std::getline(file, line))
-        {
-            if (line.empty() || startsWithHash(line))
-                continue;
+        T fill;
+        readMatrixHeader<T>(scanner, rows, columns, &fill);
 
-            std::istringstream iss(line);
-            params = std::vector<std::string>(std::istream_iterator<std::string>{iss}, std::istream_iterator<std::string>());
+        auto new_matrix = Matrix<std::unordered_map, T>(rows, columns);
+        new_matrix.fill = fill;
 
-            if (params[0] != "matrix")
-                throw MatrixReadFromFileError("File not contains matrix.", __FILE__, __LINE__);
+        uint64_t entries;
+        if (!readEntries<T, 2>(scanner, [&](const uint64_t *idx, const T &value)
+                               { new_matrix.set(idx[0], idx[1], value); },
+                               entries))
+            throw MatrixReadFromFileError("Incorrect matrix element line.", __FILE__, __LINE__);
 
-            if (T::type() != params[1])
-                throw MatrixReadFromFileError("Incorrect type of input matrix.", __FILE__, __LINE__);
+        if (stats != nullptr)
+            *stats = Read_stats{file.size(), entries, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+        return new_matrix;
+    }
 
-            if (params[1] == "rational")
-            {
-                if (params.size() != 4)
-                    throw MatrixReadFromFileError("To many params. Expected 4. But given " + std::to_string(params.size()), __FILE__, __LINE__);
+    /**
+     * @brief Параллельное чтение матрицы с файла
+     *
+     * Часть файла с элементами делится на части, выровненные по строкам; каждая часть разбирается
+     * отдельным потоком в свой координатный буфер. Хэш-таблица резервируется под общее количество элементов и заполняется без перехеширования.
+     *
+     * @param[in] filename имя файла
+     * @param[in] policy политика параллельного выполнения
+     * @param[out] stats статистика чтения (размер, количество элементов, время), если не nullptr
+     * @return Прочитанная матрица (совпадает с результатом последовательного чтения)
+     */
+    static Matrix<std::unordered_map, T> readFromFile(std::string &&filename, const Parallel_policy &policy, Read_stats *stats = nullptr)
+    {
+        auto start = std::chrono::steady_clock::now();
+        Mapped_file file(filename);
+        if (!file.is_open())
+            throw MatrixReadFromFileError("", __FILE__, __LINE__);
 
-                rows = std::stoll(params[2]);
-                columns = std::stoll(params[3]);
-            }
-            else if (params[1] == "complex")
-            {
-                if (params.size() != 6)
-                    throw MatrixReadFromFileError("To many params. Expected 6. But given " + std::to_string(params.size()), __FILE__, __LINE__);
+        Line_scanner scanner(file.data(), file.data() + file.size());
+        uint64_t rows, columns;
+        T fill;
+        readMatrixHeader<T>(scanner, rows, columns, &fill);
 
-                std::map<std::string, std::string> in_types;
-                in_types["a"] = "integer";
-                in_types["s"] = "integer";
-                in_types["i"] = "integer";
-                in_types["l"] = "integer";
-                in_types["f"] = "float";
-                in_types["d"] = "float";
+        auto new_matrix = Matrix<std::unordered_map, T>(rows, columns);
+        new_matrix.fill = fill;
+        auto &target = new_matrix.data.mutate();
 
-                _T1 = T::getTypeNames().first;
-                _T2 = T::getTypeNames().second;
+        std::vector<std::vector<Matrix_entry<T>>> chunks;
+        uint64_t entries = readMatrixEntries<T>(scanner.position(), file.data() + file.size(), new_matrix.eps, policy, chunks, new_matrix.fill);
 
-                if (params[2] != in_types[_T1] || params[3] != in_types[_T2])
-                    throw MatrixReadFromFileError("Incorrect complex im and real field types. ", __FILE__, __LINE__);
+        uint64_t total = 0;
+        for (auto &chunk : chunks)
+            total += chunk.size();
+        target.reserve(total);
 
-                rows = std::stoll(params[4]);
-                columns = std::stoll(params[5]);
-            }
-            break;
-        }
+        // вставка в порядке следования в файле: при повторе координат остается последний элемент
+        for (auto &chunk : chunks)
+            for (auto &entry : chunk)
+                target[entry.first] = std::move(entry.second);
 
-        auto new_matrix = Matrix<std::unordered_map, T>(rows, columns);
+        if (stats != nullptr)
+            *stats = Read_stats{file.size(), entries, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+        return new_matrix;
+    }
 
-        uint64_t idx_1, idx_2;
-        while (std::getline(file, line))
+    /**
+     * @brief Запись матрицы в двоичный файл (заголовок, упорядоченные координаты и значения)
+     *
+     * Двоичный формат не хранит fill, поэтому матрица с ненулевым fill не записывается
+     * (ее можно записать в текстовом формате writeToFile).
+     *
+     * @param[in] filename имя файла
+     * @throws MatrixWriteToFileError если запись не удалась или fill матрицы ненулевой
+     */
+    void writeToBinaryFile(std::string &&filename) const
+    {
+        if (hasFill())
+            throw MatrixWriteToFileError("Binary format does not store fill value.", __FILE__, __LINE__);
+
+        std::vector<const typename Coordinate_hash_map<T>::value_type *> entries;
+        entries.reserve(data.size());
+        for (auto &entry : data)
+            entries.push_back(&entry);
+        std::sort(entries.begin(), entries.end(), [](const auto *lhs, const auto *rhs)
+                  { return lhs->first < rhs->first; });
+
+        std::vector<uint64_t> rows, columns;
+        std::vector<T> values;
+        rows.reserve(entries.size());
+        columns.reserve(entries.size());
+        values.reserve(entries.size());
+        for (auto *entry : entries)
         {
-            if (line.empty() || startsWithHash(line))
-                continue;
+            rows.push_back(entry->first.first);
+            columns.push_back(entry->first.second);
+            values.push_back(entry->second);
+        }
 
-            std::istringstream iss(line);
-            iss >> idx_1 >> idx_2;
-            if (params[1] == "complex")
-            {
-                auto left = line.find('(');
-                auto right = line.find(')');
-                auto valueString = line.substr(left + 1, right - left - 1);
-                auto value = T(valueString.c_str());
-                new_matrix.set(idx_1, idx_2, value);
-            }
-            else if (params[1] == "rational")
-            {
-                auto left = line.find('<');
-                auto right = line.find('>');
-                auto valueString = line.substr(left + 1, right - left - 1);
-                auto value = T(valueString.c_str());
-                new_matrix.set(idx_1, idx_2, value);
-            }
+        Binary_header header = makeBinaryHeader<T>(2, size.first, size.second, eps, values.size());
+        if (!writeBinaryFile(filename, header, {{rows.data(), rows.size() * sizeof(uint64_t)}, {columns.data(), columns.size() * sizeof(uint64_t)}, {values.data(), values.size() * sizeof(T)}}))
+            throw MatrixWriteToFileError("", __FILE__, __LINE__);
+    }
+
+    /**
+     * @brief Чтение матрицы из двоичного файла без разбора текста
+     *
+     * @param[in] filename имя файла, записанного writeToBinaryFile
+     * @return Прочитанная матрица
+     * @throws MatrixReadFromFileError если файл не содержит матрицу типа T
+     */
+    static Matrix<std::unordered_map, T> readFromBinaryFile(std::string &&filename)
+    {
+        auto view = Matrix<Mapped_storage, T>::readFromBinaryFile(std::move(filename));
+        Matrix<std::unordered_map, T> result(view.shape().first, view.shape().second, view.getEps());
+        auto &target = result.data.mutate();
+
+        auto rows = view.getRowIndices();
+        auto columns = view.getColumnIndices();
+        auto values = view.getValues();
+        target.reserve(view.nonZeros());
+        for (uint64_t k = 0; k < view.nonZeros(); ++k)
+            target.emplace(std::make_pair(rows[k], columns[k]), values[k]);
+        return result;
+    }
+
+    /**
+     * @brief Потоковая запись матрицы в текстовом формате readFromFile: записываются только хранимые
+     * элементы, текст формируется в буфере фиксированного размера (время O(nnz), память O(1)).
+     * Ненулевой fill записывается в конец заголовка.
+     *
+     * @param[in, out] out поток вывода
+     * @throws MatrixWriteToFileError если запись в поток не удалась
+     */
+    void writeToFile(std::ostream &out) const
+    {
+        {
+            Text_writer writer(out);
+            writeHeader<T>(writer, "matrix", {size.first, size.second}, hasFill() ? &fill : nullptr);
+            for (auto &entry : data)
+                writeEntry(writer, {entry.first.first, entry.first.second}, entry.second);
         }
-        return new_matrix;
+        if (!out)
+            throw MatrixWriteToFileError("", __FILE__, __LINE__);
+    }
+
+    /**
+     * @brief Запись матрицы в текстовый файл (см. writeToFile(std::ostream &))
+     *
+     * @param[in] filename имя файла
+     * @throws MatrixWriteToFileError если файл не открывается или запись не удалась
+     */
+    void writeToFile(std::string &&filename) const
+    {
+        std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+            throw MatrixWriteToFileError("", __FILE__, __LINE__);
+        writeToFile(file);
     }
-};;
\ No newline at end of file
+};
+
+#include "Compressed.h"
+#include "Mapped.h"
@@ -8,6 +8,9 @@
 #include <algorithm>
 #include <cctype>
 #include <type_traits>
+#include <bit>
+#include <limits>
+#include <charconv>
 
 
 bool startsWithHash(const std::string &input);
@@ -34,6 +37,37 @@ bool checkOverFlow(const char *s);
 template <typename T>
 bool checkOverFlow(int64_t s);
 
+/**
+ * @brief Наибольший общий делитель модулей двух чисел (бинарный алгоритм Стейна)
+ *
+ * @tparam T целочисленный тип
+ * @param[in] a первое число
+ * @param[in] b второе число
+ * @return НОД(|a|, |b|); НОД(0, b) = |b|
+ */
+template <typename T>
+T binaryGcd(T a, T b)
+{
+    using U = std::make_unsigned_t<T>;
+    U u = a < 0 ? static_cast<U>(U(0) - static_cast<U>(a)) : static_cast<U>(a);
+    U v = b < 0 ? static_cast<U>(U(0) - static_cast<U>(b)) : static_cast<U>(b);
+    if (u == 0)
+        return static_cast<T>(v);
+    if (v == 0)
+        return static_cast<T>(u);
+
+    int shift = std::countr_zero(static_cast<U>(u | v));
+    u >>= std::countr_zero(u);
+    do
+    {
+        v >>= std::countr_zero(v);
+        if (u > v)
+            std::swap(u, v);
+        v -= u;
+    } while (v != 0);
+    return static_cast<T>(u << shift);
+}
+
 /**
  * @brief Get the Min Max object
  *
@@ -95,6 +129,208 @@ bool checkOverFlow(const char *s)
 template <typename T>
 bool checkOverFlow(int64_t s)
 {
-    return checkOverFlow<T>(std::to_string(s).c_str());
+    if constexpr (!std::numeric_limits<T>::is_bounded)
+        return false;
+    else
+        return s < static_cast<int64_t>(std::numeric_limits<T>::min()) || s > static_cast<int64_t>(std::numeric_limits<T>::max());
+}
+
+/**
+ * @brief Признак целочисленного типа, пригодного для числителя и знаменателя Rational_number:
+ * знаковые встроенные целые и знаковые целые произвольной точности (Big_integer)
+ *
+ * @tparam T проверяемый тип
+ */
+template <typename T>
+struct is_rational_integer : std::bool_constant<std::numeric_limits<T>::is_specialized && std::numeric_limits<T>::is_integer && std::numeric_limits<T>::is_signed>
+{
+};
+
+/**
+ * @brief Частное двух целых в виде double
+ *
+ * @tparam T целочисленный тип
+ * @param[in] numerator делимое
+ * @param[in] denominator делитель
+ * @return частное
+ */
+template <typename T>
+double ratioToDouble(T numerator, T denominator)
+{
+    return static_cast<double>(numerator) / denominator;
+}
+
+/*
+    Арифметика с проверкой переполнения. Функции возвращают true, если результат не помещается в тип T
+    (значение result в этом случае не определено). Используются встроенные функции компилятора,
+    при их отсутствии - проверка границ до выполнения операции.
+*/
+
+/**
+ * @brief Сложение с проверкой переполнения
+ *
+ * @tparam T знаковый целочисленный тип
+ * @param[in] a первое слагаемое
+ * @param[in] b второе слагаемое
+ * @param[out] result сумма
+ * @return true если произошло переполнение
+ */
+template <typename T>
+bool addOverflow(T a, T b, T &result)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_add_overflow(a, b, &result);
+#else
+    if ((b > 0 && a > std::numeric_limits<T>::max() - b) || (b < 0 && a < std::numeric_limits<T>::min() - b))
+        return true;
+    result = static_cast<T>(a + b);
+    return false;
+#endif
+}
+
+/**
+ * @brief Вычитание с проверкой переполнения
+ *
+ * @tparam T знаковый целочисленный тип
+ * @param[in] a уменьшаемое
+ * @param[in] b вычитаемое
+ * @param[out] result разность
+ * @return true если произошло переполнение
+ */
+template <typename T>
+bool subOverflow(T a, T b, T &result)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_sub_overflow(a, b, &result);
+#else
+    if ((b < 0 && a > std::numeric_limits<T>::max() + b) || (b > 0 && a < std::numeric_limits<T>::min() + b))
+        return true;
+    result = static_cast<T>(a - b);
+    return false;
+#endif
+}
+
+/**
+ * @brief Умножение с проверкой переполнения
+ *
+ * @tparam T знаковый целочисленный тип
+ * @param[in] a первый множитель
+ * @param[in] b второй множитель
+ * @param[out] result произведение
+ * @return true если произошло переполнение
+ */
+template <typename T>
+bool mulOverflow(T a, T b, T &result)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_mul_overflow(a, b, &result);
+#else
+    if (a != 0 && b != 0)
+    {
+        if ((a == -1 && b == std::numeric_limits<T>::min()) || (b == -1 && a == std::numeric_limits<T>::min()))
+            return true;
+        T limit = (a > 0) == (b > 0) ? std::numeric_limits<T>::max() : std::numeric_limits<T>::min();
+        if (a > 0 ? (b > 0 ? b > limit / a : b < limit / a) : (b > 0 ? a < limit / b : b < limit / a))
+            return true;
+    }
+    result = static_cast<T>(a * b);
+    return false;
+#endif
+}
+
+
+/*
+    Разбор чисел в диапазоне [first, last) без выделения памяти. Функции возвращают указатель
+    на первый неразобранный символ или nullptr, если число не найдено или не помещается в тип.
+*/
+
+/**
+ * @brief Пропуск пробельных символов (кроме перевода строки)
+ *
+ * @param[in] first начало диапазона
+ * @param[in] last конец диапазона
+ * @return указатель на первый непробельный символ
+ */
+inline const char *skipSpaces(const char *first, const char *last)
+{
+    while (first != last && (*first == ' ' || *first == '\t' || *first == '\r'))
+        ++first;
+    return first;
 }
 
+/**
+ * @brief Разбор беззнакового десятичного целого
+ *
+ * @param[in] first начало диапазона
+ * @param[in] last конец диапазона
+ * @param[out] value число
+ * @return указатель на символ после числа или nullptr
+ */
+inline const char *scanUnsigned(const char *first, const char *last, uint64_t &value)
+{
+    const char *start = first;
+    uint64_t result = 0;
+    for (; first != last && static_cast<unsigned char>(*first - '0') < 10; ++first)
+    {
+        uint64_t digit = static_cast<uint64_t>(*first - '0');
+        if (result > (std::numeric_limits<uint64_t>::max() - digit) / 10)
+            return nullptr;
+        result = result * 10 + digit;
+    }
+    if (first == start)
+        return nullptr;
+    value = result;
+    return first;
+}
+
+/**
+ * @brief Разбор знакового десятичного целого вида '[+-]digits'
+ *
+ * @param[in] first начало диапазона
+ * @param[in] last конец диапазона
+ * @param[out] value число
+ * @return указатель на символ после числа или nullptr
+ */
+inline const char *scanSigned(const char *first, const char *last, int64_t &value)
+{
+    bool negative = first != last && *first == '-';
+    if (first != last && (*first == '-' || *first == '+'))
+        ++first;
+
+    uint64_t magnitude;
+    first = scanUnsigned(first, last, magnitude);
+    if (first == nullptr || magnitude > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) + negative)
+        return nullptr;
+    value = negative ? static_cast<int64_t>(0 - magnitude) : static_cast<int64_t>(magnitude);
+    return first;
+}
+
+/**
+ * @brief Разбор числа в формате целого или с плавающей точкой
+ *
+ * @tparam T арифметический тип
+ * @param[in] first начало диапазона
+ * @param[in] last конец диапазона
+ * @param[out] value число
+ * @return указатель на символ после числа или nullptr
+ */
+template <typename T>
+const char *scanNumber(const char *first, const char *last, T &value)
+{
+    if constexpr (std::is_floating_point<T>::value)
+    {
+        if (first != last && *first == '+')
+            ++first;
+        auto [end, error] = std::from_chars(first, last, value);
+        return error == std::errc() ? end : nullptr;
+    }
+    else
+    {
+        int64_t result;
+        first = scanSigned(first, last, result);
+        if (first == nullptr || checkOverFlow<T>(result))
+            return nullptr;
+        value = static_cast<T>(result);
+        return first;
+    }
+}
@@ -0,0 +1,138 @@
+#include "Parallel.h"
+
+#include <algorithm>
+
+Thread_pool::Thread_pool(unsigned threads)
+{
+    for (unsigned i = 0; i < threads; ++i)
+        workers.emplace_back(&Thread_pool::work, this);
+}
+
+Thread_pool::~Thread_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto &worker : workers)
+        worker.join();
+}
+
+unsigned Thread_pool::size() const
+{
+    return workers.size();
+}
+
+Thread_pool &Thread_pool::shared()
+{
+    static Thread_pool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+    return pool;
+}
+
+void Thread_pool::run(size_t tasks, const std::function<void(size_t)> &task)
+{
+    if (tasks == 0)
+        return;
+
+    if (tasks == 1 || workers.empty())
+    {
+        for (size_t i = 0; i < tasks; ++i)
+            task(i);
+        return;
+    }
+
+    std::lock_guard<std::mutex> run_lock(run_mutex);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &task;
+        job_tasks = tasks;
+        next = 0;
+        finished = 0;
+        error = nullptr;
+        ++generation;
+    }
+    wake.notify_all();
+
+    execute(&task, tasks);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this, tasks]
+              { return finished == tasks && active == 0; });
+
+    // Опоздавшие потоки не должны увидеть задачу, которая уже завершена
+    job = nullptr;
+    job_tasks = 0;
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+void Thread_pool::work()
+{
+    uint64_t seen = 0;
+    while (true)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        wake.wait(lock, [this, &seen]
+                  { return stopping || generation != seen; });
+        if (stopping)
+            return;
+
+        seen = generation;
+        const std::function<void(size_t)> *task = job;
+        size_t tasks = job_tasks;
+        if (task == nullptr)
+            continue;
+
+        ++active;
+        lock.unlock();
+
+        execute(task, tasks);
+
+        lock.lock();
+        --active;
+        lock.unlock();
+        done.notify_all();
+    }
+}
+
+void Thread_pool::execute(const std::function<void(size_t)> *task, size_t tasks)
+{
+    for (size_t i = next++; i < tasks; i = next++)
+    {
+        try
+        {
+            (*task)(i);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error)
+                error = std::current_exception();
+        }
+        ++finished;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    done.notify_all();
+}
+
+std::vector<uint64_t> partitionByWork(const std::vector<uint64_t> &offsets, unsigned parts)
+{
+    uint64_t rows = offsets.empty() ? 0 : offsets.size() - 1;
+    uint64_t total = rows == 0 ? 0 : offsets.back() - offsets.front();
+
+    std::vector<uint64_t> bounds(1, 0);
+    if (parts > 1 && total > 0)
+    {
+        for (unsigned p = 1; p < parts; ++p)
+        {
+            uint64_t target = offsets.front() + total * p / parts;
+            uint64_t bound = std::lower_bound(offsets.begin(), offsets.end(), target) - offsets.begin();
+            if (bound > bounds.back() && bound < rows)
+                bounds.push_back(bound);
+        }
+    }
+    bounds.push_back(rows);
+    return bounds;
+}
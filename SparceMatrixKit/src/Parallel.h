@@ -0,0 +1,108 @@
+#pragma once
+
+#include <iostream>
+#include "stdint.h"
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+
+/**
+ * @brief Политика параллельного выполнения матричных операций
+ *
+ * threads задает только количество частей, на которые делится работа. Части выполняются общим
+ * пулом (Thread_pool::shared()), размер которого фиксирован: hardware_concurrency - 1 рабочих
+ * потоков и вызывающий поток. Поэтому значение больше числа аппаратных потоков не добавляет
+ * параллелизма, а лишь дробит работу на более мелкие части.
+ */
+struct Parallel_policy
+{
+    unsigned threads; /**< Количество частей, на которые делится работа (не меньше 1) */
+
+    /**
+     * @brief Конструктор
+     *
+     * @param[in] threads количество частей, по умолчанию - число аппаратных потоков
+     */
+    explicit Parallel_policy(unsigned threads = std::thread::hardware_concurrency()) : threads(threads == 0 ? 1 : threads) {}
+};
+
+/**
+ * @brief Пул потоков для параллельного выполнения пронумерованных задач
+ *
+ * Вызов run() блокирует вызывающий поток до завершения всех задач; вызывающий поток
+ * также выполняет задачи. Одновременные вызовы run() выполняются по очереди.
+ */
+class Thread_pool
+{
+public:
+    /**
+     * @brief Конструктор
+     *
+     * @param[in] threads количество рабочих потоков (помимо вызывающего)
+     */
+    explicit Thread_pool(unsigned threads);
+
+    /**
+     * @brief Деструктор, дожидается завершения рабочих потоков
+     *
+     */
+    ~Thread_pool();
+
+    Thread_pool(const Thread_pool &) = delete;
+    Thread_pool &operator=(const Thread_pool &) = delete;
+
+    /**
+     * @brief Выполнение задач task(0), ..., task(tasks - 1)
+     *
+     * @param[in] tasks количество задач
+     * @param[in] task задача, получающая свой номер
+     * @throws Первое исключение, выброшенное задачами
+     */
+    void run(size_t tasks, const std::function<void(size_t)> &task);
+
+    /**
+     * @brief Количество рабочих потоков
+     *
+     * @return количество потоков
+     */
+    unsigned size() const;
+
+    /**
+     * @brief Общий пул размером в число аппаратных потоков
+     *
+     * @return ссылка на пул
+     */
+    static Thread_pool &shared();
+
+private:
+    void work();
+    void execute(const std::function<void(size_t)> *task, size_t tasks);
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::mutex run_mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+
+    const std::function<void(size_t)> *job = nullptr;
+    size_t job_tasks = 0;
+    uint64_t generation = 0;
+    unsigned active = 0;
+    bool stopping = false;
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> finished{0};
+    std::exception_ptr error;
+};
+
+/**
+ * @brief Разбиение строк на части с примерно равной работой
+ *
+ * @param[in] offsets префиксные суммы работы по строкам (rows + 1 элемент, offsets[0] = 0), например границы строк CSR
+ * @param[in] parts желаемое количество частей
+ * @return границы частей: часть p содержит строки с номерами (bounds[p], bounds[p + 1]] (нумерация строк с 1)
+ */
+std::vector<uint64_t> partitionByWork(const std::vector<uint64_t> &offsets, unsigned parts);
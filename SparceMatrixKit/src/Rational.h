@@ -7,22 +7,173 @@
 #include "Complex.h"
 #include "Exceptions.h"
 #include "Other.h"
+#include "BigInteger.h"
 
 /**
  * @brief Шаблонный класс для хранения рационльного числа
  *
- * @tparam тип числителя и знаменателя (знаковый целый тип int8_t, int16_t, ...)
+ * Число всегда хранится в несократимом виде: знаменатель положителен, НОД(числитель, знаменатель) = 1,
+ * ноль хранится как 0/1. Арифметика сокращает операнды до умножения, чтобы промежуточные значения
+ * оставались малыми.
+ *
+ * @tparam тип числителя и знаменателя (знаковый целый тип int8_t, int16_t, ... или Big_integer)
  */
 template <typename T>
 class Rational_number
 {
-    static_assert(std::is_signed<T>::value && std::is_integral<T>::value);
+    static_assert(is_rational_integer<T>::value, "Rational_number requires a signed integer type (int8_t, ..., int64_t or Big_integer)");
 
 protected:
     T numtor; /**< Числитель */
     T dentor; /**< Знаменатель */
 
 private:
+    /**
+     * @brief Создание числа из несократимой дроби с положительным знаменателем
+     *
+     * @param[in] numerator числитель
+     * @param[in] denominator знаменатель
+     * @return рациональное число
+     */
+    static Rational_number<T> fromReduced(T numerator, T denominator)
+    {
+        Rational_number<T> result;
+        if (numerator != 0)
+        {
+            result.numtor = numerator;
+            result.dentor = denominator;
+        }
+        return result;
+    }
+
+    /**
+     * @brief Сумма с дробью c / d (алгоритм Хенрици: сокращение на НОД знаменателей до умножения)
+     *
+     * @param[in] c числитель (несократимая дробь)
+     * @param[in] d знаменатель (d > 0)
+     * @param[in] object имя операции для сообщения об ошибке
+     * @return несократимая сумма
+     * @throws RationalOverflowError если числитель или знаменатель результата не помещается в T
+     */
+    Rational_number<T> sum(T c, T d, const char *object) const
+    {
+        T g = binaryGcd(this->dentor, d);
+        T left, right, numerator, denominator;
+        if (mulOverflow(this->numtor, static_cast<T>(d / g), left) || mulOverflow(c, static_cast<T>(this->dentor / g), right) ||
+            addOverflow(left, right, numerator))
+            throw RationalOverflowError<int64_t>("", __FILE__, __LINE__, object, static_cast<int64_t>(this->numtor), static_cast<int64_t>(this->dentor));
+
+        T h = binaryGcd(numerator, g);
+        if (mulOverflow(static_cast<T>(this->dentor / g), static_cast<T>(d / h), denominator))
+            throw RationalOverflowError<int64_t>("", __FILE__, __LINE__, object, static_cast<int64_t>(this->numtor), static_cast<int64_t>(this->dentor));
+        return fromReduced(static_cast<T>(numerator / h), denominator);
+    }
+
+    /**
+     * @brief Произведение на дробь c / d с перекрестным сокращением до умножения
+     *
+     * @param[in] c числитель (несократимая дробь)
+     * @param[in] d знаменатель (d > 0)
+     * @param[in] object имя операции для сообщения об ошибке
+     * @return несократимое произведение
+     * @throws RationalOverflowError если числитель или знаменатель результата не помещается в T
+     */
+    Rational_number<T> product(T c, T d, const char *object) const
+    {
+        if (this->numtor == 0 || c == 0)
+            return Rational_number<T>();
+
+        T g_1 = binaryGcd(this->numtor, d);
+        T g_2 = binaryGcd(c, this->dentor);
+        T numerator, denominator;
+        if (mulOverflow(static_cast<T>(this->numtor / g_1), static_cast<T>(c / g_2), numerator) ||
+            mulOverflow(static_cast<T>(this->dentor / g_2), static_cast<T>(d / g_1), denominator))
+            throw RationalOverflowError<int64_t>("", __FILE__, __LINE__, object, static_cast<int64_t>(this->numtor), static_cast<int64_t>(this->dentor));
+        return fromReduced(numerator, denominator);
+    }
+
+    /**
+     * @brief Сумма с целым числом k: (a + b * k) / b остается несократимой
+     *
+     * @param[in] k целое число
+     * @param[in] object имя операции для сообщения об ошибке
+     * @return несократимая сумма
+     * @throws RationalOverflowError если числитель результата не помещается в T
+     */
+    Rational_number<T> sumInteger(T k, const char *object) const
+    {
+        T shift, numerator;
+        if (mulOverflow(this->dentor, k, shift) || addOverflow(this->numtor, shift, numerator))
+            throw RationalOverflowError<int64_t>("", __FILE__, __LINE__, object, static_cast<int64_t>(this->numtor), static_cast<int64_t>(this->dentor));
+        return fromReduced(numerator, this->dentor);
+    }
+
+    /**
+     * @brief Сравнение дробей a / b и c / d (b, d > 0) без переполнения. Если перекрестные произведения
+     * не помещаются в T, сравниваются целые части, а затем остатки - через обратные дроби (как в алгоритме Евклида)
+     *
+     * @return -1, 0 или 1 (a / b меньше, равно или больше c / d)
+     */
+    static int compareFractions(T a, T b, T c, T d)
+    {
+        T left, right;
+        if (!mulOverflow(a, d, left) && !mulOverflow(c, b, right))
+            return left < right ? -1 : (right < left ? 1 : 0);
+
+        T q_1 = a / b, q_2 = c / d;
+        if (q_1 != q_2)
+            return q_1 < q_2 ? -1 : 1;
+
+        // равные целые части: сравниваются остатки r_1 / b и r_2 / d, |r_i| меньше знаменателя
+        T r_1 = a % b, r_2 = c % d;
+        if ((r_1 < 0) != (r_2 < 0) || r_1 == 0 || r_2 == 0)
+            return r_1 < r_2 ? -1 : (r_2 < r_1 ? 1 : 0);
+        if (r_1 < 0)
+            return compareFractions(static_cast<T>(-r_2), d, static_cast<T>(-r_1), b);
+        return compareFractions(d, r_2, b, r_1);
+    }
+
+    /**
+     * @brief Сравнение с другим числом
+     *
+     * @param[in] other рациональное число
+     * @return -1, 0 или 1
+     */
+    int compare(const Rational_number<T> &other) const
+    {
+        return compareFractions(this->numtor, this->dentor, other.getNumtor(), other.getDentor());
+    }
+
+    /**
+     * @brief Смена знака с проверкой переполнения
+     *
+     * @param[in] value число
+     * @param[in] object имя операции для сообщения об ошибке
+     * @return -value
+     */
+    static T negate(T value, const char *object)
+    {
+        T result;
+        if (subOverflow(T(0), value, result))
+            throw RationalOverflowError<int64_t>("", __FILE__, __LINE__, object, static_cast<int64_t>(value));
+        return result;
+    }
+
+    /**
+     * @brief Частное от деления на дробь c / d (c != 0)
+     *
+     * @param[in] c числитель делителя
+     * @param[in] d знаменатель делителя (d > 0)
+     * @param[in] object имя операции для сообщения об ошибке
+     * @return несократимое частное
+     */
+    Rational_number<T> quotient(T c, T d, const char *object) const
+    {
+        if (c > 0)
+            return product(d, c, object);
+        return product(negate(d, object), negate(c, object), object);
+    }
+
 public:
 
     static auto getTypeNames()
@@ -38,6 +189,44 @@ public:
         return "rational";
     }
 
+    /**
+     * @brief Разбор числа из диапазона символов вида 'n / m' или 'k' без выделения памяти
+     *
+     * Если диапазон не разбирается как пара int64_t (лишние символы, значения вне int64_t),
+     * используется конструктор из строки с его обработкой ошибок.
+     *
+     * @param[in] first начало диапазона
+     * @param[in] last конец диапазона
+     * @return прочитанное число
+     */
+    static Rational_number<T> fromChars(const char *first, const char *last)
+    {
+        int64_t numerator = 0, denominator = 1;
+        const char *p = scanSigned(skipSpaces(first, last), last, numerator);
+        if (p != nullptr)
+            p = skipSpaces(p, last);
+        if (p != nullptr && p != last && *p == '/')
+        {
+            p = scanSigned(skipSpaces(p + 1, last), last, denominator);
+            if (p != nullptr)
+                p = skipSpaces(p, last);
+        }
+        if (p != last)
+            return Rational_number<T>(std::string(first, last).c_str());
+
+        if (checkOverFlow<T>(numerator) || checkOverFlow<T>(denominator))
+            throw RationalOverflowError<int64_t>("", __FILE__, __LINE__, "Rational_number<T> fromChars(const char *first, const char *last)", numerator, denominator);
+
+        if (denominator == 0)
+            throw RationalZeroDivisionError<int64_t>("", __FILE__, __LINE__, "Rational_number<T> fromChars(const char *first, const char *last)", numerator);
+
+        Rational_number<T> result;
+        result.numtor = static_cast<T>(numerator);
+        result.dentor = static_cast<T>(denominator);
+        result.make_canonical();
+        return result;
+    }
+
     /**
      * @brief Конструктор по умолчанию
      *
@@ -58,8 +247,9 @@ public:
         if (checkOverFlow<T>(numerator) || checkOverFlow<T>(denominator))
             throw RationalOverflowError<int64_t>("", __FILE__, __LINE__, "Rational_number(int64_t numerator, int64_t denominator)", numerator, denominator);
 
-        this->numtor = (denominator > 0 ? 1 : -1) * static_cast<T>(numerator);
-        this->dentor = (denominator > 0 ? 1 : -1) * static_cast<T>(denominator);
+        this->numtor = static_cast<T>(numerator);
+        this->dentor = static_cast<T>(denominator);
+        make_canonical();
     }
 
     /**
@@ -71,7 +261,24 @@ public:
     {
         std::string s(str);
         size_t i = s.find('/');
-        int64_t numerator, denominator;
+        if constexpr (!std::numeric_limits<T>::is_bounded)
+        {
+            try
+            {
+                this->numtor = T(s.substr(0, i));
+                this->dentor = i != std::string::npos ? T(s.substr(i + 1)) : T(1);
+            }
+            catch (std::invalid_argument &ex)
+            {
+                throw RationalOverflowError<int64_t>("", __FILE__, __LINE__, "Rational_number(const char *str)", 0, 0);
+            }
+            if (this->dentor == T(0))
+                throw RationalZeroDivisionError<int64_t>("", __FILE__, __LINE__, "Rational_number(const char *str)", static_cast<int64_t>(this->numtor));
+            make_canonical();
+            return;
+        }
+
+        int64_t numerator = 0, denominator = 0;
         if (i != std::string::npos)
         {
             try
@@ -102,16 +309,9 @@ public:
         if (denominator == 0)
             throw RationalZeroDivisionError("", __FILE__, __LINE__, "Rational_number(const char *str)", numerator);
 
-        if (numerator == 0)
-        {
-            this->numtor = 0;
-            this->dentor = 1;
-        }
-        else
-        {
-            this->numtor = (denominator > 0 ? 1 : -1) * static_cast<T>(numerator);
-            this->dentor = (denominator > 0 ? 1 : -1) * static_cast<T>(denominator);
-        }
+        this->numtor = static_cast<T>(numerator);
+        this->dentor = static_cast<T>(denominator);
+        make_canonical();
     }
 
     /**
@@ -140,15 +340,37 @@ public:
         if (denominator == 0)
             throw RationalZeroDivisionError("", __FILE__, __LINE__, "RRational_number(const char *num, const char *denom)", numerator);
 
-        if (numerator == 0)
+        this->numtor = static_cast<T>(numerator);
+        this->dentor = static_cast<T>(denominator);
+        make_canonical();
+    }
+
+    /**
+     * @brief Запись числа в виде 'n / m' или 'k' (формат файлов readFromFile)
+     *
+     * @tparam Writer тип буферизованного потока (Text_writer)
+     * @param[in, out] writer поток
+     */
+    template <typename Writer>
+    void writeTo(Writer &writer) const
+    {
+        if constexpr (std::is_integral<T>::value)
         {
-            this->numtor = 0;
-            this->dentor = 1;
+            writer.appendNumber(static_cast<int64_t>(this->numtor));
+            if (this->dentor != 1)
+            {
+                writer.append(" / ", 3);
+                writer.appendNumber(static_cast<int64_t>(this->dentor));
+            }
         }
         else
         {
-            this->numtor = (denominator > 0 ? 1 : -1) * static_cast<T>(numerator);
-            this->dentor = (denominator > 0 ? 1 : -1) * static_cast<T>(denominator);
+            writer.append(this->numtor.to_string());
+            if (this->dentor != T(1))
+            {
+                writer.append(" / ", 3);
+                writer.append(this->dentor.to_string());
+            }
         }
     }
 
@@ -189,7 +411,7 @@ public:
      */
     T round() const
     {
-        return static_cast<T>(std::round(static_cast<double>(this->numtor) / this->dentor));
+        return static_cast<T>(static_cast<int64_t>(std::round(ratioToDouble(this->numtor, this->dentor))));
     }
 
     /**
@@ -199,7 +421,7 @@ public:
      */
     explicit operator double() const
     {
-        return static_cast<double>(this->numtor) / this->dentor;
+        return ratioToDouble(this->numtor, this->dentor);
     }
 
     /**
@@ -221,15 +443,7 @@ public:
      * @param[in] other рациональное число
      * @return ссылка на измененный элемент
      */
-    Rational_number<T> &operator=(const Rational_number<T> &other)
-    {
-        if (this != &other)
-        {
-            this->numtor = other.getNumtor();
-            this->dentor = other.getDentor();
-        }
-        return *this;
-    }
+    Rational_number<T> &operator=(const Rational_number<T> &other) = default;
 
     /**
      * @brief Оператор присваивания к стандартным типам
@@ -258,15 +472,7 @@ public:
      */
     Rational_number<T> operator+(const Rational_number<T> &other) const
     {
-        uint64_t numerator = this->numtor * other.getDentor() + other.getNumtor() * this->dentor;
-        uint64_t denominator = this->dentor * other.getDentor();
-
-        if (checkOverFlow<T>(numerator) || checkOverFlow<T>(denominator))
-            throw RationalOverflowError<int64_t>("", __FILE__, __LINE__, "Rational_number<T> operator+(const Rational_number<T> &other) const", numerator, denominator);
-
-        if (numerator == 0)
-            return Rational_number<T>(0, 1);
-        return Rational_number<T>(numerator, denominator);
+        return sum(other.getNumtor(), other.getDentor(), "Rational_number<T> operator+(const Rational_number<T> &other) const");
     }
 
     /**
@@ -277,18 +483,7 @@ public:
      */
     Rational_number<T> &operator+=(const Rational_number<T> &other)
     {
-        uint64_t numerator = this->numtor * other.getDentor() + other.getNumtor() * this->dentor;
-        uint64_t denominator = this->dentor * other.getDentor();
-
-        if (checkOverFlow<T>(numerator) || checkOverFlow<T>(denominator))
-            throw RationalOverflowError<int64_t>("", __FILE__, __LINE__, "Rational_number<T> &operator+=(const Rational_number<T> &other)", numerator, denominator);
-
-        this->numtor = static_cast<T>(numerator);
-        if (this->numtor == 0)
-            this->dentor = 1;
-        else
-            this->dentor = static_cast<T>(denominator);
-        return *this;
+        return *this = sum(other.getNumtor(), other.getDentor(), "Rational_number<T> &operator+=(const Rational_number<T> &other)");
     }
 
     /*
@@ -306,14 +501,7 @@ public:
     {
         static_assert(std::is_convertible<OtherT, T>::value, "Invalid type conversion");
 
-        int64_t numerator = this->numtor + this->dentor * other;
-
-        if (checkOverFlow<T>(numerator))
-            throw RationalOverflowError<int64_t>("", __FILE__, __LINE__, "Rational_number<T> operator+(const OtherT &other) const", numerator);
-
-        if (numerator == 0)
-            return Rational_number<T>(0, 1);
-        return Rational_number<T>(numerator, this->dentor);
+        return sumInteger(static_cast<T>(other), "Rational_number<T> operator+(const OtherT &other) const");
     }
 
     /**
@@ -327,15 +515,7 @@ public:
     {
         static_assert(std::is_convertible<OtherT, T>::value, "Invalid type conversion");
 
-        int64_t numerator = this->numtor + this->dentor * other;
-
-        if (checkOverFlow<T>(numerator))
-            throw RationalOverflowError<int64_t>("", __FILE__, __LINE__, "Rational_number<T> operator+(const OtherT &other) const", numerator);
-
-        this->numtor = static_cast<T>(numerator);
-        if (this->numtor == 0)
-            this->dentor = 1;
-        return *this;
+        return *this = sumInteger(static_cast<T>(other), "Rational_number<T> &operator+=(const OtherT &other)");
     }
 
     /**
@@ -363,33 +543,31 @@ public:
     template <typename OtherT = double, typename OtherU = OtherT>
     Complex_number<OtherT, OtherU> operator+(const Complex_number<OtherT, OtherU> &other) const
     {
-        return Complex_number<OtherT, OtherU>(static_cast<OtherT>(static_cast<double>(this->numtor) / this->dentor)) + other;
+        return Complex_number<OtherT, OtherU>(static_cast<OtherT>(ratioToDouble(this->numtor, this->dentor))) + other;
     }
 
     /**
      * @brief Оператор префиксного инкримента
      *
      * @return ссылка на измененный элемент
+     * @throws RationalOverflowError если числитель результата не помещается в T
      */
     Rational_number<T> &operator++()
     {
-        this->numtor += this->dentor;
-        if (this->numtor == 0)
-            this->dentor = 1;
-        return *this;
+        return *this = sumInteger(T(1), "Rational_number<T> &operator++()");
     }
 
     /**
      * @brief Оператор постфиксного инкримента
      *
-     * @return ссылка на измененный элемент
+     * @return значение до увеличения
+     * @throws RationalOverflowError если числитель результата не помещается в T
      */
-    Rational_number<T> &operator++(int val)
+    Rational_number<T> operator++(int)
     {
-        this->numtor += this->dentor;
-        if (this->numtor == 0)
-            this->dentor = 1;
-        return *this;
+        Rational_number<T> old = *this;
+        ++*this;
+        return old;
     }
 
     /*
@@ -404,11 +582,7 @@ public:
      */
     Rational_number<T> operator-(const Rational_number<T> &other) const
     {
-        T numerator = this->numtor * other.getDentor() - other.getNumtor() * this->dentor;
-        T denominator = this->dentor * other.getDentor();
-        if (numerator == 0)
-            return Rational_number<T>(0, 1);
-        return Rational_number<T>(numerator, denominator);
+        return sum(negate(other.getNumtor(), "Rational_number<T> operator-(const Rational_number<T> &other) const"), other.getDentor(), "Rational_number<T> operator-(const Rational_number<T> &other) const");
     }
 
     /**
@@ -419,12 +593,7 @@ public:
      */
     Rational_number<T> &operator-=(const Rational_number<T> &other)
     {
-        this->numtor = this->numtor * other.getDentor() - other.getNumtor() * this->dentor;
-        if (this->numtor == 0)
-            this->dentor = 1;
-        else
-            this->dentor *= other.getDentor();
-        return *this;
+        return *this = sum(negate(other.getNumtor(), "Rational_number<T> &operator-=(const Rational_number<T> &other)"), other.getDentor(), "Rational_number<T> &operator-=(const Rational_number<T> &other)");
     }
 
     /*
@@ -442,10 +611,7 @@ public:
     {
         static_assert(std::is_convertible<OtherT, T>::value, "Invalid type conversion");
 
-        T numerator = this->numtor - this->dentor * static_cast<T>(other);
-        if (numerator == 0)
-            return Rational_number<T>(0, 1);
-        return Rational_number<T>(numerator, this->dentor);
+        return sumInteger(negate(static_cast<T>(other), "Rational_number<T> operator-(const OtherT &other) const"), "Rational_number<T> operator-(const OtherT &other) const");
     }
 
     /**
@@ -459,10 +625,7 @@ public:
     {
         static_assert(std::is_convertible<OtherT, T>::value, "Invalid type conversion");
 
-        this->numtor -= static_cast<T>(other) * this->dentor;
-        if (this->numtor == 0)
-            this->dentor = 1;
-        return *this;
+        return *this = *this - other;
     }
 
     /**
@@ -500,7 +663,17 @@ public:
      */
     Rational_number<T> operator-() const
     {
-        return Rational_number<T>(-this->numtor, this->dentor);
+        return fromReduced(negate(this->numtor, "Rational_number<T> operator-() const"), this->dentor);
+    }
+
+    /**
+     * @brief Сопряженное число (для рационального числа совпадает с ним самим)
+     *
+     * @return копия числа
+     */
+    Rational_number<T> conj() const
+    {
+        return *this;
     }
 
     /*
@@ -515,11 +688,7 @@ public:
      */
     Rational_number<T> operator*(const Rational_number<T> &other) const
     {
-        T numerator = this->numtor * other.getNumtor();
-        T denominator = this->dentor * other.getDentor();
-        if (numerator == 0)
-            return Rational_number<T>(0, 1);
-        return Rational_number<T>(numerator, denominator);
+        return product(other.getNumtor(), other.getDentor(), "Rational_number<T> operator*(const Rational_number<T> &other) const");
     }
 
     /**
@@ -530,12 +699,7 @@ public:
      */
     Rational_number<T> &operator*=(const Rational_number<T> &other)
     {
-        this->numtor *= other.getNumtor();
-        if (this->numtor == 0)
-            this->dentor = 1;
-        else
-            this->dentor *= other.getDentor();
-        return *this;
+        return *this = product(other.getNumtor(), other.getDentor(), "Rational_number<T> &operator*=(const Rational_number<T> &other)");
     }
 
     /*
@@ -553,12 +717,7 @@ public:
     {
         static_assert(std::is_convertible<OtherT, T>::value, "Invalid type conversion");
 
-        if (other == 0)
-            return Rational_number<T>(0, 1);
-
-        T numerator = this->numtor * static_cast<T>(other);
-        T denominator = this->dentor;
-        return Rational_number<T>(numerator, denominator);
+        return product(static_cast<T>(other), 1, "Rational_number<T> operator*(const OtherT &other) const");
     }
 
     /**
@@ -572,10 +731,7 @@ public:
     {
         static_assert(std::is_convertible<OtherT, T>::value, "Invalid type conversion");
 
-        this->numtor *= static_cast<T>(other);
-        if (this->numtor == 0)
-            this->dentor = 1;
-        return *this;
+        return *this = product(static_cast<T>(other), 1, "Rational_number<T> &operator*=(const OtherT &other)");
     }
 
     /**
@@ -603,8 +759,8 @@ public:
     template <typename OtherT = double, typename OtherU = OtherT>
     Complex_number<OtherT, OtherU> operator*(const Complex_number<OtherT, OtherU> &other) const
     {
-        OtherT re = static_cast<OtherT>(static_cast<double>(this->numtor) / this->dentor * other.getReal());
-        OtherU im = static_cast<OtherU>(static_cast<double>(this->numtor) / this->dentor * other.getImag());
+        OtherT re = static_cast<OtherT>(ratioToDouble(this->numtor, this->dentor) * other.getReal());
+        OtherU im = static_cast<OtherU>(ratioToDouble(this->numtor, this->dentor) * other.getImag());
         return Complex_number<OtherT, OtherU>(re, im);
     }
 
@@ -622,11 +778,7 @@ public:
     {
         if (other.getNumtor() == 0)
             throw RationalZeroDivisionError<int64_t>("", __FILE__, __LINE__, "Rational_number<T> operator/(const Rational_number<T> &other) const", this->to_string(), other.to_string());
-        T numerator = this->numtor * other.getDentor();
-        T denominator = this->dentor * other.getNumtor();
-        if (numerator == 0)
-            return Rational_number<T>(0, 1);
-        return Rational_number<T>((denominator > 0 ? 1 : -1) * numerator, (denominator > 0 ? 1 : -1) * denominator);
+        return quotient(other.getNumtor(), other.getDentor(), "Rational_number<T> operator/(const Rational_number<T> &other) const");
     }
 
     /**
@@ -640,11 +792,7 @@ public:
         if (other.getNumtor() == 0)
             throw RationalZeroDivisionError<int64_t>("", __FILE__, __LINE__, "Rational_number<T> &operator/=(const Rational_number<T> &other)", this->to_string(), other.to_string());
 
-        this->numtor *= other.getDentor();
-        this->dentor *= other.getNumtor();
-        this->numtor *= (dentor > 0 ? 1 : -1);
-        this->dentor *= (dentor > 0 ? 1 : -1);
-        return *this;
+        return *this = quotient(other.getNumtor(), other.getDentor(), "Rational_number<T> &operator/=(const Rational_number<T> &other)");
     }
 
     /*
@@ -665,9 +813,7 @@ public:
         if (other == 0)
             throw RationalZeroDivisionError<int64_t>("", __FILE__, __LINE__, "Rational_number<T> operator/(const OtherT &other) const", this->to_string(), std::to_string(other));
 
-        T numerator = this->numtor;
-        T denominator = this->dentor * static_cast<T>(other);
-        return Rational_number<T>((denominator > 0 ? 1 : -1) * numerator, (denominator > 0 ? 1 : -1) * denominator);
+        return quotient(static_cast<T>(other), 1, "Rational_number<T> operator/(const OtherT &other) const");
     }
 
     /**
@@ -683,12 +829,7 @@ public:
         if (other == 0)
             throw RationalZeroDivisionError<int64_t>("", __FILE__, __LINE__, "Rational_number<T> &operator/=(const OtherT &other)", this->to_string(), std::to_string(other));
 
-        if (other == 0)
-            throw std::logic_error("Cant devide by zero");
-
-        this->dentor *= static_cast<T>(other);
-        this->dentor *= (dentor > 0 ? 1 : -1);
-        return *this;
+        return *this = quotient(static_cast<T>(other), 1, "Rational_number<T> &operator/=(const OtherT &other)");
     }
 
     /**
@@ -716,7 +857,7 @@ public:
     template <typename OtherT = double, typename OtherU = OtherT>
     Complex_number<OtherT, OtherU> operator/(const Complex_number<OtherT, OtherU> &other) const
     {
-        Complex_number<OtherT, OtherU> tmp(static_cast<double>(this->numtor) / this->dentor);
+        Complex_number<OtherT, OtherU> tmp(ratioToDouble(this->numtor, this->dentor));
         return tmp / other;
     }
 
@@ -733,7 +874,7 @@ public:
      */
     bool operator<(const Rational_number<T> &other) const
     {
-        return (this->numtor * other.getDentor()) < (other.getNumtor() * this->dentor);
+        return compare(other) < 0;
     }
 
     /**
@@ -773,7 +914,7 @@ public:
      */
     bool operator<=(const Rational_number<T> &other) const
     {
-        return (this->numtor * other.getDentor()) <= (other.getNumtor() * this->dentor);
+        return compare(other) <= 0;
     }
 
     /**
@@ -813,7 +954,7 @@ public:
      */
     bool operator>(const Rational_number<T> &other) const
     {
-        return (this->numtor * other.getDentor()) > (other.getNumtor() * this->dentor);
+        return compare(other) > 0;
     }
 
     /**
@@ -853,7 +994,7 @@ public:
      */
     bool operator>=(const Rational_number<T> &other) const
     {
-        return (this->numtor * other.getDentor()) >= (other.getNumtor() * this->dentor);
+        return compare(other) >= 0;
     }
 
     /**
@@ -893,7 +1034,7 @@ public:
      */
     bool operator==(const Rational_number<T> &other) const
     {
-        return (this->numtor * other.getDentor()) == (other.getNumtor() * this->dentor);
+        return this->numtor == other.getNumtor() && this->dentor == other.getDentor();
     }
 
     /**
@@ -933,7 +1074,7 @@ public:
      */
     bool operator!=(const Rational_number<T> &other) const
     {
-        return (this->numtor * other.getDentor()) != (other.getNumtor() * this->dentor);
+        return !(*this == other);
     }
 
     /**
@@ -978,20 +1119,27 @@ public:
     }
 
     /**
-     * @brief Приведение дроби к несократимой
+     * @brief Приведение дроби к несократимой с положительным знаменателем. Знак меняется после
+     * сокращения, поэтому, например, INT64_MIN / -2 приводится к 2^62 / 1 без переполнения
      *
+     * @throws RationalOverflowError если после сокращения знаменатель отрицателен и смена знака не помещается в T
      */
     void make_canonical()
     {
-        T numerator = (this->numtor > 0 ? 1 : -1) * this->numtor;
-        T denomerator = (this->dentor > 0 ? 1 : -1) * this->dentor;
-        while (numerator != denomerator)
-            if (numerator > denomerator)
-                numerator -= denomerator;
-            else
-                denomerator -= numerator;
-        this->numtor /= numerator;
-        this->dentor /= denomerator;
+        if (this->numtor == 0)
+        {
+            this->dentor = 1;
+            return;
+        }
+
+        T divisor = binaryGcd(this->numtor, this->dentor);
+        this->numtor /= divisor;
+        this->dentor /= divisor;
+        if (this->dentor < 0)
+        {
+            this->numtor = negate(this->numtor, "make_canonical()");
+            this->dentor = negate(this->dentor, "make_canonical()");
+        }
     }
 
     /**
@@ -1001,7 +1149,7 @@ public:
      */
     double abs() const
     {
-        return std::abs(static_cast<double>(this->numtor) / (this->dentor));
+        return std::abs(ratioToDouble(this->numtor, this->dentor));
     }
 
     /**
@@ -1011,6 +1159,9 @@ public:
      */
     std::string to_string() const
     {
-        return std::to_string(this->numtor) + '/' + std::to_string(this->dentor);
+        if constexpr (std::is_integral<T>::value)
+            return std::to_string(this->numtor) + '/' + std::to_string(this->dentor);
+        else
+            return this->numtor.to_string() + '/' + this->dentor.to_string();
     }
 };
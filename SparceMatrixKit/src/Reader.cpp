@@ -0,0 +1,86 @@
+#include "Reader.h"
+
+#include <fstream>
+#include <sstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SPARCE_MATRIX_KIT_MMAP
+#endif
+
+Mapped_file::Mapped_file(const std::string &filename)
+{
+#if defined(SPARCE_MATRIX_KIT_MMAP)
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+
+    struct stat info;
+    if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode))
+    {
+        opened = true;
+        length = static_cast<uint64_t>(info.st_size);
+        if (length == 0)
+        {
+            ::close(fd);
+            return;
+        }
+
+        void *address = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address != MAP_FAILED)
+        {
+            ::madvise(address, length, MADV_SEQUENTIAL);
+            begin = static_cast<const char *>(address);
+            mapped = true;
+            ::close(fd);
+            return;
+        }
+    }
+    ::close(fd);
+#endif
+
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open())
+    {
+        opened = false;
+        return;
+    }
+
+    std::ostringstream content;
+    content << file.rdbuf();
+    buffer = content.str();
+    begin = buffer.data();
+    length = buffer.size();
+    opened = true;
+}
+
+Mapped_file::~Mapped_file()
+{
+#if defined(SPARCE_MATRIX_KIT_MMAP)
+    if (mapped)
+        ::munmap(const_cast<char *>(begin), length);
+#endif
+}
+
+std::vector<const char *> splitLines(const char *first, const char *last, unsigned parts)
+{
+    std::vector<const char *> bounds{first};
+    uint64_t length = last - first;
+    for (unsigned p = 1; p < parts; ++p)
+    {
+        const char *bound = first + length * p / parts;
+        if (bound <= bounds.back())
+            continue;
+
+        const char *line_end = static_cast<const char *>(std::memchr(bound - 1, '\n', last - bound + 1));
+        if (line_end == nullptr)
+            break;
+        if (line_end + 1 > bounds.back() && line_end + 1 < last)
+            bounds.push_back(line_end + 1);
+    }
+    bounds.push_back(last);
+    return bounds;
+}
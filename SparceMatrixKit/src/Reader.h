@@ -0,0 +1,398 @@
+#pragma once
+
+#include <iostream>
+#include "stdint.h"
+#include <string>
+#include <string_view>
+#include <chrono>
+#include <cstring>
+#include <vector>
+#include <map>
+#include <iterator>
+#include <sstream>
+#include <algorithm>
+#include <atomic>
+#include <limits>
+
+#include "Other.h"
+#include "Exceptions.h"
+#include "Parallel.h"
+
+/**
+ * @brief Статистика чтения файла
+ *
+ */
+struct Read_stats
+{
+    uint64_t bytes = 0;   /**< Размер файла в байтах */
+    uint64_t entries = 0; /**< Количество прочитанных элементов */
+    double seconds = 0;   /**< Время чтения в секундах */
+
+    /**
+     * @brief Скорость чтения
+     *
+     * @return мегабайт (10^6 байт) в секунду
+     */
+    double throughput() const
+    {
+        return seconds > 0 ? bytes / seconds / 1e6 : 0;
+    }
+};
+
+/**
+ * @brief Файл, отображённый в память только для чтения
+ *
+ * Если отображение недоступно (не POSIX-система или специальный файл), содержимое читается в буфер целиком.
+ */
+class Mapped_file
+{
+public:
+    /**
+     * @brief Конструктор
+     *
+     * @param[in] filename имя файла
+     */
+    explicit Mapped_file(const std::string &filename);
+
+    Mapped_file(const Mapped_file &) = delete;
+    Mapped_file &operator=(const Mapped_file &) = delete;
+
+    /**
+     * @brief Деструктор, снимающий отображение
+     *
+     */
+    ~Mapped_file();
+
+    /**
+     * @brief Проверка, что файл открыт
+     *
+     * @return true, если содержимое файла доступно
+     */
+    bool is_open() const
+    {
+        return opened;
+    }
+
+    /**
+     * @brief Начало содержимого файла
+     *
+     */
+    const char *data() const
+    {
+        return begin;
+    }
+
+    /**
+     * @brief Размер файла в байтах
+     *
+     */
+    uint64_t size() const
+    {
+        return length;
+    }
+
+private:
+    const char *begin = nullptr; /**< Начало содержимого */
+    uint64_t length = 0;         /**< Размер содержимого */
+    bool opened = false;         /**< Файл открыт */
+    bool mapped = false;         /**< Содержимое отображено в память (иначе хранится в buffer) */
+    std::string buffer;          /**< Содержимое файла, если отображение недоступно */
+};
+
+/**
+ * @brief Построчный просмотр текста без копирования
+ *
+ * Возвращаются только значимые строки: пустые строки и строки, начинающиеся с '#', пропускаются,
+ * комментарий в конце строки отбрасывается.
+ */
+class Line_scanner
+{
+public:
+    /**
+     * @brief Конструктор
+     *
+     * @param[in] first начало текста
+     * @param[in] last конец текста
+     */
+    Line_scanner(const char *first, const char *last) : cursor(first), end(last) {}
+
+    /**
+     * @brief Получение следующей значимой строки
+     *
+     * @param[out] line строка (без перевода строки и комментария)
+     * @return false, если текст закончился
+     */
+    bool next(std::string_view &line)
+    {
+        while (cursor != end)
+        {
+            const char *first = skipSpaces(cursor, end);
+            const char *last = static_cast<const char *>(std::memchr(first, '\n', end - first));
+            cursor = last == nullptr ? end : last + 1;
+            if (last == nullptr)
+                last = end;
+
+            const char *comment = static_cast<const char *>(std::memchr(first, '#', last - first));
+            if (comment != nullptr)
+                last = comment;
+            if (first != last)
+            {
+                line = std::string_view(first, last - first);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Начало непросмотренной части текста
+     *
+     */
+    const char *position() const
+    {
+        return cursor;
+    }
+
+private:
+    const char *cursor; /**< Начало непросмотренной части */
+    const char *end;    /**< Конец текста */
+};
+
+/**
+ * @brief Чтение строк с элементами вида 'i_1 ... i_N <value>' (rational) или 'i_1 ... i_N (value)' (complex)
+ *
+ * @tparam T тип элементов (должен иметь статический метод fromChars)
+ * @tparam N количество индексов в строке
+ * @tparam Store тип функции сохранения
+ * @param[in] scanner источник строк, расположенный после заголовка
+ * @param[in] store функция store(const uint64_t *indices, const T &value)
+ * @param[out] entries количество прочитанных элементов
+ * @return false, если встретилась строка неверного формата
+ */
+template <typename T, size_t N, typename Store>
+bool readEntries(Line_scanner &scanner, Store &&store, uint64_t &entries)
+{
+    const bool complex = std::strcmp(T::type(), "complex") == 0;
+    const char open = complex ? '(' : '<';
+    const char close = complex ? ')' : '>';
+
+    std::string_view line;
+    uint64_t indices[N];
+    entries = 0;
+    while (scanner.next(line))
+    {
+        const char *p = line.data();
+        const char *last = line.data() + line.size();
+        for (size_t i = 0; i < N && p != nullptr; ++i)
+            p = scanUnsigned(skipSpaces(p, last), last, indices[i]);
+        if (p == nullptr)
+            return false;
+
+        p = skipSpaces(p, last);
+        const char *right = static_cast<const char *>(std::memchr(p, close, last - p));
+        if (p == last || *p != open || right == nullptr)
+            return false;
+
+        store(indices, T::fromChars(p + 1, right));
+        ++entries;
+    }
+    return true;
+}
+
+/**
+ * @brief Разбор размера из заголовка файла
+ *
+ * @tparam Error тип исключения
+ * @param[in] param параметр заголовка
+ * @param[in] limit наибольшее допустимое значение
+ * @return размер
+ * @throws Error если параметр не является целым числом от 0 до limit
+ */
+template <typename Error>
+uint64_t parseHeaderSize(const std::string &param, uint64_t limit = std::numeric_limits<uint64_t>::max())
+{
+    uint64_t value = 0;
+    const char *last = param.data() + param.size();
+    if (scanUnsigned(param.data(), last, value) != last || value > limit)
+        throw Error("Incorrect size in header: " + param, __FILE__, __LINE__);
+    return value;
+}
+
+/**
+ * @brief Чтение заголовка матрицы 'matrix rational R C [<fill>]' или 'matrix complex T1 T2 R C [(fill)]'
+ *
+ * @tparam T тип элементов матрицы
+ * @param[in] scanner источник строк, заголовок - первая значимая строка
+ * @param[out] rows количество строк
+ * @param[out] columns количество столбцов
+ * @param[out] fill значение неуказанных элементов (T(), если в заголовке его нет); nullptr - хранилище не поддерживает fill
+ * @throws MatrixReadFromFileError если заголовок не соответствует типу T или содержит fill, а fill == nullptr
+ */
+template <typename T>
+void readMatrixHeader(Line_scanner &scanner, uint64_t &rows, uint64_t &columns, T *fill = nullptr)
+{
+    std::string_view line;
+    if (!scanner.next(line))
+        throw MatrixReadFromFileError("File not contains matrix.", __FILE__, __LINE__);
+
+    const bool complex = std::strcmp(T::type(), "complex") == 0;
+    size_t open = line.find(complex ? '(' : '<');
+    if (fill != nullptr)
+        *fill = T();
+    if (open != std::string_view::npos)
+    {
+        size_t close = line.find(complex ? ')' : '>', open);
+        if (close == std::string_view::npos)
+            throw MatrixReadFromFileError("Incorrect fill value in header.", __FILE__, __LINE__);
+        if (fill == nullptr)
+            throw MatrixReadFromFileError("Fill value is not supported by this matrix storage.", __FILE__, __LINE__);
+        *fill = T::fromChars(line.data() + open + 1, line.data() + close);
+        line = line.substr(0, open);
+    }
+
+    std::istringstream iss{std::string(line)};
+    std::vector<std::string> params(std::istream_iterator<std::string>{iss}, std::istream_iterator<std::string>());
+
+    if (params.empty() || params[0] != "matrix")
+        throw MatrixReadFromFileError("File not contains matrix.", __FILE__, __LINE__);
+
+    if (params.size() < 2 || T::type() != params[1])
+        throw MatrixReadFromFileError("Incorrect type of input matrix.", __FILE__, __LINE__);
+
+    if (params[1] == "rational")
+    {
+        if (params.size() != 4)
+            throw MatrixReadFromFileError("To many params. Expected 4. But given " + std::to_string(params.size()), __FILE__, __LINE__);
+
+        rows = parseHeaderSize<MatrixReadFromFileError>(params[2]);
+        columns = parseHeaderSize<MatrixReadFromFileError>(params[3]);
+    }
+    else if (params[1] == "complex")
+    {
+        if (params.size() != 6)
+            throw MatrixReadFromFileError("To many params. Expected 6. But given " + std::to_string(params.size()), __FILE__, __LINE__);
+
+        std::map<std::string, std::string> in_types;
+        in_types["a"] = "integer";
+        in_types["s"] = "integer";
+        in_types["i"] = "integer";
+        in_types["l"] = "integer";
+        in_types["f"] = "float";
+        in_types["d"] = "float";
+
+        std::string _T1 = T::getTypeNames().first;
+        std::string _T2 = T::getTypeNames().second;
+
+        if (params[2] != in_types[_T1] || params[3] != in_types[_T2])
+            throw MatrixReadFromFileError("Incorrect complex im and real field types. ", __FILE__, __LINE__);
+
+        rows = parseHeaderSize<MatrixReadFromFileError>(params[4]);
+        columns = parseHeaderSize<MatrixReadFromFileError>(params[5]);
+    }
+}
+
+/**
+ * @brief Элемент матрицы в координатном формате ((строка, столбец), значение)
+ *
+ */
+template <typename T>
+using Matrix_entry = std::pair<std::pair<uint64_t, uint64_t>, T>;
+
+/**
+ * @brief Разбиение текста на части примерно равного размера, границы которых совпадают с началами строк
+ *
+ * @param[in] first начало текста
+ * @param[in] last конец текста
+ * @param[in] parts желаемое количество частей
+ * @return границы частей: часть p - [bounds[p], bounds[p + 1]) (непустые части, не больше parts)
+ */
+std::vector<const char *> splitLines(const char *first, const char *last, unsigned parts);
+
+/**
+ * @brief Параллельное чтение элементов матрицы: части текста, выровненные по строкам, разбираются
+ * на разных потоках в отдельные координатные буферы
+ *
+ * @tparam T тип элементов матрицы
+ * @param[in] first начало части файла с элементами
+ * @param[in] last конец файла
+ * @param[in] eps элементы, отличающиеся от fill по модулю меньше чем на eps, пропускаются
+ * @param[in] policy политика параллельного выполнения
+ * @param[out] chunks буферы частей в порядке следования в файле
+ * @param[in] fill значение неуказанных элементов
+ * @return количество прочитанных элементов
+ * @throws MatrixReadFromFileError если встретилась строка неверного формата
+ */
+template <typename T>
+uint64_t readMatrixEntries(const char *first, const char *last, double eps, const Parallel_policy &policy, std::vector<std::vector<Matrix_entry<T>>> &chunks, const T &fill = T())
+{
+    std::vector<const char *> bounds = splitLines(first, last, policy.threads);
+    chunks.assign(bounds.size() - 1, {});
+    std::vector<uint64_t> counts(chunks.size(), 0);
+    std::atomic<bool> correct{true};
+    const bool has_fill = fill != T();
+
+    Thread_pool::shared().run(chunks.size(), [&](size_t part)
+                              {
+        Line_scanner scanner(bounds[part], bounds[part + 1]);
+        std::vector<Matrix_entry<T>> &chunk = chunks[part];
+        chunk.reserve((bounds[part + 1] - bounds[part]) / 16);
+        if (!readEntries<T, 2>(scanner, [&](const uint64_t *idx, const T &value)
+                               {
+                                   if ((has_fill ? (value - fill).abs() : value.abs()) >= eps)
+                                       chunk.emplace_back(std::make_pair(idx[0], idx[1]), value);
+                               },
+                               counts[part]))
+            correct = false; });
+
+    if (!correct)
+        throw MatrixReadFromFileError("Incorrect matrix element line.", __FILE__, __LINE__);
+
+    uint64_t entries = 0;
+    for (uint64_t count : counts)
+        entries += count;
+    return entries;
+}
+
+/**
+ * @brief Слияние координатных буферов в один массив, упорядоченный по (строка, столбец)
+ *
+ * Буферы сортируются параллельно и сливаются попарно; сортировка и слияние устойчивы, поэтому
+ * одинаковые координаты остаются в порядке следования в файле (последний элемент - последний в файле).
+ *
+ * @tparam T тип элементов матрицы
+ * @param[in, out] chunks буферы в порядке следования в файле (содержимое перемещается)
+ * @return упорядоченный массив элементов
+ */
+template <typename T>
+std::vector<Matrix_entry<T>> sortEntries(std::vector<std::vector<Matrix_entry<T>>> &chunks)
+{
+    auto less = [](const Matrix_entry<T> &lhs, const Matrix_entry<T> &rhs)
+    { return lhs.first < rhs.first; };
+
+    if (chunks.empty())
+        return {};
+
+    Thread_pool::shared().run(chunks.size(), [&](size_t part)
+                              { std::stable_sort(chunks[part].begin(), chunks[part].end(), less); });
+
+    while (chunks.size() > 1)
+    {
+        std::vector<std::vector<Matrix_entry<T>>> merged((chunks.size() + 1) / 2);
+        Thread_pool::shared().run(merged.size(), [&](size_t part)
+                                  {
+            if (2 * part + 1 == chunks.size())
+            {
+                merged[part] = std::move(chunks[2 * part]);
+                return;
+            }
+            std::vector<Matrix_entry<T>> &left = chunks[2 * part], &right = chunks[2 * part + 1];
+            merged[part].reserve(left.size() + right.size());
+            std::merge(std::make_move_iterator(left.begin()), std::make_move_iterator(left.end()),
+                       std::make_move_iterator(right.begin()), std::make_move_iterator(right.end()),
+                       std::back_inserter(merged[part]), less);
+            std::vector<Matrix_entry<T>>().swap(left);
+            std::vector<Matrix_entry<T>>().swap(right); });
+        chunks = std::move(merged);
+    }
+    return std::move(chunks.front());
+}
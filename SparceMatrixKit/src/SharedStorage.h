@@ -0,0 +1,156 @@
+#pragma once
+
+#include <iostream>
+#include "stdint.h"
+#include <memory>
+
+/**
+ * @brief Контейнер, разделяемый копиями до первого изменения (copy-on-write)
+ *
+ * Копирование и перемещение стоят O(1): копии ссылаются на один контейнер. Чтение выполняется
+ * через константный интерфейс, изменение - только через mutate(), который копирует контейнер,
+ * если он разделяется с другими объектами. Пустой контейнер память не занимает.
+ *
+ * Ссылки и итераторы, полученные через mutate(), остаются действительными до следующего
+ * копирования владельца: после него изменение по старой ссылке было бы видно обеим копиям.
+ * Если ссылка на элемент отдается наружу и может пережить копирование, контейнер нужно получать
+ * через leak(): после этого копии объекта получают собственный контейнер (как в реализациях
+ * std::string с copy-on-write), и изменение по выданной ссылке видно только владельцу.
+ *
+ * @tparam Data тип контейнера
+ */
+template <typename Data>
+class Shared_storage
+{
+public:
+    using key_type = typename Data::key_type;
+    using mapped_type = typename Data::mapped_type;
+    using value_type = typename Data::value_type;
+    using const_iterator = typename Data::const_iterator;
+
+    /**
+     * @brief Конструктор пустого контейнера
+     *
+     */
+    Shared_storage() = default;
+
+    /**
+     * @brief Конструктор копирования: контейнер разделяется, если на его элементы не выданы ссылки
+     *
+     * @param[in] other копируемый объект
+     */
+    Shared_storage(const Shared_storage &other) : storage(other.leaked && other.storage ? std::make_shared<Data>(*other.storage) : other.storage) {}
+
+    Shared_storage(Shared_storage &&other) noexcept = default;
+
+    /**
+     * @brief Копирующее присваивание (см. конструктор копирования)
+     *
+     * @param[in] other копируемый объект
+     * @return ссылка на этот объект
+     */
+    Shared_storage &operator=(const Shared_storage &other)
+    {
+        if (this != &other)
+        {
+            storage = other.leaked && other.storage ? std::make_shared<Data>(*other.storage) : other.storage;
+            leaked = false;
+        }
+        return *this;
+    }
+
+    Shared_storage &operator=(Shared_storage &&other) noexcept = default;
+
+    /**
+     * @brief Контейнер только для чтения
+     *
+     * @return константная ссылка на контейнер
+     */
+    const Data &get() const
+    {
+        static const Data empty;
+        return storage ? *storage : empty;
+    }
+
+    /**
+     * @brief Контейнер для изменения; разделяемый контейнер предварительно копируется
+     *
+     * @return ссылка на контейнер, принадлежащий только этому объекту
+     */
+    Data &mutate()
+    {
+        if (!storage)
+            storage = std::make_shared<Data>();
+        else if (storage.use_count() > 1)
+            storage = std::make_shared<Data>(*storage);
+        return *storage;
+    }
+
+    /**
+     * @brief Контейнер для изменения, ссылки на элементы которого выдаются наружу: с этого момента
+     * копии объекта не разделяют контейнер, а копируют его
+     *
+     * @return ссылка на контейнер, принадлежащий только этому объекту
+     */
+    Data &leak()
+    {
+        Data &data = mutate();
+        leaked = true;
+        return data;
+    }
+
+    /**
+     * @brief Проверка, что контейнер разделяется с другими объектами
+     *
+     */
+    bool isShared() const
+    {
+        return storage && storage.use_count() > 1;
+    }
+
+    /**
+     * @brief Замена содержимого без копирования
+     *
+     * @param[in] data новое содержимое
+     */
+    void assign(Data &&data)
+    {
+        storage = std::make_shared<Data>(std::move(data));
+        leaked = false;
+    }
+
+    /*
+        =========================== Чтение ===========================
+    */
+
+    size_t size() const
+    {
+        return get().size();
+    }
+
+    const_iterator begin() const
+    {
+        return get().begin();
+    }
+
+    const_iterator end() const
+    {
+        return get().end();
+    }
+
+    template <typename Key>
+    const_iterator find(const Key &key) const
+    {
+        return get().find(key);
+    }
+
+    template <typename Key>
+    const_iterator lower_bound(const Key &key) const
+    {
+        return get().lower_bound(key);
+    }
+
+private:
+    std::shared_ptr<Data> storage; /**< Контейнер (nullptr - пустой) */
+    bool leaked = false;           /**< На элементы контейнера выданы ссылки (см. leak()) */
+};
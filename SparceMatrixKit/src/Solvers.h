@@ -0,0 +1,416 @@
+#pragma once
+
+#include <iostream>
+#include "stdint.h"
+#include <vector>
+#include <cmath>
+#include <chrono>
+#include <utility>
+#include <algorithm>
+
+#include "Vector.h"
+#include "Exceptions.h"
+
+/*
+    Итерационные (крыловские) методы решения систем A x = b:
+    solveCG - сопряженные градиенты (A эрмитова положительно определенная),
+    solveBiCGSTAB и solveGMRES (с перезапуском) - для произвольной невырожденной A.
+
+    Матрица передается шаблонным параметром M: подходит любой тип с методами shape() и
+    multiply(vector, result) (Matrix<std::map, T>, Matrix<std::unordered_map, T>, Matrix<Compressed_storage, T>).
+    Элементы должны поддерживать conj(), abs() и умножение на double (Complex_number<double, double>;
+    вещественная система задается комплексными числами с нулевой мнимой частью).
+
+    Все векторы итераций хранятся плотно в Solver_workspace и выделяются один раз: внутри итерации
+    используются только multiply, dot, nrm2, axpy и scal, которые пишут в уже выделенную память.
+*/
+
+/**
+ * @brief Параметры итерационного метода
+ *
+ */
+struct Solver_options
+{
+    double tolerance = 1e-10;  /**< Требуемая относительная невязка ||b - A x|| / ||b|| */
+    int max_iterations = 1000; /**< Наибольшее количество итераций (для GMRES - суммарно по всем циклам) */
+    int restart = 30;          /**< Размерность подпространства Крылова до перезапуска GMRES */
+};
+
+/**
+ * @brief Статистика решения системы
+ *
+ */
+struct Solver_stats
+{
+    bool converged = false; /**< Достигнута ли требуемая невязка */
+    int iterations = 0;     /**< Количество выполненных итераций */
+    int products = 0;       /**< Количество умножений матрицы на вектор */
+    double residual = 0;    /**< Относительная невязка по завершении */
+    double seconds = 0;     /**< Время решения в секундах */
+};
+
+/**
+ * @brief Буферы итерационных методов. Память выделяется при первом решении и переиспользуется
+ * последующими решениями систем того же размера.
+ *
+ * @tparam T тип элементов
+ */
+template <typename T>
+class Solver_workspace
+{
+public:
+    /**
+     * @brief Плотные векторы для итераций
+     *
+     * @param[in] len длина векторов
+     * @param[in] count количество векторов
+     * @return массив не менее чем из count плотных векторов длины len
+     */
+    std::vector<Vector<T>> &vectors(int len, size_t count)
+    {
+        if (!buffers.empty() && buffers.front().getLen() != len)
+            buffers.clear();
+        while (buffers.size() < count)
+        {
+            buffers.emplace_back(len);
+            buffers.back().toDense();
+        }
+        return buffers;
+    }
+
+    /**
+     * @brief Массив чисел (матрица Хессенберга и вращения GMRES)
+     *
+     * @param[in] count количество чисел
+     * @return массив не менее чем из count чисел
+     */
+    std::vector<T> &scalars(size_t count)
+    {
+        if (numbers.size() < count)
+            numbers.resize(count);
+        return numbers;
+    }
+
+private:
+    std::vector<Vector<T>> buffers;
+    std::vector<T> numbers;
+};
+
+/**
+ * @brief Число типа T, равное вещественному value
+ *
+ */
+template <typename T>
+T solverScalar(double value)
+{
+    return T(1) * value;
+}
+
+/**
+ * @brief Частное numerator / denominator, вычисленное как numerator * conj(denominator) / |denominator|^2
+ *
+ */
+template <typename T>
+T solverDivide(const T &numerator, const T &denominator)
+{
+    double norm = denominator.abs();
+    return numerator * denominator.conj() * (1 / (norm * norm));
+}
+
+/**
+ * @brief Проверка размеров системы и подготовка начального приближения
+ *
+ * @param[in] matrix матрица
+ * @param[in] b правая часть
+ * @param[in, out] x начальное приближение (при несовпадении длины заменяется нулевым вектором)
+ * @param[in] method название метода для сообщения об ошибке
+ * @throws MatrixShapeError если матрица не квадратная или не согласована с b
+ */
+template <typename M, typename T>
+void prepareSystem(const M &matrix, const Vector<T> &b, Vector<T> &x, const char *method)
+{
+    auto shape = matrix.shape();
+    if (shape.first != shape.second || shape.first != static_cast<uint64_t>(b.getLen()))
+        throw MatrixShapeError("", __FILE__, __LINE__, method, shape, std::make_pair(b.getLen(), 1));
+
+    if (x.getLen() != b.getLen())
+        x = Vector<T>(b.getLen(), x.getEps());
+    x.toDense();
+}
+
+/**
+ * @brief Невязка r = b - A x
+ *
+ * @param[in] matrix матрица
+ * @param[in] b правая часть
+ * @param[in] x приближение
+ * @param[out] r вектор для записи невязки
+ */
+template <typename M, typename T>
+void computeResidual(const M &matrix, const Vector<T> &b, const Vector<T> &x, Vector<T> &r)
+{
+    matrix.multiply(x, r);
+    r.scal(-T(1));
+    r.axpy(T(1), b);
+}
+
+/**
+ * @brief Метод сопряженных градиентов для эрмитовой положительно определенной матрицы
+ *
+ * @param[in] matrix матрица системы
+ * @param[in] b правая часть
+ * @param[in, out] x начальное приближение, по завершении - решение
+ * @param[in] options параметры метода
+ * @param[in] workspace буферы для переиспользования между решениями (по умолчанию - временные)
+ * @return статистика решения
+ * @throws MatrixShapeError если размеры матрицы и правой части не согласованы
+ */
+template <typename M, typename T>
+Solver_stats solveCG(const M &matrix, const Vector<T> &b, Vector<T> &x, const Solver_options &options = Solver_options(),
+                     Solver_workspace<T> *workspace = nullptr)
+{
+    auto start = std::chrono::steady_clock::now();
+    prepareSystem(matrix, b, x, "solveCG");
+    Solver_workspace<T> local;
+    auto &buffers = (workspace ? workspace : &local)->vectors(b.getLen(), 3);
+    Vector<T> &r = buffers[0], &p = buffers[1], &q = buffers[2];
+
+    Solver_stats stats;
+    double b_norm = b.nrm2();
+    if (b_norm == 0)
+        b_norm = 1;
+
+    computeResidual(matrix, b, x, r);
+    stats.products = 1;
+    stats.residual = r.nrm2() / b_norm;
+    p = r;
+    T rho = r.dot(r);
+
+    while (stats.residual > options.tolerance && stats.iterations < options.max_iterations)
+    {
+        matrix.multiply(p, q);
+        ++stats.products;
+        T curvature = p.dot(q);
+        if (curvature.abs() == 0)
+            break;
+
+        T alpha = solverDivide(rho, curvature);
+        x.axpy(alpha, p);
+        r.axpy(-alpha, q);
+        ++stats.iterations;
+
+        T rho_next = r.dot(r);
+        stats.residual = std::sqrt(rho_next.abs()) / b_norm;
+        p.scal(solverDivide(rho_next, rho));
+        p.axpy(T(1), r);
+        rho = rho_next;
+    }
+
+    stats.converged = stats.residual <= options.tolerance;
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
+
+/**
+ * @brief Стабилизированный метод бисопряженных градиентов (BiCGSTAB) для произвольной матрицы
+ *
+ * @param[in] matrix матрица системы
+ * @param[in] b правая часть
+ * @param[in, out] x начальное приближение, по завершении - решение
+ * @param[in] options параметры метода
+ * @param[in] workspace буферы для переиспользования между решениями (по умолчанию - временные)
+ * @return статистика решения (при вырождении метода converged = false)
+ * @throws MatrixShapeError если размеры матрицы и правой части не согласованы
+ */
+template <typename M, typename T>
+Solver_stats solveBiCGSTAB(const M &matrix, const Vector<T> &b, Vector<T> &x, const Solver_options &options = Solver_options(),
+                           Solver_workspace<T> *workspace = nullptr)
+{
+    auto start = std::chrono::steady_clock::now();
+    prepareSystem(matrix, b, x, "solveBiCGSTAB");
+    Solver_workspace<T> local;
+    auto &buffers = (workspace ? workspace : &local)->vectors(b.getLen(), 5);
+    Vector<T> &r = buffers[0], &shadow = buffers[1], &p = buffers[2], &v = buffers[3], &t = buffers[4];
+
+    Solver_stats stats;
+    double b_norm = b.nrm2();
+    if (b_norm == 0)
+        b_norm = 1;
+
+    computeResidual(matrix, b, x, r);
+    stats.products = 1;
+    stats.residual = r.nrm2() / b_norm;
+    shadow = r;
+    p = r;
+    T rho = shadow.dot(r);
+
+    while (stats.residual > options.tolerance && stats.iterations < options.max_iterations)
+    {
+        matrix.multiply(p, v);
+        ++stats.products;
+        T projection = shadow.dot(v);
+        if (projection.abs() == 0)
+            break;
+
+        // r становится промежуточной невязкой s = r - alpha * v
+        T alpha = solverDivide(rho, projection);
+        x.axpy(alpha, p);
+        r.axpy(-alpha, v);
+        ++stats.iterations;
+        stats.residual = r.nrm2() / b_norm;
+        if (stats.residual <= options.tolerance)
+            break;
+
+        matrix.multiply(r, t);
+        ++stats.products;
+        T t_norm = t.dot(t);
+        if (t_norm.abs() == 0)
+            break;
+
+        T omega = solverDivide(t.dot(r), t_norm);
+        x.axpy(omega, r);
+        r.axpy(-omega, t);
+        stats.residual = r.nrm2() / b_norm;
+
+        T rho_next = shadow.dot(r);
+        if (rho_next.abs() == 0 || omega.abs() == 0)
+            break;
+
+        // p = r + beta * (p - omega * v)
+        p.axpy(-omega, v);
+        p.scal(solverDivide(rho_next, rho) * solverDivide(alpha, omega));
+        p.axpy(T(1), r);
+        rho = rho_next;
+    }
+
+    stats.converged = stats.residual <= options.tolerance;
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
+
+/**
+ * @brief Метод обобщенных минимальных невязок с перезапуском GMRES(restart) для произвольной матрицы.
+ * Базис строится модифицированным процессом Грама-Шмидта, матрица Хессенберга приводится
+ * к треугольному виду вращениями Гивенса, поэтому невязка известна на каждой итерации без умножений.
+ *
+ * @param[in] matrix матрица системы
+ * @param[in] b правая часть
+ * @param[in, out] x начальное приближение, по завершении - решение
+ * @param[in] options параметры метода
+ * @param[in] workspace буферы для переиспользования между решениями (по умолчанию - временные)
+ * @return статистика решения
+ * @throws MatrixShapeError если размеры матрицы и правой части не согласованы
+ */
+template <typename M, typename T>
+Solver_stats solveGMRES(const M &matrix, const Vector<T> &b, Vector<T> &x, const Solver_options &options = Solver_options(),
+                        Solver_workspace<T> *workspace = nullptr)
+{
+    auto start = std::chrono::steady_clock::now();
+    prepareSystem(matrix, b, x, "solveGMRES");
+    size_t m = static_cast<size_t>(std::max(1, std::min(options.restart, b.getLen())));
+    Solver_workspace<T> local;
+    Solver_workspace<T> &buffers = workspace ? *workspace : local;
+    // базис V[0..m] и вектор w = A V[j]
+    auto &basis = buffers.vectors(b.getLen(), m + 2);
+    Vector<T> &w = basis[m + 1];
+    // H - (m + 1) x m по столбцам, затем косинусы, синусы, правая часть g и решение y
+    auto &numbers = buffers.scalars((m + 1) * m + 4 * m + 1);
+    T *hessenberg = numbers.data();
+    T *cosines = hessenberg + (m + 1) * m;
+    T *sines = cosines + m;
+    T *g = sines + m;
+    T *y = g + m + 1;
+    auto h = [hessenberg, m](size_t i, size_t j) -> T &
+    { return hessenberg[j * (m + 1) + i]; };
+
+    Solver_stats stats;
+    double b_norm = b.nrm2();
+    if (b_norm == 0)
+        b_norm = 1;
+
+    while (stats.iterations < options.max_iterations)
+    {
+        computeResidual(matrix, b, x, basis[0]);
+        ++stats.products;
+        double beta = basis[0].nrm2();
+        stats.residual = beta / b_norm;
+        if (stats.residual <= options.tolerance || beta == 0)
+            break;
+
+        basis[0].scal(solverScalar<T>(1 / beta));
+        std::fill(g, g + m + 1, T());
+        g[0] = solverScalar<T>(beta);
+
+        size_t k = 0;
+        bool breakdown = false;
+        while (k < m && stats.iterations < options.max_iterations)
+        {
+            size_t j = k++;
+            matrix.multiply(basis[j], w);
+            ++stats.products;
+            for (size_t i = 0; i <= j; ++i)
+            {
+                h(i, j) = basis[i].dot(w);
+                w.axpy(-h(i, j), basis[i]);
+            }
+            double w_norm = w.nrm2();
+            h(j + 1, j) = solverScalar<T>(w_norm);
+            if (w_norm != 0)
+            {
+                basis[j + 1] = w;
+                basis[j + 1].scal(solverScalar<T>(1 / w_norm));
+            }
+
+            for (size_t i = 0; i < j; ++i)
+            {
+                T upper = cosines[i] * h(i, j) + sines[i] * h(i + 1, j);
+                h(i + 1, j) = cosines[i] * h(i + 1, j) - sines[i].conj() * h(i, j);
+                h(i, j) = upper;
+            }
+
+            // вращение [c s; -conj(s) c] обнуляет h(j + 1, j); c вещественный
+            double a_norm = h(j, j).abs();
+            double radius = std::hypot(a_norm, w_norm);
+            if (a_norm == 0)
+            {
+                cosines[j] = T();
+                sines[j] = T(1);
+                h(j, j) = h(j + 1, j);
+            }
+            else
+            {
+                T phase = h(j, j) * solverScalar<T>(1 / a_norm);
+                cosines[j] = solverScalar<T>(a_norm / radius);
+                sines[j] = phase * h(j + 1, j).conj() * solverScalar<T>(1 / radius);
+                h(j, j) = phase * solverScalar<T>(radius);
+            }
+            h(j + 1, j) = T();
+            g[j + 1] = -sines[j].conj() * g[j];
+            g[j] = cosines[j] * g[j];
+
+            ++stats.iterations;
+            stats.residual = g[j + 1].abs() / b_norm;
+            breakdown = w_norm == 0;
+            if (stats.residual <= options.tolerance || breakdown)
+                break;
+        }
+
+        // обратный ход по треугольной матрице H y = g и x += V y
+        for (size_t i = k; i-- > 0;)
+        {
+            T sum = g[i];
+            for (size_t l = i + 1; l < k; ++l)
+                sum -= h(i, l) * y[l];
+            y[i] = solverDivide(sum, h(i, i));
+        }
+        for (size_t i = 0; i < k; ++i)
+            x.axpy(y[i], basis[i]);
+
+        if (stats.residual <= options.tolerance || breakdown)
+            break;
+    }
+
+    stats.converged = stats.residual <= options.tolerance;
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
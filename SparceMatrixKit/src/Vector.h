@@ -2,6 +2,11 @@
 
 #include "Rational.h"
 #include "Matrix.h"
+#include "Blas.h"
+#include "Reader.h"
+#include "Binary.h"
+#include "Writer.h"
+#include "Expression.h"
 
 #include <iostream>
 
@@ -11,6 +16,11 @@
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <chrono>
 
 template <template <class, class...> class Container, class T>
 class Matrix;
@@ -18,18 +28,217 @@ class Matrix;
 /**
  * @brief Шаблонный класс для хранения разреженных векторов
  *
+ * Вектор хранится либо разреженно (словарь индекс -> значение), либо плотно (непрерывный массив длины len).
+ * Разреженный вектор автоматически переводится в плотное хранение, когда доля хранимых элементов
+ * превышает dense_threshold, но только по завершении массовых операций (результат выражения, умножения,
+ * чтения из файла). Доступ к элементам (operator[], set) режим хранения не меняет, поэтому ссылки,
+ * возвращенные operator[], остаются действительными до явного вызова toDense(), toSparse() или
+ * массовой операции над вектором. Обратный перевод выполняется только явно методом toSparse().
+ *
  * @tparam T - тип элементов вектора
  */
 template <typename T>
-class Vector
+class Vector : public Vector_expression<Vector<T>, T>
 {
+    template <template <class, class...> class Container, class U>
+    friend class Matrix;
+    template <template <class, class...> class Container, class U>
+    friend class Matrix_proxy;
+
 protected:
-    std::map<int, T> data; /**< Словарь для хранения элементов вектора */
+    std::map<int, T> data; /**< Словарь для хранения элементов вектора (пуст в плотном режиме) */
+    std::vector<T> values; /**< Плотное хранение: элемент с индексом i лежит в values[i - 1] */
+    bool dense = false;    /**< Признак плотного хранения */
     double eps;            /**< Пороговое значение для признания числа нулевым */
     int len;               /**< Длина вектора */
 
+    /**
+     * @brief Перевод в плотное хранение, если доля хранимых элементов превысила dense_threshold
+     *
+     */
+    void promoteIfFilled()
+    {
+        if (!dense && len > 0 && data.size() > dense_threshold * len)
+            toDense();
+    }
+
+    /**
+     * @brief Ссылка на элемент без проверки индекса (элемент создается при необходимости)
+     *
+     * @param[in] index индекс элемента (1 <= index <= len в плотном режиме)
+     * @return ссылка на элемент
+     */
+    T &element(int index)
+    {
+        if (dense)
+            return values[index - 1];
+        return data[index];
+    }
+
+    /**
+     * @brief Указатель на хранимый элемент
+     *
+     * @param[in] index индекс элемента
+     * @return указатель на элемент или nullptr, если элемент не хранится
+     */
+    const T *stored(int index) const
+    {
+        if (dense)
+            return index >= 1 && index <= len ? &values[index - 1] : nullptr;
+
+        auto it = data.find(index);
+        return it == data.end() ? nullptr : &it->second;
+    }
+
+    /**
+     * @brief Обход хранимых ненулевых элементов по возрастанию индексов
+     *
+     * @param[in] visit функция, принимающая индекс и значение
+     */
+    template <typename Visitor>
+    void forEachStored(Visitor visit) const
+    {
+        if (dense)
+        {
+            for (int i = 1; i < len + 1; ++i)
+                if (values[i - 1].abs() != 0)
+                    visit(i, values[i - 1]);
+        }
+        else
+            for (auto &element : data)
+                visit(element.first, element.second);
+    }
+
+    /**
+     * @brief Подготовка к накоплению результата: задает длину и обнуляет хранимые элементы
+     *
+     * @param[in] new_len новая длина вектора
+     */
+    void resetValues(int new_len)
+    {
+        len = new_len;
+        if (dense)
+            values.assign(len, T());
+        else
+            for (auto &element : data)
+                element.second = T();
+    }
+
+    /**
+     * @brief Завершение накопления результата: удаление элементов меньше eps и проверка плотности
+     *
+     */
+    void compactValues()
+    {
+        if (!dense && eps > 0)
+            std::erase_if(data, [this](const auto &element)
+                          { return element.second.abs() < eps; });
+        promoteIfFilled();
+    }
+
+    /**
+     * @brief Начало записи элементов по возрастанию индексов (см. writeOrdered)
+     *
+     * @param[in] new_len новая длина вектора
+     * @return позиция записи
+     */
+    typename std::map<int, T>::iterator beginOrdered(int new_len)
+    {
+        len = new_len;
+        if (dense)
+            values.assign(len, T());
+        return data.begin();
+    }
+
+    /**
+     * @brief Запись элемента; индексы должны возрастать. В разреженном режиме существующие узлы
+     * переиспользуются, а пропущенные элементы удаляются.
+     *
+     * @param[in, out] out позиция записи
+     * @param[in] index индекс элемента
+     * @param[in] value значение
+     */
+    void writeOrdered(typename std::map<int, T>::iterator &out, int index, const T &value)
+    {
+        if (dense)
+        {
+            if (value.abs() >= eps)
+                values[index - 1] = value;
+            return;
+        }
+
+        while (out != data.end() && out->first < index)
+            out = data.erase(out);
+
+        bool is_stored = out != data.end() && out->first == index;
+        if (value.abs() < eps)
+        {
+            if (is_stored)
+                out = data.erase(out);
+        }
+        else if (is_stored)
+        {
+            out->second = value;
+            ++out;
+        }
+        else
+            data.emplace_hint(out, index, value);
+    }
+
+    /**
+     * @brief Завершение записи элементов по возрастанию индексов
+     *
+     * @param[in] out позиция записи
+     */
+    void endOrdered(typename std::map<int, T>::iterator out)
+    {
+        if (!dense)
+            data.erase(out, data.end());
+        promoteIfFilled();
+    }
+
+    /**
+     * @brief Вычисление отложенного выражения за один проход с записью в этот вектор.
+     * Вектор становится плотным, если плотный он сам или один из операндов; eps сохраняется.
+     *
+     * @param[in] expression выражение
+     */
+    template <typename Expression>
+    void evaluate(const Expression &expression)
+    {
+        bool to_dense = dense || expression.isDense();
+        Vector_accumulator<T> accumulator(expression.getLen(), to_dense);
+        expression.accumulate(accumulator, T(1));
+
+        if (accumulator.isDense() && to_dense)
+        {
+            data.clear();
+            values = std::move(accumulator.getValues());
+            if (eps > 0)
+                for (auto &value : values)
+                    if (value.abs() < eps)
+                        value = T();
+            len = accumulator.getLen();
+            dense = true;
+            return;
+        }
+
+        auto out = beginOrdered(accumulator.getLen());
+        accumulator.forEach([this, &out](int index, const T &value)
+                            {
+            if (value.abs() != 0)
+                writeOrdered(out, index, value); });
+        endOrdered(out);
+    }
+
 public:
-    Vector() {}
+    /**
+     * @brief Доля хранимых элементов, при превышении которой разреженный вектор становится плотным.
+     * Значение больше 1 отключает автоматический переход.
+     */
+    static inline double dense_threshold = 0.5;
+
+    Vector() : eps(0), len(0) {}
 
     /**
      * Конструктор класса Vector.
@@ -38,6 +247,31 @@ public:
      */
     Vector(int len, double epsilon = 0) : eps(epsilon), len(len) {}
 
+    /**
+     * @brief Конструктор из отложенного выражения (вычисляется за один проход)
+     *
+     * @param[in] expression выражение, например A * x + y
+     */
+    template <typename Expression>
+    Vector(const Vector_expression<Expression, T> &expression) : eps(0), len(0)
+    {
+        evaluate(expression.self());
+    }
+
+    /**
+     * @brief Присваивание отложенного выражения (вычисляется за один проход, eps сохраняется).
+     * Выражение может ссылаться на этот же вектор: он перезаписывается после вычисления.
+     *
+     * @param[in] expression выражение
+     * @return ссылка на этот вектор
+     */
+    template <typename Expression>
+    Vector &operator=(const Vector_expression<Expression, T> &expression)
+    {
+        evaluate(expression.self());
+        return *this;
+    }
+
     /**
      * Получение значения элемента вектора по заданным индексам.
      * Если элемент не найден, возвращается нулевое значение типа T.
@@ -46,6 +280,14 @@ public:
      */
     const T &at(int index) const
     {
+        if (dense)
+        {
+            if (index >= 1 && index <= len)
+                return values[index - 1];
+            static const T zero;
+            return zero;
+        }
+
         auto it = data.find(index);
         if (it == data.end())
         {
@@ -60,14 +302,213 @@ public:
 
     /**
      * Установка значения элемента вектора по заданному индексу.
-     * Если значение меньше epsilon, элемент не добавляется в словарь.
+     * Если значение меньше epsilon, элемент не добавляется в словарь. Режим хранения не меняется.
      * @param row Индекс элемента.
      * @param value Значение элемента вектора.
+     * @throws std::logic_error если индекс вне 1..len
      */
     void set(int index, const T &value)
     {
-        if (value.abs() >= eps)
-            data[index] = value;
+        if (index < 1 || index > len)
+            throw std::logic_error("Out of range");
+
+        if (!(value.abs() >= eps))
+            return;
+
+        element(index) = value;
+    }
+
+    /**
+     * @brief Проверка плотного режима хранения
+     *
+     * @return true, если элементы хранятся в непрерывном массиве
+     */
+    bool isDense() const
+    {
+        return dense;
+    }
+
+    /**
+     * @brief Перевод вектора в плотное хранение
+     *
+     */
+    void toDense()
+    {
+        if (dense)
+            return;
+
+        if (!data.empty() && (data.begin()->first < 1 || data.rbegin()->first > len))
+            throw std::logic_error("Out of range");
+
+        values.assign(len, T());
+        for (auto &element : data)
+            values[element.first - 1] = element.second;
+        data.clear();
+        dense = true;
+    }
+
+    /**
+     * @brief Перевод вектора в разреженное хранение (нулевые элементы и элементы меньше eps не хранятся)
+     *
+     */
+    void toSparse()
+    {
+        if (!dense)
+            return;
+
+        data.clear();
+        for (int i = 1; i < len + 1; ++i)
+            if (values[i - 1].abs() != 0 && values[i - 1].abs() >= eps)
+                data.emplace_hint(data.end(), i, values[i - 1]);
+        values.clear();
+        values.shrink_to_fit();
+        dense = false;
+    }
+
+    /**
+     * @brief Скалярное произведение (this, other) = sum(conj(this[i]) * other[i]).
+     * Для разреженных векторов перебираются только хранимые элементы.
+     *
+     * @param[in] other вектор
+     * @return скалярное произведение
+     */
+    T dot(const Vector<T> &other) const
+    {
+        if (len != other.getLen())
+            throw std::logic_error("Cannot multiply vectors of different sizes");
+
+        if (dense && other.dense)
+            return denseDot(values.data(), other.values.data(), len);
+
+        T sum = T();
+        if (!dense && !other.dense)
+        {
+            auto it = data.begin();
+            auto jt = other.data.begin();
+            while (it != data.end() && jt != other.data.end())
+            {
+                if (it->first < jt->first)
+                    ++it;
+                else if (jt->first < it->first)
+                    ++jt;
+                else
+                {
+                    sum += it->second.conj() * jt->second;
+                    ++it;
+                    ++jt;
+                }
+            }
+        }
+        else if (!dense)
+        {
+            for (auto &element : data)
+                if (element.first >= 1 && element.first <= len)
+                    sum += element.second.conj() * other.values[element.first - 1];
+        }
+        else
+        {
+            for (auto &element : other.data)
+                if (element.first >= 1 && element.first <= len)
+                    sum += values[element.first - 1].conj() * element.second;
+        }
+        return sum;
+    }
+
+    /**
+     * @brief Евклидова норма вектора
+     *
+     * @return sqrt(sum(|this[i]|^2))
+     */
+    double nrm2() const
+    {
+        if (dense)
+            return std::sqrt(denseSquaredNorm(values.data(), len));
+
+        double sum = 0;
+        for (auto &element : data)
+        {
+            double value = element.second.abs();
+            sum += value * value;
+        }
+        return std::sqrt(sum);
+    }
+
+    /**
+     * @brief this += alpha * other без создания нового вектора.
+     * Если other хранится плотно, this переводится в плотное хранение.
+     *
+     * @param[in] alpha множитель
+     * @param[in] other прибавляемый вектор
+     */
+    void axpy(const T &alpha, const Vector<T> &other)
+    {
+        if (len != other.getLen())
+            throw std::logic_error("Cannot add vectors of different sizes");
+
+        if (&other == this)
+        {
+            scal(alpha + T(1));
+            return;
+        }
+
+        if (other.dense)
+        {
+            toDense();
+            denseAxpy(alpha, other.values.data(), values.data(), len);
+            return;
+        }
+
+        if (dense)
+        {
+            for (auto &element : other.data)
+                if (element.first >= 1 && element.first <= len)
+                    values[element.first - 1] += alpha * element.second;
+            return;
+        }
+
+        auto it = data.begin();
+        for (auto &element : other.data)
+        {
+            while (it != data.end() && it->first < element.first)
+                ++it;
+
+            if (it != data.end() && it->first == element.first)
+                it->second += alpha * element.second;
+            else
+                it = data.emplace_hint(it, element.first, alpha * element.second);
+            ++it;
+        }
+        compactValues();
+    }
+
+    /**
+     * @brief Прибавление alpha * this к накопителю отложенного выражения
+     *
+     * @param[in, out] result накопитель
+     * @param[in] alpha множитель
+     */
+    void accumulate(Vector_accumulator<T> &result, const T &alpha) const
+    {
+        forEachStored([&result, &alpha](int index, const T &value)
+                      { result.add(index, alpha * value); });
+    }
+
+    /**
+     * @brief this *= alpha без создания нового вектора
+     *
+     * @param[in] alpha множитель
+     */
+    void scal(const T &alpha)
+    {
+        if (dense)
+        {
+            denseScal(alpha, values.data(), len);
+            return;
+        }
+
+        for (auto &element : data)
+            element.second *= alpha;
+        compactValues();
     }
 
     /**
@@ -91,15 +532,25 @@ public:
     }
 
     /**
-     * @brief Возвращает словарь, где храняться числа вектора
+     * @brief Возвращает словарь, где храняться числа вектора (в плотном режиме словарь пуст)
      *
-     * @return const std::map<int, T>
+     * @return const std::map<int, T>&
      */
-    const std::map<int, T> getData() const
+    const std::map<int, T> &getData() const
     {
         return data;
     }
 
+    /**
+     * @brief Возвращает массив плотного хранения (в разреженном режиме массив пуст)
+     *
+     * @return const std::vector<T>&
+     */
+    const std::vector<T> &getValues() const
+    {
+        return values;
+    }
+
     /**
      * Возвращает строковое представление вектора.
      * @return Строковое представление вектора.
@@ -130,23 +581,14 @@ public:
     }
 
     /**
-     * Перегрузка оператора сложения для векторов с проверкой совпадения размеров и возможности приведения типов чисел.
-     * @tparam OtherT Тип чисел во втором векторе.
+     * Перегрузка оператора сложения для векторов с проверкой совпадения размеров.
+     * Сумма вычисляется отложенно, при присваивании вектору (см. Expression.h).
      * @param other Вектор для сложения.
-     * @return Новый вектор, являющаяся результатом сложения.
+     * @return Выражение - сумма векторов.
      */
-    Vector<T> operator+(const Vector<T> &other) const
+    Vector_sum<Vector<T>, Vector<T>, T> operator+(const Vector<T> &other) const
     {
-        if (len != other.getLen())
-            throw std::logic_error("Cannot add vectors of different sizes");
-
-        Vector<T> result(len);
-        for (int i = 1; i < len + 1; ++i)
-        {
-            T value = at(i) + other.at(i);
-            result.set(i, value);
-        }
-        return result;
+        return Vector_sum<Vector<T>, Vector<T>, T>(*this, other, false);
     }
 
     /**
@@ -172,6 +614,17 @@ public:
         return result;
     }
 
+    /**
+     * Перегрузка оператора вычитания для векторов с проверкой совпадения размеров.
+     * Разность вычисляется отложенно, при присваивании вектору (см. Expression.h).
+     * @param other Вычитаемый вектор.
+     * @return Выражение - разность векторов.
+     */
+    Vector_sum<Vector<T>, Vector<T>, T> operator-(const Vector<T> &other) const
+    {
+        return Vector_sum<Vector<T>, Vector<T>, T>(*this, other, true);
+    }
+
     /**
      * Перегрузка оператора вычитания для векторов с проверкой совпадения размеров и возможности приведения типов чисел.
      * @tparam OtherT Тип чисел во втором векторе.
@@ -186,6 +639,8 @@ public:
 
         static_assert(std::is_convertible<OtherT, T>::value, "Invalid type conversion");
         Vector<T> result(len);
+        if (dense || other.isDense())
+            result.toDense();
         for (int i = 1; i < len + 1; ++i)
         {
             T value = at(i) - static_cast<T>(other.at(i));
@@ -216,6 +671,17 @@ public:
         return result;
     }
 
+    /**
+     * Перегрузка оператора умножения вектора на число того же типа.
+     * Произведение вычисляется отложенно, при присваивании вектору (см. Expression.h).
+     * @param other Множитель.
+     * @return Выражение - произведение вектора на число.
+     */
+    Vector_scaled<Vector<T>, T> operator*(const T &other) const
+    {
+        return Vector_scaled<Vector<T>, T>(*this, other);
+    }
+
     /**
      * Перегрузка оператора умножения вектора на число(не комплексное) с проверкой совпадения размеров и возможности приведения типов чисел.
      * @tparam OtherT Тип чисел во втором векторе.
@@ -226,6 +692,8 @@ public:
     Vector<T> operator*(const OtherT &other) const
     {
         Vector<T> result(len);
+        if (dense)
+            result.toDense();
         for (int i = 1; i < len + 1; ++i)
         {
             T value = at(i) * other;
@@ -264,6 +732,8 @@ public:
     Vector<T> operator/(const OtherT &other) const
     {
         Vector<T> result(len);
+        if (dense)
+            result.toDense();
         for (int i = 1; i < len + 1; ++i)
         {
             T value = at(i) / other;
@@ -295,40 +765,30 @@ public:
      * @brief Перегрузка оператора [], позволяет получать доступ к элементу вектора по индексу
      *
      * @param index индекс элемента
-     * @return ссылка на элемент
+     * @return ссылка на элемент (режим хранения не меняется, поэтому ранее полученные ссылки остаются действительными)
      */
     T &operator[](int index)
     {
         if (index < 1 || index > len)
             throw std::logic_error("Out of range");
-        return data[index];
+
+        return element(index);
     }
 
     /**
-     * @brief Перегрузка оператора умножения вектора на матрицу
+     * @brief Перегрузка оператора умножения вектора на матрицу.
+     * Вычисляется как other^T * (*this) по ненулевым элементам, без транспонирования матрицы.
      *
      * @param[in] other Матрица
      * @return Вектор, являющийся результатом умножения вектора на матрицу
      */
-    template <template <class, class...> class Container, class U>
-    Vector<T> operator*(const Matrix<Container, U> &other)
+    template <template <class, class...> class Container>
+    Vector<T> operator*(const Matrix<Container, T> &other) const
     {
-        if (len != other.shape().first)
+        if (static_cast<uint64_t>(len) != other.shape().first)
             throw MatrixShapeError("", __FILE__, __LINE__, "operator * vector", std::make_pair(len, 1), other.shape());
 
-        Vector<T> result(other.shape().second);
-
-        for (int j = 1; j < other.shape().second + 1; ++j)
-        {
-            T sum = T();
-            for (int k = 1; k < len + 1; ++k)
-            {
-                sum += at(k) * other.at(k, j);
-            }
-            result.set(j, sum);
-        }
-
-        return result;
+        return other.multiplyTransposed(*this);
     }
 
     /**
@@ -340,96 +800,180 @@ public:
      */
     bool operator==(const Vector<T> &other) const
     {
-        return data == other.getData() && eps == other.getEps() && len == other.getLen();
+        if (eps != other.getEps() || len != other.getLen())
+            return false;
+        if (!dense && !other.isDense())
+            return data == other.getData();
+
+        for (int i = 1; i < len + 1; ++i)
+            if (!(at(i) == other.at(i)))
+                return false;
+        return true;
     }
 
     /**
-     * @brief Метод для чтения матрицы с файла
+     * @brief Метод для чтения вектора с файла
      *
-     * @param[in] file файловый поток
-     * @return Прочитанная матрица
+     * Файл отображается в память и разбирается без выделения памяти на каждую строку.
+     *
+     * @param[in] filename имя файла
+     * @param[out] stats статистика чтения (размер, количество элементов, время), если не nullptr
+     * @return Прочитанный вектор
      */
-    static Vector<T> readFromFile(std::string &filename)
+    static Vector<T> readFromFile(std::string &filename, Read_stats *stats = nullptr)
     {
-        std::ifstream file(filename);
+        auto start = std::chrono::steady_clock::now();
+        Mapped_file file(filename);
         if (!file.is_open())
             throw VectorReadFromFileError("", __FILE__, __LINE__);
 
-        std::string line, _T1, _T2;
-        uint64_t len;
-        std::vector<std::string> params;
-        while (std::getline(file, line))
-        {
-            if (line.empty() || startsWithHash(line))
-                continue;
+        Line_scanner scanner(file.data(), file.data() + file.size());
+        std::string_view line;
+        std::string _T1, _T2;
+        uint64_t len = 0;
+        if (!scanner.next(line))
+            throw VectorReadFromFileError("File not contains vector.", __FILE__, __LINE__);
 
-            std::istringstream iss(line);
-            params = std::vector<std::string>(std::istream_iterator<std::string>{iss}, std::istream_iterator<std::string>());
+        std::istringstream iss{std::string(line)};
+        std::vector<std::string> params(std::istream_iterator<std::string>{iss}, std::istream_iterator<std::string>());
 
-            if (params[0] != "vector")
-                throw VectorReadFromFileError("File not contains vector.", __FILE__, __LINE__);
+        if (params.empty() || params[0] != "vector")
+            throw VectorReadFromFileError("File not contains vector.", __FILE__, __LINE__);
 
-            if (T::type() != params[1])
-                throw MatrixReadFromFileError("Incorrect type of input vector.", __FILE__, __LINE__);
+        if (params.size() < 2)
+            throw VectorReadFromFileError("Incorrect type of input vector.", __FILE__, __LINE__);
 
-            if (params[1] == "rational")
-            {
-                if (params.size() != 3)
-                    throw MatrixReadFromFileError("To many params. Expected 3. But given " + std::to_string(params.size()), __FILE__, __LINE__);
+        if (T::type() != params[1])
+            throw MatrixReadFromFileError("Incorrect type of input vector.", __FILE__, __LINE__);
 
-                len = std::stoll(params[2]);
-            }
-            else if (params[1] == "complex")
-            {
-                if (params.size() != 5)
-                    throw MatrixReadFromFileError("To many params. Expected 5. But given " + std::to_string(params.size()), __FILE__, __LINE__);
+        if (params[1] == "rational")
+        {
+            if (params.size() != 3)
+                throw MatrixReadFromFileError("To many params. Expected 3. But given " + std::to_string(params.size()), __FILE__, __LINE__);
 
-                std::map<std::string, std::string> in_types;
-                in_types["a"] = "integer";
-                in_types["s"] = "integer";
-                in_types["i"] = "integer";
-                in_types["l"] = "integer";
-                in_types["f"] = "float";
-                in_types["d"] = "float";
+            len = parseHeaderSize<VectorReadFromFileError>(params[2], std::numeric_limits<int>::max());
+        }
+        else if (params[1] == "complex")
+        {
+            if (params.size() != 5)
+                throw MatrixReadFromFileError("To many params. Expected 5. But given " + std::to_string(params.size()), __FILE__, __LINE__);
 
-                _T1 = T::getTypeNames().first;
-                _T2 = T::getTypeNames().second;
+            std::map<std::string, std::string> in_types;
+            in_types["a"] = "integer";
+            in_types["s"] = "integer";
+            in_types["i"] = "integer";
+            in_types["l"] = "integer";
+            in_types["f"] = "float";
+            in_types["d"] = "float";
 
-                if (params[2] != in_types[_T1] || params[3] != in_types[_T2])
-                    throw MatrixReadFromFileError("Incorrect complex im and real field types. ", __FILE__, __LINE__);
+            _T1 = T::getTypeNames().first;
+            _T2 = T::getTypeNames().second;
 
-                len = std::stoll(params[4]);
-            }
-            break;
+            if (params[2] != in_types[_T1] || params[3] != in_types[_T2])
+                throw MatrixReadFromFileError("Incorrect complex im and real field types. ", __FILE__, __LINE__);
+
+            len = parseHeaderSize<VectorReadFromFileError>(params[4], std::numeric_limits<int>::max());
         }
 
         auto new_vector = Vector<T>(len);
 
-        uint64_t idx;
-        while (std::getline(file, line))
+        uint64_t entries;
+        if (!readEntries<T, 1>(scanner, [&](const uint64_t *idx, const T &value)
+                               {
+                                   if (idx[0] < 1 || idx[0] > len)
+                                       throw VectorReadFromFileError("Incorrect element index.", __FILE__, __LINE__);
+                                   new_vector.set(idx[0], value); },
+                               entries))
+            throw VectorReadFromFileError("Incorrect vector element line.", __FILE__, __LINE__);
+        new_vector.promoteIfFilled();
+
+        if (stats != nullptr)
+            *stats = Read_stats{file.size(), entries, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+        return new_vector;
+    }
+
+    /**
+     * @brief Запись вектора в двоичный файл (заголовок, возрастающие индексы и значения)
+     *
+     * @param[in] filename имя файла
+     * @throws VectorWriteToFileError если запись не удалась
+     */
+    void writeToBinaryFile(std::string &filename) const
+    {
+        std::vector<uint64_t> indices;
+        std::vector<T> stored;
+        forEachStored([&](int index, const T &value)
+                      {
+                          indices.push_back(index);
+                          stored.push_back(value); });
+
+        Binary_header header = makeBinaryHeader<T>(1, len, 1, eps, stored.size());
+        if (!writeBinaryFile(filename, header, {{indices.data(), indices.size() * sizeof(uint64_t)}, {stored.data(), stored.size() * sizeof(T)}}))
+            throw VectorWriteToFileError("", __FILE__, __LINE__);
+    }
+
+    /**
+     * @brief Чтение вектора из отображенного в память двоичного файла без разбора текста
+     *
+     * @param[in] filename имя файла, записанного writeToBinaryFile
+     * @return Прочитанный вектор
+     * @throws VectorReadFromFileError если файл не содержит вектор типа T
+     */
+    static Vector<T> readFromBinaryFile(std::string &filename)
+    {
+        Mapped_file file(filename);
+        if (!file.is_open())
+            throw VectorReadFromFileError("", __FILE__, __LINE__);
+
+        const Binary_header *header = checkBinaryFile<T>(file, 1);
+        if (header == nullptr)
+            throw VectorReadFromFileError("File not contains binary vector of this type.", __FILE__, __LINE__);
+
+        const uint64_t *indices = reinterpret_cast<const uint64_t *>(file.data() + sizeof(Binary_header));
+        const T *stored = reinterpret_cast<const T *>(indices + header->non_zeros);
+
+        Vector<T> result(static_cast<int>(header->rows), header->eps);
+        auto out = result.beginOrdered(result.len);
+        for (uint64_t k = 0; k < header->non_zeros; ++k)
         {
-            if (line.empty() || startsWithHash(line))
-                continue;
+            if (indices[k] < 1 || indices[k] > header->rows || (k > 0 && indices[k] <= indices[k - 1]))
+                throw VectorReadFromFileError("Incorrect element index.", __FILE__, __LINE__);
+            result.writeOrdered(out, static_cast<int>(indices[k]), stored[k]);
+        }
+        result.endOrdered(out);
+        return result;
+    }
 
-            std::istringstream iss(line);
-            iss >> idx;
-            if (params[1] == "complex")
-            {
-                auto left = line.find('(');
-                auto right = line.find(')');
-                auto valueString = line.substr(left + 1, right - left - 1);
-                auto value = T(valueString.c_str());
-                new_vector.set(idx, value);
-            }
-            else if (params[1] == "rational")
-            {
-                auto left = line.find('<');
-                auto right = line.find('>');
-                auto valueString = line.substr(left + 1, right - left - 1);
-                auto value = T(valueString.c_str());
-                new_vector.set(idx, value);
-            }
+    /**
+     * @brief Потоковая запись вектора в текстовом формате readFromFile: записываются только хранимые
+     * элементы, текст формируется в буфере фиксированного размера (время O(nnz), память O(1))
+     *
+     * @param[in, out] out поток вывода
+     * @throws VectorWriteToFileError если запись в поток не удалась
+     */
+    void writeToFile(std::ostream &out) const
+    {
+        {
+            Text_writer writer(out);
+            writeHeader<T>(writer, "vector", {static_cast<uint64_t>(len)});
+            forEachStored([&](int index, const T &value)
+                          { writeEntry(writer, {static_cast<uint64_t>(index)}, value); });
         }
-        return new_vector;
+        if (!out)
+            throw VectorWriteToFileError("", __FILE__, __LINE__);
+    }
+
+    /**
+     * @brief Запись вектора в текстовый файл (см. writeToFile(std::ostream &))
+     *
+     * @param[in] filename имя файла
+     * @throws VectorWriteToFileError если файл не открывается или запись не удалась
+     */
+    void writeToFile(std::string &filename) const
+    {
+        std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+            throw VectorWriteToFileError("", __FILE__, __LINE__);
+        writeToFile(file);
     }
 };
\ No newline at end of file
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <iostream>
+#include "stdint.h"
+#include <string>
+#include <cstring>
+#include <charconv>
+#include <vector>
+#include <initializer_list>
+
+/**
+ * @brief Буферизованная запись текста в поток
+ *
+ * Текст собирается в буфере фиксированного размера и передается потоку блоками,
+ * поэтому расход памяти не зависит от объема записываемых данных.
+ */
+class Text_writer
+{
+public:
+    /**
+     * @brief Конструктор
+     *
+     * @param[in] out поток вывода
+     */
+    explicit Text_writer(std::ostream &out) : out(out), used(0), buffer(capacity) {}
+
+    Text_writer(const Text_writer &) = delete;
+    Text_writer &operator=(const Text_writer &) = delete;
+
+    /**
+     * @brief Деструктор, записывающий остаток буфера
+     *
+     */
+    ~Text_writer()
+    {
+        flush();
+    }
+
+    /**
+     * @brief Добавление строки
+     *
+     * @param[in] text строка
+     * @param[in] length длина строки
+     */
+    void append(const char *text, size_t length)
+    {
+        if (length > capacity - used)
+        {
+            flush();
+            if (length > capacity)
+            {
+                out.write(text, static_cast<std::streamsize>(length));
+                return;
+            }
+        }
+        std::memcpy(buffer.data() + used, text, length);
+        used += length;
+    }
+
+    /**
+     * @brief Добавление c-строки
+     *
+     * @param[in] text строка
+     */
+    void append(const char *text)
+    {
+        append(text, std::strlen(text));
+    }
+
+    /**
+     * @brief Добавление строки
+     *
+     * @param[in] text строка
+     */
+    void append(const std::string &text)
+    {
+        append(text.data(), text.size());
+    }
+
+    /**
+     * @brief Добавление символа
+     *
+     * @param[in] symbol символ
+     */
+    void append(char symbol)
+    {
+        if (used == capacity)
+            flush();
+        buffer[used++] = symbol;
+    }
+
+    /**
+     * @brief Добавление числа в десятичной записи (для чисел с плавающей точкой - кратчайшая
+     * запись, читаемая обратно без потерь)
+     *
+     * @tparam N арифметический тип
+     * @param[in] value число
+     */
+    template <typename N>
+    void appendNumber(N value)
+    {
+        if (capacity - used < max_number)
+            flush();
+        auto result = std::to_chars(buffer.data() + used, buffer.data() + capacity, value);
+        used = result.ptr - buffer.data();
+    }
+
+    /**
+     * @brief Передача буфера потоку
+     *
+     */
+    void flush()
+    {
+        if (used > 0)
+            out.write(buffer.data(), static_cast<std::streamsize>(used));
+        used = 0;
+    }
+
+private:
+    static constexpr size_t capacity = 1 << 16;  /**< Размер буфера */
+    static constexpr size_t max_number = 32;     /**< Наибольшая длина записи числа */
+
+    std::ostream &out;
+    size_t used;
+    std::vector<char> buffer;
+};
+
+/**
+ * @brief Название типа поля комплексного числа в заголовке файла
+ *
+ * @param[in] type_name имя типа (typeid(T).name())
+ * @return "integer" или "float"
+ */
+inline const char *fieldTypeName(const std::string &type_name)
+{
+    return type_name == "f" || type_name == "d" ? "float" : "integer";
+}
+
+/**
+ * @brief Запись заголовка файла: 'kind rational size...' или 'kind complex T1 T2 size...'
+ *
+ * Если задано значение fill, оно дописывается в конец заголовка в том же виде, что и значения элементов
+ * ('<value>' или '(value)').
+ *
+ * @tparam T тип элементов
+ * @param[in, out] writer буферизованный поток
+ * @param[in] kind "matrix" или "vector"
+ * @param[in] sizes размеры (строки и столбцы матрицы или длина вектора)
+ * @param[in] fill значение неуказанных элементов, если не nullptr
+ */
+template <typename T>
+void writeHeader(Text_writer &writer, const char *kind, std::initializer_list<uint64_t> sizes, const T *fill = nullptr)
+{
+    writer.append(kind);
+    writer.append(' ');
+    writer.append(T::type());
+    if (std::strcmp(T::type(), "complex") == 0)
+    {
+        writer.append(' ');
+        writer.append(fieldTypeName(T::getTypeNames().first));
+        writer.append(' ');
+        writer.append(fieldTypeName(T::getTypeNames().second));
+    }
+    for (uint64_t size : sizes)
+    {
+        writer.append(' ');
+        writer.appendNumber(size);
+    }
+    if (fill != nullptr)
+    {
+        bool complex = std::strcmp(T::type(), "complex") == 0;
+        writer.append(complex ? " (" : " <");
+        fill->writeTo(writer);
+        writer.append(complex ? ')' : '>');
+    }
+    writer.append('\n');
+}
+
+/**
+ * @brief Запись строки элемента 'i_1 ... i_N <value>' или 'i_1 ... i_N (value)'
+ *
+ * @tparam T тип элемента (должен иметь метод writeTo(Text_writer &))
+ * @param[in, out] writer буферизованный поток
+ * @param[in] indices индексы элемента
+ * @param[in] value значение
+ */
+template <typename T>
+void writeEntry(Text_writer &writer, std::initializer_list<uint64_t> indices, const T &value)
+{
+    for (uint64_t index : indices)
+    {
+        writer.appendNumber(index);
+        writer.append(' ');
+    }
+    bool complex = std::strcmp(T::type(), "complex") == 0;
+    writer.append(complex ? '(' : '<');
+    value.writeTo(writer);
+    writer.append(complex ? ")\n" : ">\n");
+}